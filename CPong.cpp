@@ -2,12 +2,21 @@
 // Windows, macOS, Linux
 
 #include "CPong.h"
+#include "src/CpuUsage.h"
+#include "src/FrameLimiter.h"
 #include "src/Game.h"
+#include "src/Profiler.h"
+#include "src/ProgramCache.h"
 #include <GLFW/glfw3.h>
 #include <glad/glad.h>
+#include <chrono>
 #include <iostream>
+#include <memory>
 #include <string>
+#include <cstdint>
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <ctime>
 
 static void framebufferSizeCallback(GLFWwindow* window, int width, int height) {
@@ -16,8 +25,183 @@ static void framebufferSizeCallback(GLFWwindow* window, int width, int height) {
     if (game) game->resize(width, height);
 }
 
-int main() {
-    std::srand(static_cast<unsigned>(std::time(nullptr)));
+static void keyCallback(GLFWwindow* window, int key, int /*scancode*/, int action, int /*mods*/) {
+    Game* game = static_cast<Game*>(glfwGetWindowUserPointer(window));
+    if (game) game->onKey(key, action);
+}
+
+// Minimising or leaving the window pauses a local match; P resumes it
+static void focusCallback(GLFWwindow* window, int focused) {
+    Game* game = static_cast<Game*>(glfwGetWindowUserPointer(window));
+    if (game && !focused) game->setPaused(true);
+}
+
+static void iconifyCallback(GLFWwindow* window, int iconified) {
+    Game* game = static_cast<Game*>(glfwGetWindowUserPointer(window));
+    if (game && iconified) game->setPaused(true);
+}
+
+// The window system lost the contents (e.g. uncovered): draw again even if idle
+static void refreshCallback(GLFWwindow* window) {
+    Game* game = static_cast<Game*>(glfwGetWindowUserPointer(window));
+    if (game) game->requestRedraw();
+}
+
+static void printCpuUsage(const CpuUsage& cpu) {
+    const CpuUsage::Totals& active = cpu.totals(CpuUsage::Active);
+    const CpuUsage::Totals& idle = cpu.totals(CpuUsage::Idle);
+    std::printf("cpu: active %.3f s/s over %.1f s, idle %.3f s/s over %.1f s\n", active.cores(), active.wallSeconds,
+                idle.cores(), idle.wallSeconds);
+    std::fflush(stdout);
+}
+
+static bool splitHostPort(const std::string& text, std::string& host, std::uint16_t& port) {
+    std::size_t colon = text.rfind(':');
+    if (colon == std::string::npos || colon == 0) return false;
+    host = text.substr(0, colon);
+    port = static_cast<std::uint16_t>(std::atoi(text.c_str() + colon + 1));
+    return port != 0;
+}
+
+// Predefined tables step through their compile-time specialised sim::step
+static bool parseTable(const char* name, sim::MatchConfig& config) {
+    if (std::strcmp(name, "classic") == 0) config = sim::ClassicConfig;
+    else if (std::strcmp(name, "wide") == 0) config = sim::WideConfig;
+    else if (std::strcmp(name, "mini") == 0) config = sim::MiniConfig;
+    else return false;
+    return true;
+}
+
+// Milliseconds from `since` to now; `since` moves to now for the next phase
+static double lap(std::chrono::steady_clock::time_point& since) {
+    auto now = std::chrono::steady_clock::now();
+    double ms = std::chrono::duration<double, std::milli>(now - since).count();
+    since = now;
+    return ms;
+}
+
+int main(int argc, char** argv) {
+    const auto processStart = std::chrono::steady_clock::now();
+    std::uint64_t seed = static_cast<std::uint64_t>(std::time(nullptr));
+    const char* recordPath = nullptr;
+    const char* telemetryPath = nullptr;
+    const char* profilePrefix = nullptr;
+    bool overlay = false;
+    double simRate = 120.0;
+    bool vsync = true;
+    double fpsLimit = -1.0;  // with vsync off: the monitor's refresh rate
+    bool lateLatch = true;
+    int hostPort = -1;
+    std::string connectTo;
+    std::string spectateFrom;
+    sim::NetSession::Conditions link;
+    std::size_t balls = 0;
+    sim::MatchConfig table = sim::ClassicConfig;
+    unsigned ballThreads = 1;
+    std::string shaderCacheDir = ProgramCache::defaultDirectory();
+    bool startupTimes = false;
+    bool autoPause = true;
+    bool cpuReport = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--telemetry") == 0 && i + 1 < argc) {
+            telemetryPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--profile") == 0 && i + 1 < argc) {
+            profilePrefix = argv[++i];
+        } else if (std::strcmp(argv[i], "--overlay") == 0) {
+            overlay = true;
+        } else if (std::strcmp(argv[i], "--sim-rate") == 0 && i + 1 < argc) {
+            simRate = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--no-vsync") == 0) {
+            vsync = false;
+        } else if (std::strcmp(argv[i], "--fps-limit") == 0 && i + 1 < argc) {
+            fpsLimit = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--no-late-latch") == 0) {
+            lateLatch = false;
+        } else if (std::strcmp(argv[i], "--host") == 0 && i + 1 < argc) {
+            hostPort = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--connect") == 0 && i + 1 < argc) {
+            connectTo = argv[++i];
+        } else if (std::strcmp(argv[i], "--spectate") == 0 && i + 1 < argc) {
+            spectateFrom = argv[++i];
+        } else if (std::strcmp(argv[i], "--net-latency") == 0 && i + 1 < argc) {
+            link.latencyMs = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--net-jitter") == 0 && i + 1 < argc) {
+            link.jitterMs = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--net-loss") == 0 && i + 1 < argc) {
+            link.loss = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--table") == 0 && i + 1 < argc && parseTable(argv[i + 1], table)) {
+            ++i;
+        } else if (std::strcmp(argv[i], "--balls") == 0 && i + 1 < argc) {
+            balls = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--ball-threads") == 0 && i + 1 < argc) {
+            ballThreads = static_cast<unsigned>(std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--shader-cache") == 0 && i + 1 < argc) {
+            shaderCacheDir = argv[++i];
+        } else if (std::strcmp(argv[i], "--no-shader-cache") == 0) {
+            shaderCacheDir.clear();
+        } else if (std::strcmp(argv[i], "--startup-times") == 0) {
+            startupTimes = true;
+        } else if (std::strcmp(argv[i], "--no-auto-pause") == 0) {
+            autoPause = false;
+        } else if (std::strcmp(argv[i], "--cpu-report") == 0) {
+            cpuReport = true;
+        } else {
+            std::cerr << "Usage: CPong [--seed N] [--record FILE] [--profile PREFIX] [--overlay] [--sim-rate HZ]\n"
+                         "             [--no-vsync] [--fps-limit HZ] [--no-late-latch]\n"
+                         "             [--host PORT | --connect HOST:PORT] [--net-latency MS] [--net-jitter MS]\n"
+                         "             [--net-loss P] [--spectate HOST:PORT] [--balls N] [--ball-threads N]\n"
+                         "             [--table classic|wide|mini] [--shader-cache DIR | --no-shader-cache]\n"
+                         "             [--startup-times] [--no-auto-pause] [--cpu-report] [--telemetry FILE]\n";
+            return -1;
+        }
+    }
+
+    // Two-player rollback match: the host plays left, the client right
+    std::unique_ptr<sim::NetSession> net;
+    if (hostPort >= 0 || !connectTo.empty()) {
+        net.reset(new sim::NetSession(sim::MatchConfig(), 1.0f / 60.0f));
+        net->setConditions(link);
+        std::string error, host;
+        std::uint16_t port = 0;
+        bool ok = hostPort >= 0 ? net->host(static_cast<std::uint16_t>(hostPort), seed, error)
+                                : splitHostPort(connectTo, host, port) && net->connect(host, port, error);
+        if (!ok) {
+            std::cerr << "Network: " << (error.empty() ? "expected --connect HOST:PORT" : error) << "\n";
+            return -1;
+        }
+        if (recordPath) {
+            std::cerr << "--record is not supported in network matches\n";
+            recordPath = nullptr;
+        }
+    }
+    if (recordPath && balls > 0) {
+        std::cerr << "--record is not supported in multi-ball mode\n";
+        recordPath = nullptr;
+    }
+
+    // Spectator: draws a match broadcast by cpong_broadcast
+    std::unique_ptr<sim::SpectatorClient> spectator;
+    if (!spectateFrom.empty()) {
+        spectator.reset(new sim::SpectatorClient());
+        std::string error, host;
+        std::uint16_t port = 0;
+        if (!splitHostPort(spectateFrom, host, port) || !spectator->connect(host, port, error)) {
+            std::cerr << "Spectate: " << (error.empty() ? "expected --spectate HOST:PORT" : error) << "\n";
+            return -1;
+        }
+        if (recordPath) {
+            std::cerr << "--record is not supported while spectating\n";
+            recordPath = nullptr;
+        }
+    }
+
+    // Startup breakdown for --startup-times, each phase timed from the end of the last
+    double glfwMs = 0.0, windowMs = 0.0, gladMs = 0.0, cacheMs = 0.0, matchMs = 0.0;
+    auto phaseStart = std::chrono::steady_clock::now();
 
     if (!glfwInit()) {
         std::cerr << "Failed to initialize GLFW\n";
@@ -31,6 +215,7 @@ int main() {
 #ifdef __APPLE__
     glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);
 #endif
+    glfwMs = lap(phaseStart);
 
     const int width = 1280;
     const int height = 720;
@@ -42,7 +227,15 @@ int main() {
     }
 
     glfwMakeContextCurrent(window);
-    glfwSwapInterval(1);  // VSync
+    glfwSwapInterval(vsync ? 1 : 0);
+    windowMs = lap(phaseStart);
+
+    // Without vsync, pace frames ourselves (0 = uncapped)
+    if (fpsLimit < 0.0) {
+        const GLFWvidmode* mode = glfwGetVideoMode(glfwGetPrimaryMonitor());
+        fpsLimit = mode && mode->refreshRate > 0 ? mode->refreshRate : 60.0;
+    }
+    FrameLimiter limiter(vsync ? 0.0 : fpsLimit);
 
     if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
         std::cerr << "Failed to initialize GLAD\n";
@@ -50,29 +243,164 @@ int main() {
         glfwTerminate();
         return -1;
     }
+    gladMs = lap(phaseStart);
+
+    // Linked shader programs as driver binaries: a warm start compiles no GLSL
+    std::unique_ptr<ProgramCache> programCache;
+    if (!shaderCacheDir.empty()) programCache.reset(new ProgramCache((GLADloadproc)glfwGetProcAddress, shaderCacheDir));
+    cacheMs = lap(phaseStart);
+
+    // Per-phase timings; written to PREFIX.json (Chrome trace) and PREFIX.csv on exit
+    Profiler profiler(profilePrefix != nullptr || overlay);
+    const int framePhase = profiler.addPhase("frame");
+    const int limitPhase = profiler.addPhase("frameLimit");
+    const int pollPhase = profiler.addPhase("pollEvents");
+    const int updatePhase = profiler.addPhase("update");
+    const int renderPhase = profiler.addPhase("render");
+    const int swapPhase = profiler.addPhase("swapBuffers");
 
-    Game game(width, height);
+    Game game(width, height, seed, programCache.get());
+    lap(phaseStart);  // split into shaders and buffers by game.startupTimes()
+    game.startMatch(seed, table);
+    if (recordPath && !game.startRecording(recordPath)) {
+        std::cerr << "Failed to open input log " << recordPath << "\n";
+    }
+    if (telemetryPath) {
+        if (net || spectator || balls > 0)
+            std::cerr << "--telemetry records local single-ball matches only\n";
+        else
+            game.startTelemetry(telemetryPath);
+    }
+    if (profiler.enabled()) {
+        game.setProfiler(profiler, framePhase, {limitPhase, pollPhase, updatePhase, renderPhase, swapPhase});
+        game.setOverlayVisible(overlay);
+    }
+    // Fixed-rate simulation on its own thread; 0 steps it once per frame instead.
+    // Network matches tick on the main thread, in step with the peer, and so
+    // does multi-ball mode (its ticks spread over --ball-threads, 0 = all cores).
+    if (net) {
+        game.startNetMatch(std::move(net));
+    } else if (spectator) {
+        game.startSpectating(std::move(spectator));
+    } else if (balls > 0) {
+        sim::MultiBallConfig ballConfig;
+        ballConfig.balls = balls;
+        game.startMultiBall(std::unique_ptr<sim::MultiBall>(new sim::MultiBall(table, ballConfig, seed)),
+                            ballThreads);
+    } else if (simRate > 0.0) {
+        game.runSimulationThread(simRate);
+    }
+    game.setLateLatch(lateLatch);
     glfwSetWindowUserPointer(window, &game);
     glfwSetFramebufferSizeCallback(window, framebufferSizeCallback);
+    glfwSetKeyCallback(window, keyCallback);
 
-    glEnable(GL_DEPTH_TEST);
-    glClearColor(0.1f, 0.1f, 0.15f, 1.0f);
+    if (autoPause) {
+        glfwSetWindowFocusCallback(window, focusCallback);
+        glfwSetWindowIconifyCallback(window, iconifyCallback);
+    }
+    glfwSetWindowRefreshCallback(window, refreshCallback);
 
+    // Idle scheduling: a paused match or a minimised window shows nothing
+    // new, so instead of rendering every vsync the loop sleeps in
+    // glfwWaitEventsTimeout and draws only when something visible changed
+    const double idleWaitSeconds = 0.5;
+    const double cpuReportSeconds = 5.0;
+    CpuUsage cpu;
+    double cpuReportAt = glfwGetTime() + cpuReportSeconds;
+
+    int titleLeft = -1, titleRight = -1;
+    bool firstFrame = true;
+    matchMs = lap(phaseStart);
     double lastTime = glfwGetTime();
     while (!glfwWindowShouldClose(window) && !game.shouldClose()) {
+        ScopedTimer frameTimer(profiler, framePhase);
+
+        bool wasPaused = game.paused();
+        bool hidden = glfwGetWindowAttrib(window, GLFW_ICONIFIED) != 0;
+        bool idle = wasPaused || hidden;
+        if (idle) {
+            // A hidden network match must keep ticking, at about 60 Hz
+            ScopedTimer t(profiler, pollPhase);
+            glfwWaitEventsTimeout(wasPaused ? idleWaitSeconds : 1.0 / 60.0);
+        } else {
+            // Wait for the frame slot handling events as they arrive, so key
+            // callbacks get accurate timestamps; the frame then runs straight
+            // through to present
+            if (limiter.enabled()) {
+                ScopedTimer t(profiler, limitPhase);
+                limiter.wait([](double seconds) { glfwWaitEventsTimeout(seconds); });
+            }
+            ScopedTimer t(profiler, pollPhase);
+            glfwPollEvents();
+        }
+
         double currentTime = glfwGetTime();
         float deltaTime = static_cast<float>(currentTime - lastTime);
         lastTime = currentTime;
 
-        game.processInput(window, deltaTime);
-        game.update(deltaTime);
-        game.render();
+        // Paused time, including the wait that ended it, never reaches the
+        // simulation: the frame that resumes only draws
+        if (!wasPaused) {
+            ScopedTimer t(profiler, updatePhase);
+            game.update(deltaTime);
+        }
+
+        // The score is drawn in-game; the title only follows it for taskbars
+        if (game.scoreLeft() != titleLeft || game.scoreRight() != titleRight) {
+            titleLeft = game.scoreLeft();
+            titleRight = game.scoreRight();
+            std::string title = "3D Pong - " + std::to_string(titleLeft) + " : " + std::to_string(titleRight);
+            glfwSetWindowTitle(window, title.c_str());
+        }
+
+        if (!hidden && game.needsRedraw()) {
+            {
+                ScopedTimer t(profiler, renderPhase);
+                game.render();
+            }
+            {
+                ScopedTimer t(profiler, swapPhase);
+                glfwSwapBuffers(window);
+            }
+            game.framePresented();
 
-        std::string title = "3D Pong - " + std::to_string(game.scoreLeft()) + " : " + std::to_string(game.scoreRight());
-        glfwSetWindowTitle(window, title.c_str());
+            // From the end of setup to the first swap, which waits for the GPU
+            // on most drivers
+            if (firstFrame && startupTimes) {
+                const Game::StartupTimes& times = game.startupTimes();
+                double firstFrameMs = lap(phaseStart);
+                double totalMs = std::chrono::duration<double, std::milli>(phaseStart - processStart).count();
+                std::printf("startup: glfw %.1f ms, window %.1f ms, glad %.1f ms, shaders %.1f ms (%d/%d cached%s),\n"
+                            "         buffers %.1f ms, match %.1f ms, first frame %.1f ms, total %.1f ms\n",
+                            glfwMs, windowMs, gladMs, cacheMs + times.shadersMs, times.cachedPrograms,
+                            times.programs, programCache && programCache->enabled() ? "" : ", cache off",
+                            times.buffersMs, matchMs, firstFrameMs, totalMs);
+            }
+            firstFrame = false;
+        }
+
+        if (cpuReport) {
+            cpu.sample(idle ? CpuUsage::Idle : CpuUsage::Active);
+            if (currentTime >= cpuReportAt) {
+                printCpuUsage(cpu);
+                cpuReportAt = currentTime + cpuReportSeconds;
+            }
+        }
+    }
+    if (cpuReport) printCpuUsage(cpu);
 
-        glfwSwapBuffers(window);
-        glfwPollEvents();
+    if (profilePrefix) {
+        std::string prefix = profilePrefix;
+        if (!profiler.writeChromeTrace(prefix + ".json") || !profiler.writeCsv(prefix + ".csv"))
+            std::cerr << "Failed to write profile " << prefix << ".json/.csv\n";
+        std::cout << "phase                    count  unit         p50         p99         max\n";
+        for (int p = 0; p < profiler.phaseCount(); ++p) {
+            Profiler::Summary s = profiler.summary(p);
+            std::printf("%-22s %7llu  %-5s %11.1f %11.1f %11.1f\n", s.name.c_str(),
+                        static_cast<unsigned long long>(s.count), s.kind == Profiler::Duration ? "us" : "count",
+                        s.p50, s.p99, s.max);
+        }
     }
 
     glfwDestroyWindow(window);
@@ -0,0 +1,50 @@
+# Writes OUTPUT, a C++ source defining embeddedShader() over every *.glsl in
+# SHADER_DIR, each named as the game asks for it ("shaders/vertex.glsl").
+#
+#   cmake -DSHADER_DIR=<dir> -DOUTPUT=<file.cpp> -P EmbedShaders.cmake
+
+file(GLOB sources "${SHADER_DIR}/*.glsl")
+list(SORT sources)
+get_filename_component(prefix "${SHADER_DIR}" NAME)
+
+set(entries "")
+foreach(source IN LISTS sources)
+  file(READ "${source}" text)
+  if(text MATCHES "\\)glsl\"")
+    message(FATAL_ERROR "${source} contains the raw string delimiter )glsl\"")
+  endif()
+  get_filename_component(name "${source}" NAME)
+  string(APPEND entries "    {\"${prefix}/${name}\", R\"glsl(${text})glsl\"},\n")
+endforeach()
+
+set(content "// Generated from ${prefix}/ by cmake/EmbedShaders.cmake - do not edit
+#include \"EmbeddedShaders.h\"
+#include <cstring>
+
+namespace {
+
+struct EmbeddedShader {
+    const char* path;
+    const char* source;
+};
+
+const EmbeddedShader shaders[] = {
+${entries}};
+
+}  // namespace
+
+const char* embeddedShader(const char* path) {
+    for (const EmbeddedShader& shader : shaders)
+        if (std::strcmp(shader.path, path) == 0) return shader.source;
+    return nullptr;
+}
+")
+
+# Leave an unchanged file alone so dependents are not rebuilt
+if(EXISTS "${OUTPUT}")
+  file(READ "${OUTPUT}" previous)
+  if(previous STREQUAL content)
+    return()
+  endif()
+endif()
+file(WRITE "${OUTPUT}" "${content}")
@@ -0,0 +1,12 @@
+#version 330 core
+out vec4 FragColor;
+
+in vec2 vUV;
+in vec3 vColor;
+
+uniform sampler2D atlas;
+
+void main()
+{
+    FragColor = vec4(vColor, texture(atlas, vUV).r);
+}
@@ -0,0 +1,18 @@
+#version 330 core
+layout (location = 0) in vec2 aCorner;  // unit quad, (0,0) = top-left
+layout (location = 1) in vec4 aRect;    // per glyph: x, y, w, h in pixels from the top-left
+layout (location = 2) in vec4 aUV;      // per glyph: atlas u0, v0, u1, v1
+layout (location = 3) in vec3 aColor;   // per glyph
+
+uniform vec2 screenSize;
+
+out vec2 vUV;
+out vec3 vColor;
+
+void main()
+{
+    vec2 p = aRect.xy + aCorner * aRect.zw;
+    gl_Position = vec4(p.x / screenSize.x * 2.0 - 1.0, 1.0 - p.y / screenSize.y * 2.0, 0.0, 1.0);
+    vUV = mix(aUV.xy, aUV.zw, aCorner);
+    vColor = aColor;
+}
@@ -1,11 +1,23 @@
 #version 330 core
 layout (location = 0) in vec3 aPos;
 
-uniform mat4 model;
-uniform mat4 view;
-uniform mat4 projection;
+// Per-instance data, five texels each: model matrix columns, then colour.
+// instanceBase is where this draw's instances start.
+uniform samplerBuffer instances;
+uniform int instanceBase;
+
+layout (std140) uniform Camera {
+    mat4 view;
+    mat4 projection;
+};
+
+out vec3 vColor;
 
 void main()
 {
+    int texel = (instanceBase + gl_InstanceID) * 5;
+    mat4 model = mat4(texelFetch(instances, texel), texelFetch(instances, texel + 1),
+                      texelFetch(instances, texel + 2), texelFetch(instances, texel + 3));
+    vColor = texelFetch(instances, texel + 4).rgb;
     gl_Position = projection * view * model * vec4(aPos, 1.0);
 }
@@ -0,0 +1,177 @@
+#include "AIPolicy.h"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+namespace sim {
+
+void TrackerPolicy::evaluate(const AIObservations& obs, const MatchConfig& config, float* targetY) const {
+    const float limit = (config.tableWidth - config.paddleHeight) / 2.0f;
+    const float side = obs.side;
+    for (std::size_t i = 0; i < obs.count; ++i) {
+        float chase = std::clamp(obs.ballY[i] + obs.aimOffset[i], -limit - 1.0f, limit + 1.0f);
+        targetY[i] = obs.ballVelX[i] * side > 0 ? chase : obs.paddleY[i];
+    }
+}
+
+void InterceptPolicy::evaluate(const AIObservations& obs, const MatchConfig& config, float* targetY) const {
+    const float limit = (config.tableWidth - config.paddleHeight) / 2.0f;
+    const float side = obs.side;
+    // Ball centre x at contact, and its y range between the walls
+    const float contactX = side * (config.tableLength / 2.0f - config.paddleDepth - config.ballRadius);
+    const float h = config.tableWidth / 2.0f - config.ballRadius;
+    const float period = 4.0f * h;
+
+    for (std::size_t i = 0; i < obs.count; ++i) {
+        float vx = obs.ballVelX[i];
+        bool approaching = vx * side > 0;
+        float t = approaching ? std::max((contactX - obs.ballX[i]) / vx, 0.0f) : 0.0f;
+
+        // Unfold the bounces: y moves on a line, walls mirror it (triangle wave)
+        float u = obs.ballY[i] + obs.ballVelY[i] * t + h;
+        u -= period * std::floor(u / period);
+        float y = (u > 2.0f * h ? period - u : u) - h;
+
+        float aim = std::clamp(y + obs.aimOffset[i], -limit, limit);
+        targetY[i] = approaching ? aim : 0.0f;
+    }
+}
+
+bool MlpPolicy::load(const std::string& path, std::string& error) {
+    std::ifstream file(path);
+    if (!file) {
+        error = "cannot open " + path;
+        return false;
+    }
+    // Strip comments, then read whitespace-separated tokens
+    std::stringstream tokens;
+    for (std::string line; std::getline(file, line);) tokens << line.substr(0, line.find('#')) << '\n';
+
+    std::string word;
+    int inputs = 0;
+    if (!(tokens >> word >> inputs) || word != "mlp" || inputs != InputCount) {
+        error = path + ": expected 'mlp " + std::to_string(InputCount) + "' header";
+        return false;
+    }
+
+    std::vector<Layer> layers;
+    int width = inputs;
+    int maxWidth = inputs;
+    while (tokens >> word) {
+        Layer layer;
+        std::string activation;
+        if (word != "dense" || !(tokens >> layer.outputs >> activation) || layer.outputs <= 0) {
+            error = path + ": bad layer " + std::to_string(layers.size());
+            return false;
+        }
+        if (activation == "relu") {
+            layer.activation = Relu;
+        } else if (activation == "tanh") {
+            layer.activation = Tanh;
+        } else if (activation == "linear") {
+            layer.activation = Linear;
+        } else {
+            error = path + ": unknown activation '" + activation + "'";
+            return false;
+        }
+        layer.inputs = width;
+        layer.weights.resize(static_cast<std::size_t>(layer.outputs) * layer.inputs);
+        layer.biases.resize(static_cast<std::size_t>(layer.outputs));
+        for (float& w : layer.weights) tokens >> w;
+        for (float& b : layer.biases) tokens >> b;
+        if (!tokens) {
+            error = path + ": layer " + std::to_string(layers.size()) + " is missing weights";
+            return false;
+        }
+        width = layer.outputs;
+        maxWidth = std::max(maxWidth, width);
+        layers.push_back(std::move(layer));
+    }
+    if (layers.empty() || width != 1) {
+        error = path + ": the last layer must have one output";
+        return false;
+    }
+    m_layers = std::move(layers);
+    m_maxWidth = maxWidth;
+    m_path = path;
+    return true;
+}
+
+// Activations are laid out neuron-major over a block of matches, so every
+// inner loop runs across matches with one weight broadcast and vectorizes
+void MlpPolicy::evaluate(const AIObservations& obs, const MatchConfig& config, float* targetY) const {
+    const std::size_t Block = 256;
+    const float side = obs.side;
+    const float invHalfLen = 2.0f / config.tableLength;
+    const float halfWidth = config.tableWidth / 2.0f;
+    const float invHalfWidth = 1.0f / halfWidth;
+    const float invMaxSpeed = 1.0f / config.maxSpeed;
+
+    // Per thread, so one policy can serve several stepping threads
+    thread_local std::vector<float> a, b;
+    a.resize(static_cast<std::size_t>(m_maxWidth) * Block);
+    b.resize(static_cast<std::size_t>(m_maxWidth) * Block);
+
+    for (std::size_t begin = 0; begin < obs.count; begin += Block) {
+        const std::size_t n = std::min(Block, obs.count - begin);
+        float* in = a.data();
+        float* out = b.data();
+
+        for (std::size_t i = 0; i < n; ++i) {
+            std::size_t m = begin + i;
+            in[0 * Block + i] = obs.ballX[m] * side * invHalfLen;
+            in[1 * Block + i] = obs.ballY[m] * invHalfWidth;
+            in[2 * Block + i] = obs.ballVelX[m] * side * invMaxSpeed;
+            in[3 * Block + i] = obs.ballVelY[m] * invMaxSpeed;
+            in[4 * Block + i] = obs.paddleY[m] * invHalfWidth;
+            in[5 * Block + i] = obs.aimOffset[m] * invHalfWidth;
+        }
+
+        for (const Layer& layer : m_layers) {
+            for (int j = 0; j < layer.outputs; ++j) {
+                float* o = out + static_cast<std::size_t>(j) * Block;
+                const float bias = layer.biases[j];
+                for (std::size_t i = 0; i < n; ++i) o[i] = bias;
+                const float* w = &layer.weights[static_cast<std::size_t>(j) * layer.inputs];
+                for (int k = 0; k < layer.inputs; ++k) {
+                    const float wk = w[k];
+                    const float* x = in + static_cast<std::size_t>(k) * Block;
+                    for (std::size_t i = 0; i < n; ++i) o[i] += wk * x[i];
+                }
+                if (layer.activation == Relu) {
+                    for (std::size_t i = 0; i < n; ++i) o[i] = std::max(o[i], 0.0f);
+                } else if (layer.activation == Tanh) {
+                    for (std::size_t i = 0; i < n; ++i) o[i] = std::tanh(o[i]);
+                }
+            }
+            std::swap(in, out);
+        }
+
+        for (std::size_t i = 0; i < n; ++i) targetY[begin + i] = in[i] * halfWidth;
+    }
+}
+
+std::unique_ptr<AIPolicy> makeAIPolicy(const std::string& spec, std::string& error) {
+    if (spec == "tracker") return std::unique_ptr<AIPolicy>(new TrackerPolicy());
+    if (spec == "intercept") return std::unique_ptr<AIPolicy>(new InterceptPolicy());
+    if (spec.compare(0, 4, "mlp:") == 0) {
+        std::unique_ptr<MlpPolicy> mlp(new MlpPolicy());
+        if (!mlp->load(spec.substr(4), error)) return nullptr;
+        return std::unique_ptr<AIPolicy>(std::move(mlp));
+    }
+    error = "unknown AI policy '" + spec + "' (tracker, intercept, mlp:FILE)";
+    return nullptr;
+}
+
+void moveTowardTargets(const float* targetY, float* paddleY, std::size_t count, float maxStep, float limit) {
+    // Same operations, in the same order, as the built-in tracker's move
+    for (std::size_t i = 0; i < count; ++i) {
+        float diff = targetY[i] - paddleY[i];
+        float move = std::copysign(std::min(maxStep, std::abs(diff)), diff);
+        float moved = std::clamp(paddleY[i] + move, -limit, limit);
+        paddleY[i] = std::abs(diff) > 0.15f ? moved : paddleY[i];
+    }
+}
+
+}  // namespace sim
@@ -0,0 +1,103 @@
+#pragma once
+
+// Pluggable AI paddle policies. A policy maps observations to the paddle Y
+// it wants to reach; the shared actuator (moveTowardTargets) then moves the
+// paddle there at the side's AIParams::speed, so policies differ in
+// judgement, not reflexes.
+//
+// Observations are structure-of-arrays so MatchBatch can hand over its
+// columns directly and a policy evaluates thousands of matches per call.
+
+#include "Simulation.h"
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sim {
+
+// One side's view of `count` matches (one entry per match in each array)
+struct AIObservations {
+    std::size_t count = 0;
+    float side = 1.0f;  // +1 right paddle, -1 left; shared by the batch
+    const float* ballX = nullptr;
+    const float* ballY = nullptr;
+    const float* ballVelX = nullptr;
+    const float* ballVelY = nullptr;
+    const float* paddleY = nullptr;
+    const float* aimOffset = nullptr;  // the side's current aim error (AIState::targetOffset)
+};
+
+class AIPolicy {
+public:
+    virtual ~AIPolicy() = default;
+    virtual const char* name() const = 0;
+    // What makeAIPolicy() needs to build this policy again (input logs store it)
+    virtual std::string spec() const = 0;
+    // Writes obs.count target paddle positions
+    virtual void evaluate(const AIObservations& obs, const MatchConfig& config, float* targetY) const = 0;
+};
+
+// The original reactive tracker: chase the ball's Y plus the aim error while
+// the ball approaches, hold still otherwise. Bit-identical to the built-in AI.
+class TrackerPolicy : public AIPolicy {
+public:
+    const char* name() const override { return "tracker"; }
+    std::string spec() const override { return "tracker"; }
+    void evaluate(const AIObservations& obs, const MatchConfig& config, float* targetY) const override;
+};
+
+// Closed-form intercept: where the ball will cross the paddle face, folding
+// the straight-line path at the top and bottom walls. Recenters while the
+// ball moves away. The aim error still applies, so it stays beatable.
+class InterceptPolicy : public AIPolicy {
+public:
+    const char* name() const override { return "intercept"; }
+    std::string spec() const override { return "intercept"; }
+    void evaluate(const AIObservations& obs, const MatchConfig& config, float* targetY) const override;
+};
+
+// Small fixed-weight multilayer perceptron loaded from a text file:
+//
+//   mlp 6                      input count (must be 6, see below)
+//   dense 16 relu              a layer: outputs, activation (relu|tanh|linear)
+//   <outputs x inputs weights, row-major> <outputs biases>
+//   dense 1 tanh
+//   ...
+//
+// '#' starts a comment. Inputs, mirrored so one net plays either side:
+// ballX * side / halfLength, ballY / halfWidth, ballVelX * side / maxSpeed,
+// ballVelY / maxSpeed, paddleY / halfWidth, aimOffset / halfWidth.
+// The single output times halfWidth is the target Y.
+class MlpPolicy : public AIPolicy {
+public:
+    static const int InputCount = 6;
+
+    bool load(const std::string& path, std::string& error);
+
+    const char* name() const override { return "mlp"; }
+    std::string spec() const override { return "mlp:" + m_path; }
+    void evaluate(const AIObservations& obs, const MatchConfig& config, float* targetY) const override;
+
+private:
+    enum Activation { Linear, Relu, Tanh };
+    struct Layer {
+        int inputs = 0, outputs = 0;
+        Activation activation = Linear;
+        std::vector<float> weights;  // outputs x inputs
+        std::vector<float> biases;
+    };
+
+    std::string m_path;
+    std::vector<Layer> m_layers;
+    int m_maxWidth = 0;
+};
+
+// "tracker", "intercept" or "mlp:FILE"; nullptr and `error` on failure
+std::unique_ptr<AIPolicy> makeAIPolicy(const std::string& spec, std::string& error);
+
+// The actuator: each paddle steps toward its target by at most `maxStep`,
+// ignoring differences under 0.15 units, and stays within +-limit
+void moveTowardTargets(const float* targetY, float* paddleY, std::size_t count, float maxStep, float limit);
+
+}  // namespace sim
@@ -0,0 +1,48 @@
+#include "CpuUsage.h"
+#include <chrono>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/resource.h>
+#endif
+
+namespace {
+
+double wallSeconds() {
+    return std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}  // namespace
+
+double processCpuSeconds() {
+#ifdef _WIN32
+    FILETIME creation, exit, kernel, user;
+    if (!GetProcessTimes(GetCurrentProcess(), &creation, &exit, &kernel, &user)) return 0.0;
+    auto seconds = [](const FILETIME& t) {
+        return (static_cast<unsigned long long>(t.dwHighDateTime) << 32 | t.dwLowDateTime) * 1e-7;
+    };
+    return seconds(kernel) + seconds(user);
+#else
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return 0.0;
+    return usage.ru_utime.tv_sec + usage.ru_stime.tv_sec + (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) * 1e-6;
+#endif
+}
+
+CpuUsage::CpuUsage() : m_lastCpu(processCpuSeconds()), m_lastWall(wallSeconds()) {}
+
+void CpuUsage::sample(State state) {
+    double cpu = processCpuSeconds();
+    double wall = wallSeconds();
+    m_totals[state].cpuSeconds += cpu - m_lastCpu;
+    m_totals[state].wallSeconds += wall - m_lastWall;
+    m_lastCpu = cpu;
+    m_lastWall = wall;
+}
+
+void CpuUsage::reset() {
+    for (Totals& totals : m_totals) totals = Totals();
+    m_lastCpu = processCpuSeconds();
+    m_lastWall = wallSeconds();
+}
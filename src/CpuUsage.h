@@ -0,0 +1,30 @@
+#pragma once
+
+// Process CPU time per wall-clock second, split by what the main loop was
+// doing, to see what an idle (paused or minimised) game still costs.
+// One core fully busy reads 1.0; all threads of the process count.
+class CpuUsage {
+public:
+    enum State { Active, Idle, StateCount };
+
+    struct Totals {
+        double cpuSeconds = 0.0;
+        double wallSeconds = 0.0;
+        double cores() const { return wallSeconds > 0.0 ? cpuSeconds / wallSeconds : 0.0; }
+    };
+
+    CpuUsage();
+
+    // Charges the time since the previous call (or construction) to `state`
+    void sample(State state);
+    const Totals& totals(State state) const { return m_totals[state]; }
+    void reset();
+
+private:
+    double m_lastCpu;
+    double m_lastWall;
+    Totals m_totals[StateCount];
+};
+
+// CPU seconds used so far by every thread of this process; 0 if unknown
+double processCpuSeconds();
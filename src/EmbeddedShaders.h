@@ -0,0 +1,6 @@
+#pragma once
+
+// GLSL sources compiled into the executable from shaders/ at build time, so
+// startup reads no files. `path` is the name relative to the project root,
+// e.g. "shaders/vertex.glsl"; nullptr if no such shader was embedded.
+const char* embeddedShader(const char* path);
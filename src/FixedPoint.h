@@ -0,0 +1,76 @@
+#pragma once
+
+// Q16.16 arithmetic for Integrator::Fixed. Integer operations give the same
+// bits on every compiler and CPU, unlike float math that may be contracted,
+// reassociated (-ffast-math) or kept in x87 extended precision.
+//
+// Any Q16.16 value below 256 in magnitude converts to float exactly, so the
+// fixed path can keep its state in the ordinary float MatchState: reading it
+// back with toFixed() returns the same integers.
+
+#include <cstdint>
+
+namespace sim {
+
+using Fixed = std::int32_t;  // Q16.16
+using FixedTime = std::int64_t;  // seconds in Q0.32, fine enough for 600 Hz substeps
+
+const int FixedShift = 16;
+const Fixed FixedOne = 1 << FixedShift;
+
+// The only float-to-integer steps. Scaling a float by a power of two and
+// adding 1/2 are both exact in double, and the cast truncates, so this
+// rounds half away from zero identically everywhere (like std::llround,
+// without the library call).
+inline std::int64_t roundToInteger(double value) {
+    return static_cast<std::int64_t>(value < 0.0 ? value - 0.5 : value + 0.5);
+}
+inline Fixed toFixed(float value) {
+    return static_cast<Fixed>(roundToInteger(static_cast<double>(value) * FixedOne));
+}
+inline FixedTime toFixedTime(float seconds) {
+    return roundToInteger(static_cast<double>(seconds) * 4294967296.0);
+}
+inline float fromFixed(Fixed value) {
+    return static_cast<float>(value) * (1.0f / FixedOne);
+}
+
+// Products round to nearest (ties up); shifts of negative values are
+// arithmetic on every supported compiler
+inline Fixed fixedMul(Fixed a, Fixed b) {
+    return static_cast<Fixed>((static_cast<std::int64_t>(a) * b + (1 << (FixedShift - 1))) >> FixedShift);
+}
+// Distance covered at `velocity` (units/s, Q16.16) in `time`
+inline Fixed fixedDistance(Fixed velocity, FixedTime time) {
+    return static_cast<Fixed>((static_cast<std::int64_t>(velocity) * time + (std::int64_t(1) << 31)) >> 32);
+}
+inline Fixed fixedAbs(Fixed v) { return v < 0 ? -v : v; }
+inline Fixed fixedMin(Fixed a, Fixed b) { return a < b ? a : b; }
+inline Fixed fixedMax(Fixed a, Fixed b) { return a > b ? a : b; }
+inline Fixed fixedClamp(Fixed v, Fixed lo, Fixed hi) { return fixedMin(fixedMax(v, lo), hi); }
+
+// floor(sqrt(v)), bit by bit
+inline std::uint32_t isqrt64(std::uint64_t v) {
+    std::uint64_t result = 0;
+    std::uint64_t bit = std::uint64_t(1) << 62;
+    while (bit > v) bit >>= 2;
+    while (bit != 0) {
+        if (v >= result + bit) {
+            v -= result + bit;
+            result = (result >> 1) + bit;
+        } else {
+            result >>= 1;
+        }
+        bit >>= 2;
+    }
+    return static_cast<std::uint32_t>(result);
+}
+
+// |(x, y)| in Q16.16: the squares are Q32.32, whose root is Q16.16 again
+inline Fixed fixedLength(Fixed x, Fixed y) {
+    std::uint64_t squares = static_cast<std::uint64_t>(static_cast<std::int64_t>(x) * x) +
+                            static_cast<std::uint64_t>(static_cast<std::int64_t>(y) * y);
+    return static_cast<Fixed>(isqrt64(squares));
+}
+
+}  // namespace sim
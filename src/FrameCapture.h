@@ -0,0 +1,52 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// Offscreen render target (RGBA8 colour + 24-bit depth FBO) with
+// asynchronous readback. Each capture() starts a glReadPixels into the next
+// pixel buffer object of a ring and hands the oldest finished one to the
+// sink, so the CPU never waits on the frame it just submitted.
+class FrameCapture {
+public:
+    // rgba: width * height * 4 bytes, rows bottom-up as GL stores them
+    using FrameSink = std::function<void(const unsigned char* rgba, std::uint64_t frame)>;
+
+    FrameCapture(int width, int height, int ringSize = 3);
+    ~FrameCapture();
+
+    FrameCapture(const FrameCapture&) = delete;
+    FrameCapture& operator=(const FrameCapture&) = delete;
+
+    bool complete() const { return m_complete; }
+    int width() const { return m_width; }
+    int height() const { return m_height; }
+
+    // Makes the FBO the draw target and sets the viewport
+    void bind();
+
+    // Queues a readback of the current frame; a frame reaches the sink at the
+    // start of the capture ringSize calls later (when its slot is reused), in
+    // order
+    void capture(const FrameSink& sink);
+    // Delivers every frame still in flight
+    void finish(const FrameSink& sink);
+
+private:
+    struct Slot {
+        GLuint pbo = 0;
+        GLsync fence = nullptr;
+        std::uint64_t frame = 0;
+    };
+
+    void deliver(Slot& slot, const FrameSink& sink);
+
+    int m_width, m_height;
+    GLuint m_fbo = 0, m_color = 0, m_depth = 0;
+    bool m_complete = false;
+    std::vector<Slot> m_ring;
+    std::uint64_t m_issued = 0;     // captures started
+    std::uint64_t m_delivered = 0;  // captures handed to a sink
+};
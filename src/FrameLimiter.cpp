@@ -0,0 +1,32 @@
+#include "FrameLimiter.h"
+#include <chrono>
+#include <thread>
+
+namespace {
+
+std::int64_t nowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+}  // namespace
+
+FrameLimiter::FrameLimiter(double hz, double spinSeconds)
+    : m_periodNs(hz > 0.0 ? static_cast<std::int64_t>(1e9 / hz) : 0),
+      m_spinNs(static_cast<std::int64_t>(spinSeconds * 1e9)) {}
+
+double FrameLimiter::coarseRemaining() {
+    std::int64_t now = nowNs();
+    if (m_deadlineNs == 0) m_deadlineNs = now + m_periodNs;
+    return (m_deadlineNs - m_spinNs - now) * 1e-9;
+}
+
+void FrameLimiter::finish() {
+    std::int64_t now;
+    while ((now = nowNs()) < m_deadlineNs) std::this_thread::yield();
+
+    // A frame that ran long starts a fresh schedule instead of rushing the
+    // next ones to catch up
+    m_deadlineNs += m_periodNs;
+    if (m_deadlineNs < now) m_deadlineNs = now + m_periodNs;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <cstdint>
+
+// Paces frames to a fixed rate when vsync is off. Sleeping alone overshoots
+// by up to a scheduler quantum, so the limiter blocks (e.g. waiting for
+// window events) until shortly before the deadline and spins the rest.
+class FrameLimiter {
+public:
+    explicit FrameLimiter(double hz = 0.0, double spinSeconds = 0.002);
+
+    bool enabled() const { return m_periodNs > 0; }
+
+    // `coarseWait(seconds)` may return early (e.g. on an event); it is
+    // called again until only the spin margin is left.
+    template <typename CoarseWait>
+    void wait(CoarseWait coarseWait) {
+        for (double seconds; (seconds = coarseRemaining()) > 0.0;) coarseWait(seconds);
+        finish();
+    }
+
+    // Seconds left to block before spinning; <= 0 once it is time to spin
+    double coarseRemaining();
+    // Spins up to the deadline, then schedules the next one
+    void finish();
+
+private:
+    std::int64_t m_periodNs;
+    std::int64_t m_spinNs;
+    std::int64_t m_deadlineNs = 0;
+};
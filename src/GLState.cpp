@@ -0,0 +1,158 @@
+#include "GLState.h"
+#include <cstring>
+
+void GLState::useProgram(GLuint program) {
+    if (changed(m_program, program)) glUseProgram(program);
+}
+
+void GLState::bindVertexArray(GLuint vao) {
+    if (changed(m_vertexArray, vao)) glBindVertexArray(vao);
+}
+
+void GLState::bindBuffer(GLenum target, GLuint buffer) {
+    if (target == GL_ARRAY_BUFFER) {
+        if (!changed(m_arrayBuffer, buffer)) return;
+    } else if (target == GL_TEXTURE_BUFFER) {
+        if (!changed(m_textureBuffer, buffer)) return;
+    } else if (target == GL_UNIFORM_BUFFER) {
+        if (!changed(m_uniformBuffer, buffer)) return;
+    } else {
+        m_stats.issued++;
+    }
+    glBindBuffer(target, buffer);
+}
+
+void GLState::bindBufferBase(GLenum target, GLuint index, GLuint buffer) {
+    if (target == GL_UNIFORM_BUFFER) m_uniformBuffer = buffer;
+    m_stats.issued++;
+    glBindBufferBase(target, index, buffer);
+}
+
+void GLState::activeTexture(GLenum unit) {
+    if (changed(m_activeTexture, unit)) glActiveTexture(unit);
+}
+
+void GLState::bindTexture2D(GLuint texture) {
+    bindTexture(m_textures2D, GL_TEXTURE_2D, texture);
+}
+
+void GLState::bindTextureBuffer(GLuint texture) {
+    bindTexture(m_bufferTextures, GL_TEXTURE_BUFFER, texture);
+}
+
+void GLState::bindTexture(GLuint* units, GLenum target, GLuint texture) {
+    // An unknown unit could be any of them
+    GLuint scratch = Unknown;
+    GLuint& bound = m_activeTexture - GL_TEXTURE0 < TextureUnits ? units[m_activeTexture - GL_TEXTURE0] : scratch;
+    if (changed(bound, texture)) glBindTexture(target, texture);
+}
+
+void GLState::setEnabled(GLenum capability, bool enabled) {
+    Capability* entry = nullptr;
+    for (Capability& c : m_capabilities)
+        if (c.capability == capability) entry = &c;
+    if (!entry) {
+        m_capabilities.push_back({capability, -1});
+        entry = &m_capabilities.back();
+    }
+    if (!changed(entry->enabled, enabled ? 1 : 0)) return;
+    if (enabled)
+        glEnable(capability);
+    else
+        glDisable(capability);
+}
+
+void GLState::blendFunc(GLenum source, GLenum destination) {
+    if (m_blendSource == source && m_blendDestination == destination) {
+        m_stats.elided++;
+        return;
+    }
+    m_blendSource = source;
+    m_blendDestination = destination;
+    m_stats.issued++;
+    glBlendFunc(source, destination);
+}
+
+void GLState::lineWidth(float width) {
+    if (changed(m_lineWidth, width)) glLineWidth(width);
+}
+
+void GLState::clearColor(float r, float g, float b, float a) {
+    const float color[4] = {r, g, b, a};
+    if (std::memcmp(m_clearColor, color, sizeof(color)) == 0) {
+        m_stats.elided++;
+        return;
+    }
+    std::memcpy(m_clearColor, color, sizeof(color));
+    m_stats.issued++;
+    glClearColor(r, g, b, a);
+}
+
+bool GLState::uniformChanged(GLuint program, GLint location, const void* data, std::size_t size) {
+    // GL ignores location -1, so the call can go too
+    if (location < 0) {
+        m_stats.elided++;
+        return false;
+    }
+    if (size > sizeof(UniformValue::bytes)) {
+        m_stats.issued++;
+        return true;
+    }
+    UniformValue& value = m_uniforms[static_cast<std::uint64_t>(program) << 32 | static_cast<std::uint32_t>(location)];
+    if (value.size == size && std::memcmp(value.bytes, data, size) == 0) {
+        m_stats.elided++;
+        return false;
+    }
+    std::memcpy(value.bytes, data, size);
+    value.size = size;
+    m_stats.issued++;
+    return true;
+}
+
+void GLState::deleteBuffer(GLuint buffer) {
+    if (m_arrayBuffer == buffer) m_arrayBuffer = 0;
+    if (m_textureBuffer == buffer) m_textureBuffer = 0;
+    if (m_uniformBuffer == buffer) m_uniformBuffer = 0;
+    glDeleteBuffers(1, &buffer);
+}
+
+void GLState::deleteVertexArray(GLuint vao) {
+    if (m_vertexArray == vao) m_vertexArray = 0;
+    glDeleteVertexArrays(1, &vao);
+}
+
+void GLState::deleteTexture(GLuint texture) {
+    for (int unit = 0; unit < TextureUnits; ++unit) {
+        if (m_textures2D[unit] == texture) m_textures2D[unit] = 0;
+        if (m_bufferTextures[unit] == texture) m_bufferTextures[unit] = 0;
+    }
+    glDeleteTextures(1, &texture);
+}
+
+void GLState::deleteProgram(GLuint program) {
+    // A program in use is only flagged for deletion and stays current until
+    // the next glUseProgram, which must then not be skipped
+    if (m_program == program) m_program = Unknown;
+    for (auto it = m_uniforms.begin(); it != m_uniforms.end();) {
+        if (it->first >> 32 == program)
+            it = m_uniforms.erase(it);
+        else
+            ++it;
+    }
+    glDeleteProgram(program);
+}
+
+void GLState::invalidate() {
+    m_program = Unknown;
+    m_vertexArray = Unknown;
+    m_arrayBuffer = Unknown;
+    m_textureBuffer = Unknown;
+    m_uniformBuffer = Unknown;
+    m_activeTexture = Unknown;
+    for (int unit = 0; unit < TextureUnits; ++unit) m_textures2D[unit] = m_bufferTextures[unit] = Unknown;
+    m_capabilities.clear();
+    m_blendSource = m_blendDestination = Unknown;
+    m_lineWidth = -1.0f;
+    for (float& c : m_clearColor) c = -1.0f;
+    m_uniforms.clear();
+}
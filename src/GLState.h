@@ -0,0 +1,107 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <cstddef>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+// Shadow copy of the GL state the renderers touch. Each setter compares
+// against the last value it sent and skips the call when nothing changes,
+// so draw code can simply state what it needs instead of restoring state
+// after itself. Every value starts unknown, so the first call always goes
+// out.
+//
+// Only code that goes through this object is tracked: anything else that
+// changes the same state must call invalidate() afterwards.
+class GLState {
+public:
+    struct Stats {
+        std::uint64_t issued = 0;
+        std::uint64_t elided = 0;
+    };
+
+    GLState() { invalidate(); }
+
+    GLState(const GLState&) = delete;
+    GLState& operator=(const GLState&) = delete;
+
+    void useProgram(GLuint program);
+    void bindVertexArray(GLuint vao);
+    // GL_ARRAY_BUFFER, GL_TEXTURE_BUFFER and GL_UNIFORM_BUFFER are cached.
+    // Other targets are passed through (GL_ELEMENT_ARRAY_BUFFER belongs to
+    // the bound VAO).
+    void bindBuffer(GLenum target, GLuint buffer);
+    // Also sets the target's generic binding, as GL does
+    void bindBufferBase(GLenum target, GLuint index, GLuint buffer);
+    void activeTexture(GLenum unit);
+    // On the active unit. Each target has its own binding per unit.
+    void bindTexture2D(GLuint texture);
+    void bindTextureBuffer(GLuint texture);
+    void setEnabled(GLenum capability, bool enabled);
+    void blendFunc(GLenum source, GLenum destination);
+    void lineWidth(float width);
+    void clearColor(float r, float g, float b, float a);
+
+    // For glUniform*: true (and counted as issued) if `size` bytes at
+    // `data` differ from what was last written to this program's location.
+    // Uniform values belong to the program, so they survive useProgram().
+    bool uniformChanged(GLuint program, GLint location, const void* data, std::size_t size);
+
+    // Deleting a bound object unbinds it and frees its name for reuse
+    void deleteBuffer(GLuint buffer);
+    void deleteVertexArray(GLuint vao);
+    void deleteTexture(GLuint texture);
+    void deleteProgram(GLuint program);
+
+    // Forget everything; the next call of each kind is issued
+    void invalidate();
+
+    // Calls issued and elided since resetStats()
+    const Stats& stats() const { return m_stats; }
+    void resetStats() { m_stats = Stats(); }
+
+private:
+    static const GLuint Unknown = ~0u;
+    static const int TextureUnits = 8;
+
+    struct Capability {
+        GLenum capability;
+        int enabled;  // -1 unknown
+    };
+
+    struct UniformValue {
+        unsigned char bytes[64];  // up to a mat4
+        std::size_t size = 0;
+    };
+
+    void bindTexture(GLuint* units, GLenum target, GLuint texture);
+
+    // True when `value` differs from `cached` (and stores it)
+    template <typename T>
+    bool changed(T& cached, const T& value) {
+        if (cached == value) {
+            m_stats.elided++;
+            return false;
+        }
+        cached = value;
+        m_stats.issued++;
+        return true;
+    }
+
+    GLuint m_program;
+    GLuint m_vertexArray;
+    GLuint m_arrayBuffer;
+    GLuint m_textureBuffer;
+    GLuint m_uniformBuffer;
+    GLenum m_activeTexture;
+    GLuint m_textures2D[TextureUnits];
+    GLuint m_bufferTextures[TextureUnits];
+    std::vector<Capability> m_capabilities;
+    GLenum m_blendSource, m_blendDestination;
+    float m_lineWidth;
+    float m_clearColor[4];
+    std::unordered_map<std::uint64_t, UniformValue> m_uniforms;  // program << 32 | location
+
+    Stats m_stats;
+};
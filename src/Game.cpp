@@ -1,20 +1,17 @@
 #include "Game.h"
 #include <GLFW/glfw3.h>
 #include <algorithm>
-#include <cmath>
-#include <cstdlib>
-#include <ctime>
-
-Game::Game(int width, int height)
-    : m_width(width), m_height(height),
-      m_ballPos(0, 0), m_ballVel(0, 0),
-      m_paddleLeftY(0), m_paddleRightY(0),
-      m_scoreLeft(0), m_scoreRight(0),
-      m_tableLength(20.0f), m_tableWidth(12.0f),
-      m_paddleHeight(2.5f), m_paddleDepth(0.5f),
-      m_ballRadius(0.4f) {
-    std::srand(static_cast<unsigned>(std::time(nullptr)));
-
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+Game::Game(int width, int height, std::uint64_t seed, ProgramCache* programCache)
+    : m_width(width),
+      m_height(height),
+      m_constructStart(std::chrono::steady_clock::now()),
+      m_renderer(m_gl, programCache),
+      m_hud(m_gl, width, height, programCache),
+      m_seed(seed) {
     m_view = glm::lookAt(
         glm::vec3(0.0f, 0.0f, 25.0f),
         glm::vec3(0.0f, 0.0f, 0.0f),
@@ -29,191 +26,415 @@ Game::Game(int width, int height)
     m_renderer.setView(m_view);
     m_renderer.setProjection(m_projection);
 
-    resetBall();
+    sim::resetMatch(m_state, m_seed, m_config);
+
+    m_tableLayer = m_renderer.createLayer();
+    buildTable();
+
+    m_scoreLine = m_hud.addLine(Hud::TopCenter, 0.0f, 24.0f, 8, glm::vec3(1.0f, 1.0f, 1.0f));
+    m_statsLine = m_hud.addLine(Hud::TopLeft, 12.0f, 12.0f, 2, glm::vec3(0.8f, 0.8f, 0.8f));
+    m_pauseLine = m_hud.addLine(Hud::TopCenter, 0.0f, 120.0f, 6, glm::vec3(1.0f, 0.9f, 0.3f));
+
+    const Shader* programs[] = {&m_renderer.program(), &m_hud.program()};
+    for (const Shader* program : programs) {
+        m_startupTimes.shadersMs += program->buildMs;
+        m_startupTimes.programs++;
+        if (program->cached) m_startupTimes.cachedPrograms++;
+    }
+    double totalMs =
+        std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - m_constructStart).count();
+    m_startupTimes.buffersMs = totalMs - m_startupTimes.shadersMs;
+}
+
+Game::~Game() {
+    if (m_simThread) {
+        m_simThread->stop();
+        m_state = m_simThread->finalState();
+    }
+    m_recorder.close(m_state);
+    if (m_telemetry.isOpen()) {
+        m_telemetry.close();
+        if (!m_telemetry.writeError().empty())
+            std::cerr << "Telemetry: " << m_telemetry.writeError() << "\n";
+        if (m_telemetry.dropped() > 0)
+            std::cerr << "Telemetry: " << m_telemetry.dropped() << " of " << m_telemetry.recorded()
+                      << " ticks dropped (writer fell behind)\n";
+    }
 }
 
-Game::~Game() = default;
+bool Game::startRecording(const std::string& path) {
+    return m_recorder.open(path, m_seed, m_config);
+}
 
-void Game::resetBall() {
-    m_ballPos = glm::vec2(0.0f, 0.0f);
-    m_ballVel.x = (std::rand() % 2 == 0 ? 1.0f : -1.0f) * 10.0f;
-    m_ballVel.y = ((std::rand() % 100) / 50.0f - 1.0f) * 5.0f;
+bool Game::startTelemetry(const std::string& path) {
+    std::string error;
+    if (!m_telemetry.open(path, error)) {
+        std::cerr << "Telemetry: " << error << "\n";
+        return false;
+    }
+    return true;
 }
 
-void Game::processInput(GLFWwindow* window, float deltaTime) {
-    const float paddleSpeed = 14.0f;
+void Game::setProfiler(Profiler& profiler, int framePhase, std::vector<int> overlayPhases) {
+    m_profiler = &profiler;
+    m_iterationsPhase = profiler.addPhase("integrator_iterations", Profiler::Counter);
+    m_simTickPhase = profiler.addPhase("sim_tick", Profiler::Duration, 2);
+    m_latencyPhase = profiler.addPhase("input_to_present");
+    m_glIssuedPhase = profiler.addPhase("gl_state_issued", Profiler::Counter);
+    m_glElidedPhase = profiler.addPhase("gl_state_elided", Profiler::Counter);
+
+    // Software rasterizers finish the whole frame inside glEndQuery: timing
+    // them reports ~0 GPU time and moves raster cost from swap into render
+    const char* gl = reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+    bool software = gl && (std::strstr(gl, "llvmpipe") || std::strstr(gl, "softpipe") || std::strstr(gl, "SwiftShader"));
+    if (!software)
+        m_gpuTimer.reset(new GpuTimer(profiler, profiler.addPhase("gpu_render", Profiler::Duration, 1)));
+    m_overlay = ProfilerOverlay(framePhase, std::move(overlayPhases));
+}
 
-    if (glfwGetKey(window, GLFW_KEY_W) == GLFW_PRESS)
-        m_paddleLeftY += paddleSpeed * deltaTime;
-    if (glfwGetKey(window, GLFW_KEY_S) == GLFW_PRESS)
-        m_paddleLeftY -= paddleSpeed * deltaTime;
+void Game::onKey(int key, int action) {
+    if (action == GLFW_REPEAT) return;
+    bool pressed = action == GLFW_PRESS;
 
-    if (glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
+    if (key == GLFW_KEY_ESCAPE && pressed)
         m_shouldClose = true;
+    if (key == GLFW_KEY_P && pressed)
+        setPaused(!m_paused);
+    if (key == GLFW_KEY_F3 && pressed && m_profiler) {
+        m_showOverlay = !m_showOverlay;
+        m_needsRedraw = true;
+    }
+    if (key != GLFW_KEY_W && key != GLFW_KEY_S)
+        return;
+
+    (key == GLFW_KEY_W ? m_keyUp : m_keyDown) = pressed;
+    float axis = (m_keyUp ? 1.0f : 0.0f) - (m_keyDown ? 1.0f : 0.0f);
+    if (axis == m_inputs.leftAxis)
+        return;
+    m_inputs.leftAxis = axis;
+
+    // Changes made while paused are not timed: they wait for the resume
+    std::int64_t now = sim::steadyNowNs();
+    if (m_pendingInputNs == 0 && !m_paused) m_pendingInputNs = now;
+    if (m_simThread) {
+        m_unsentInputs.push_back({m_inputs, now});
+        sendInputs();
+    }
+}
 
-    float limit = (m_tableWidth - m_paddleHeight) / 2.0f;
-    m_paddleLeftY = std::clamp(m_paddleLeftY, -limit, limit);
-    m_paddleRightY = std::clamp(m_paddleRightY, -limit, limit);
+void Game::sendInputs() {
+    std::size_t sent = 0;
+    while (sent < m_unsentInputs.size() &&
+           m_simThread->pushInputs(m_unsentInputs[sent].inputs, m_unsentInputs[sent].timeNs))
+        ++sent;
+    m_unsentInputs.erase(m_unsentInputs.begin(), m_unsentInputs.begin() + sent);
 }
 
-void Game::updateAIPaddle(float deltaTime) {
-    const float aiSpeed = 11.0f;
-    const float mistakeRange = 2.5f;
-    const float mistakeChangeInterval = 0.35f;
-    float limit = (m_tableWidth - m_paddleHeight) / 2.0f;
+void Game::runSimulationThread(double tickRate) {
+    m_simThread.reset(new sim::SimThread(m_config, m_state, tickRate));
+    m_simThread->pushInputs(m_inputs, 0);
+    if (m_recorder.isOpen()) m_simThread->setRecorder(&m_recorder);
+    if (m_telemetry.isOpen()) m_simThread->setTelemetry(&m_telemetry);
+    if (m_profiler) m_simThread->setProfiler(m_profiler, m_simTickPhase, m_iterationsPhase);
+    m_simThread->start();
+}
 
-    if (m_ballVel.x > 0) {
-        m_aiMistakeTimer += deltaTime;
-        if (m_aiMistakeTimer >= mistakeChangeInterval) {
-            m_aiMistakeTimer = 0.0f;
-            m_aiTargetOffset = (std::rand() / (float)RAND_MAX - 0.5f) * 2.0f * mistakeRange;
-        }
+void Game::startMatch(std::uint64_t seed, const sim::MatchConfig& config) {
+    m_seed = seed;
+    m_config = config;
+    m_staticStep = sim::findStaticStep(m_config);
+    sim::resetMatch(m_state, m_seed, m_config);
+    buildTable();
+}
 
-        float targetY = m_ballPos.y + m_aiTargetOffset;
-        targetY = std::clamp(targetY, -limit - 1.0f, limit + 1.0f);
+bool Game::setPaused(bool paused) {
+    if (m_net || m_spectator) return false;
+    if (paused == m_paused) return true;
+    m_paused = paused;
+    m_needsRedraw = true;
+    if (m_simThread) m_simThread->setPaused(paused);
+    m_hud.setText(m_pauseLine, paused ? "PAUSED" : "");
+    return true;
+}
+
+void Game::startNetMatch(std::unique_ptr<sim::NetSession> session) {
+    m_net = std::move(session);
+    m_netAccumulator = 0.0f;
+    m_hud.setText(m_scoreLine, "WAITING FOR PEER");
+}
+
+void Game::startSpectating(std::unique_ptr<sim::SpectatorClient> client) {
+    m_spectator = std::move(client);
+    m_hud.setText(m_scoreLine, "CONNECTING");
+}
 
-        float diff = targetY - m_paddleRightY;
-        if (std::abs(diff) > 0.15f) {
-            float move = std::copysign(std::min(aiSpeed * deltaTime, std::abs(diff)), diff);
-            m_paddleRightY = std::clamp(m_paddleRightY + move, -limit, limit);
+void Game::startMultiBall(std::unique_ptr<sim::MultiBall> balls, unsigned threads) {
+    m_balls = std::move(balls);
+    if (threads != 1) {
+        m_ballPool.reset(new WorkStealingPool(threads));
+        m_balls->setPool(m_ballPool.get());
+    }
+}
+
+// Fixed 60 Hz ticks; a frame runs at most a few, so a slow tick drops
+// simulated time instead of snowballing
+void Game::updateMultiBall(float deltaTime) {
+    const float dt = 1.0f / 60.0f;
+    m_ballAccumulator = std::min(m_ballAccumulator + deltaTime, 4.0f * dt);
+    while (m_ballAccumulator >= dt) {
+        bool timed = m_profiler && m_profiler->enabled();
+        std::uint64_t start = timed ? m_profiler->now() : 0;
+        m_balls->step(m_inputs, dt);
+        if (timed) m_profiler->record(m_simTickPhase, start, m_profiler->now() - start);
+        m_ballAccumulator -= dt;
+        if (m_pendingInputNs) {
+            m_frameInputNs = m_pendingInputNs;
+            m_pendingInputNs = 0;
         }
     }
+    m_state.paddleLeftY = m_balls->paddleLeftY;
+    m_state.paddleRightY = m_balls->paddleRightY;
+    m_state.scoreLeft = m_balls->scoreLeft;
+    m_state.scoreRight = m_balls->scoreRight;
+
+    updateHud(deltaTime);
 }
 
-void Game::update(float deltaTime) {
-    deltaTime = std::min(deltaTime, 0.05f);
-
-    float halfLen = m_tableLength / 2.0f;
-    float halfWidth = m_tableWidth / 2.0f;
-    float paddleHalfH = m_paddleHeight / 2.0f;
-
-    // Paddle collision bounds: paddle mesh X [-10,-9.5] left, [9.5,10] right. Extend toward center to prevent tunneling.
-    const float pad = m_ballRadius * 1.2f;
-    const float leftPaddleMinX = -halfLen;
-    const float leftPaddleMaxX = -halfLen + m_paddleDepth + pad;
-    const float rightPaddleMinX = halfLen - m_paddleDepth - pad;
-    const float rightPaddleMaxX = halfLen;
-
-    const float fixedDt = 1.0f / 600.0f;
-    float accumulated = deltaTime;
-    int steps = 0;
-    const int maxSteps = 160;
-
-    while (accumulated >= fixedDt && steps < maxSteps) {
-        steps++;
-        accumulated -= fixedDt;
-
-        glm::vec2 prevPos = m_ballPos;
-        m_ballPos += m_ballVel * fixedDt;
-
-        // Walls
-        if (m_ballPos.y + m_ballRadius > halfWidth) {
-            m_ballPos.y = halfWidth - m_ballRadius;
-            m_ballVel.y = -std::abs(m_ballVel.y);
+void Game::updateNet(float deltaTime) {
+    std::int64_t now = sim::steadyNowNs();
+    m_net->poll(now);
+    if (!m_net->connected()) {
+        updateHud(deltaTime);
+        return;
+    }
+
+    // Fixed ticks out of variable frames. A stalled session (peer too far
+    // behind) keeps at most one tick banked instead of bursting later.
+    const float dt = m_net->tickDt();
+    std::int8_t axis = sim::encodeFrame(m_inputs, dt).leftAxis;
+    m_netAccumulator = std::min(m_netAccumulator + deltaTime, 8.0f * dt);
+    while (m_netAccumulator >= dt) {
+        if (!m_net->advance(axis, now)) {
+            m_netAccumulator = std::min(m_netAccumulator, dt);
+            break;
         }
-        if (m_ballPos.y - m_ballRadius < -halfWidth) {
-            m_ballPos.y = -halfWidth + m_ballRadius;
-            m_ballVel.y = std::abs(m_ballVel.y);
+        m_netAccumulator -= dt;
+        if (m_pendingInputNs) {
+            m_frameInputNs = m_pendingInputNs;
+            m_pendingInputNs = 0;
         }
+    }
+    m_net->rollback()->reconcile();
+    m_state = m_net->rollback()->state();
 
-        float leftPaddleMinY = m_paddleLeftY - paddleHalfH;
-        float leftPaddleMaxY = m_paddleLeftY + paddleHalfH;
-        float rightPaddleMinY = m_paddleRightY - paddleHalfH;
-        float rightPaddleMaxY = m_paddleRightY + paddleHalfH;
-
-        // Swept AABB: ball's path from prevPos to m_ballPos
-        float bMinX = std::min(prevPos.x, m_ballPos.x) - m_ballRadius;
-        float bMaxX = std::max(prevPos.x, m_ballPos.x) + m_ballRadius;
-        float bMinY = std::min(prevPos.y, m_ballPos.y) - m_ballRadius;
-        float bMaxY = std::max(prevPos.y, m_ballPos.y) + m_ballRadius;
-
-        const float speedBoost = 1.08f;
-        const float maxSpeed = 28.0f;
-
-        // Left paddle
-        const float leftPaddleFaceX = -halfLen + m_paddleDepth;
-        if (m_ballVel.x < 0 &&
-            bMinX < leftPaddleMaxX && bMaxX > leftPaddleMinX &&
-            bMinY < leftPaddleMaxY && bMaxY > leftPaddleMinY) {
-            m_ballPos.x = leftPaddleFaceX + m_ballRadius + 0.01f;
-            float newSpeed = std::min(std::sqrt(m_ballVel.x * m_ballVel.x + m_ballVel.y * m_ballVel.y) * speedBoost, maxSpeed);
-            float scale = newSpeed / std::sqrt(m_ballVel.x * m_ballVel.x + m_ballVel.y * m_ballVel.y);
-            m_ballVel.x = std::abs(m_ballVel.x) * scale;
-            m_ballVel.y *= scale;
-        }
+    updateHud(deltaTime);
+}
 
-        // Right paddle
-        const float rightPaddleFaceX = halfLen - m_paddleDepth;
-        if (m_ballVel.x > 0 &&
-            bMinX < rightPaddleMaxX && bMaxX > rightPaddleMinX &&
-            bMinY < rightPaddleMaxY && bMaxY > rightPaddleMinY) {
-            m_ballPos.x = rightPaddleFaceX - m_ballRadius - 0.01f;
-            float newSpeed = std::min(std::sqrt(m_ballVel.x * m_ballVel.x + m_ballVel.y * m_ballVel.y) * speedBoost, maxSpeed);
-            float scale = newSpeed / std::sqrt(m_ballVel.x * m_ballVel.x + m_ballVel.y * m_ballVel.y);
-            m_ballVel.x = -std::abs(m_ballVel.x) * scale;
-            m_ballVel.y *= scale;
+void Game::update(float deltaTime) {
+    if (m_net) {
+        updateNet(deltaTime);
+        return;
+    }
+    if (m_spectator) {
+        std::int64_t now = sim::steadyNowNs();
+        m_spectator->poll(now);
+        if (m_spectator->hasState()) m_state = m_spectator->sample(now);
+        updateHud(deltaTime);
+        return;
+    }
+    // Paused: m_state keeps what is on screen. Key changes still reach the
+    // sim thread, stamped before its next tick after the resume.
+    if (m_paused) {
+        if (m_simThread && !m_unsentInputs.empty()) sendInputs();
+        return;
+    }
+    if (m_balls) {
+        updateMultiBall(deltaTime);
+        return;
+    }
+    if (!m_simThread) {
+        // Step with exactly what the log stores so a replay reproduces this run
+        applyFrame(sim::encodeFrame(m_inputs, deltaTime));
+        if (m_pendingInputNs) {
+            m_frameInputNs = m_pendingInputNs;
+            m_pendingInputNs = 0;
         }
+        return;
     }
 
-    // Score
-    if (m_ballPos.x < -halfLen) {
-        m_scoreRight++;
-        resetBall();
+    if (!m_unsentInputs.empty()) sendInputs();
+    m_simThread->update();
+
+    // Draw one tick behind the simulation: blend from the previous tick
+    // towards the newest as time passes since it was produced
+    const sim::SimSnapshot& snapshot = m_simThread->latest();
+    std::int64_t now = sim::steadyNowNs();
+    if (m_pendingInputNs && !m_lateLatch && snapshot.tickTimeNs >= m_pendingInputNs) {
+        m_frameInputNs = m_pendingInputNs;
+        m_pendingInputNs = 0;
     }
-    if (m_ballPos.x > halfLen) {
-        m_scoreLeft++;
-        resetBall();
+    float alpha = static_cast<float>(now - snapshot.tickTimeNs) * 1e-9f / m_simThread->tickDt();
+    m_state = sim::interpolate(snapshot.previous, snapshot.current, std::min(std::max(alpha, 0.0f), 1.0f));
+
+    updateHud(deltaTime);
+}
+
+void Game::applyFrame(const sim::InputFrame& frame) {
+    m_recorder.record(frame);
+    sim::StepStats stats;
+    unsigned events;
+    if (m_staticStep)
+        events = m_staticStep(m_state, sim::decodeInputs(frame), frame.dt, &stats);
+    else
+        events = sim::step(m_state, m_config, sim::decodeInputs(frame), frame.dt, &stats);
+    if (m_profiler) m_profiler->count(m_iterationsPhase, static_cast<std::uint64_t>(stats.iterations));
+    if (m_telemetry.isOpen()) m_telemetry.record(m_state, frame.dt, events);
+
+    updateHud(frame.dt);
+}
+
+void Game::updateHud(float deltaTime) {
+    // The score line shows connection status until a remote match arrives
+    bool waiting = (m_net && !m_net->connected()) || (m_spectator && !m_spectator->hasState());
+    if (!waiting && (m_state.scoreLeft != m_shownScoreLeft || m_state.scoreRight != m_shownScoreRight)) {
+        m_shownScoreLeft = m_state.scoreLeft;
+        m_shownScoreRight = m_state.scoreRight;
+        m_hud.setText(m_scoreLine, std::to_string(m_shownScoreLeft) + " : " + std::to_string(m_shownScoreRight));
     }
 
-    updateAIPaddle(deltaTime);
+    // Frame stats refresh twice a second
+    m_statFrames++;
+    m_statTime += deltaTime;
+    m_statMaxDt = std::max(m_statMaxDt, deltaTime);
+    if (m_statTime >= 0.5f) {
+        char text[96];
+        int n = std::snprintf(text, sizeof(text), "FPS %.0f  AVG %.1f MS  MAX %.1f MS", m_statFrames / m_statTime,
+                              m_statTime * 1000.0f / m_statFrames, m_statMaxDt * 1000.0f);
+        if (m_latencyCount > 0)
+            std::snprintf(text + n, sizeof(text) - n, "  LAT %.1f MS", m_latencySum / m_latencyCount);
+        m_hud.setText(m_statsLine, text);
+        m_statFrames = 0;
+        m_statTime = 0.0f;
+        m_statMaxDt = 0.0f;
+        m_latencySum = 0.0;
+        m_latencyCount = 0;
+    }
 }
 
-void Game::render() {
-    m_renderer.clear();
+// Table and border never move: baked once into a retained layer
+void Game::buildTable() {
+    m_renderer.beginLayer(m_tableLayer);
 
     glm::mat4 tableModel = glm::scale(
         glm::translate(glm::mat4(1.0f), glm::vec3(0, 0, -0.1f)),
-        glm::vec3(m_tableLength, m_tableWidth, 0.2f)
+        glm::vec3(m_config.tableLength, m_config.tableWidth, 0.2f)
     );
     m_renderer.drawCube(tableModel, glm::vec3(0.2f, 0.6f, 0.2f));
 
     float borderH = 0.05f;
     glm::mat4 borderModel = glm::scale(
         glm::translate(glm::mat4(1.0f), glm::vec3(0, 0, borderH / 2)),
-        glm::vec3(m_tableLength + 0.5f, m_tableWidth + 0.5f, borderH)
+        glm::vec3(m_config.tableLength + 0.5f, m_config.tableWidth + 0.5f, borderH)
     );
     m_renderer.drawCube(borderModel, glm::vec3(0.25f, 0.2f, 0.15f));
 
-    // Paddles and debug: use exact collider bounds (same formula as update())
-    float halfLenR = m_tableLength / 2.0f;
-    float paddleHalfH = m_paddleHeight / 2.0f;
-    float pad = m_ballRadius * 1.2f;
+    m_renderer.endLayer();
+}
+
+// Paddles and debug: use exact collider bounds (same formula as update())
+void Game::drawPaddles() {
+    float leftY = m_state.paddleLeftY;
+    float rightY = m_state.paddleRightY;
+
+    // Late latch: the newest tick moved on by the input held right now
+    if (m_simThread && m_lateLatch && !m_paused) {
+        m_simThread->update();
+        const sim::SimSnapshot& snapshot = m_simThread->latest();
+        std::int64_t now = sim::steadyNowNs();
+        float ahead = static_cast<float>(now - snapshot.tickTimeNs) * 1e-9f;
+        ahead = std::min(std::max(ahead, 0.0f), m_simThread->tickDt());
+        float limit = (m_config.tableWidth - m_config.paddleHeight) / 2.0f;
+        if (!m_inputs.leftAI) {
+            leftY = snapshot.current.paddleLeftY + m_inputs.leftAxis * m_config.paddleSpeed * ahead;
+            leftY = std::clamp(leftY, -limit, limit);
+        }
+        if (m_pendingInputNs) {
+            m_frameInputNs = m_pendingInputNs;
+            m_pendingInputNs = 0;
+        }
+    }
+
+    float halfLenR = m_config.tableLength / 2.0f;
+    float paddleHalfH = m_config.paddleHeight / 2.0f;
+    float pad = m_config.ballRadius * 1.2f;
 
     float leftMinX = -halfLenR;
-    float leftMaxX = -halfLenR + m_paddleDepth + pad;
-    float leftMinY = m_paddleLeftY - paddleHalfH;
-    float leftMaxY = m_paddleLeftY + paddleHalfH;
+    float leftMaxX = -halfLenR + m_config.paddleDepth + pad;
+    float leftMinY = leftY - paddleHalfH;
+    float leftMaxY = leftY + paddleHalfH;
 
-    float rightMinX = halfLenR - m_paddleDepth - pad;
+    float rightMinX = halfLenR - m_config.paddleDepth - pad;
     float rightMaxX = halfLenR;
-    float rightMinY = m_paddleRightY - paddleHalfH;
-    float rightMaxY = m_paddleRightY + paddleHalfH;
+    float rightMinY = rightY - paddleHalfH;
+    float rightMaxY = rightY + paddleHalfH;
 
     m_renderer.drawRectFilled(leftMinX, leftMinY, leftMaxX, leftMaxY, 0.0f, glm::vec3(1.0f, 0.2f, 0.2f));
     m_renderer.drawRectFilled(rightMinX, rightMinY, rightMaxX, rightMaxY, 0.0f, glm::vec3(0.2f, 0.2f, 1.0f));
 
-    glm::vec3 ballPosRaised(m_ballPos.x, m_ballPos.y, 0.15f);
-    glm::mat4 ballModel = glm::translate(
-        glm::scale(glm::mat4(1.0f), glm::vec3(m_ballRadius * 2.5f)),
-        ballPosRaised
-    );
-    m_renderer.drawCube(ballModel, glm::vec3(1.0f, 1.0f, 0.0f));
-
     glm::vec3 debugColor(1.0f, 0.0f, 1.0f);
     m_renderer.drawRectFilled(leftMinX, leftMinY, leftMaxX, leftMaxY, 0.2f, debugColor);
     m_renderer.drawRectFilled(rightMinX, rightMinY, rightMaxX, rightMaxY, 0.2f, debugColor);
+}
+
+void Game::render() {
+    m_needsRedraw = false;
+    m_gl.resetStats();
+    if (m_gpuTimer) m_gpuTimer->begin();
+    m_renderer.clear();
+
+    if (m_balls) {
+        m_renderer.drawCubes(m_balls->x.data(), m_balls->y.data(), m_balls->size(), 0.15f,
+                             m_balls->radius() * 2.5f, glm::vec3(1.0f, 1.0f, 0.0f));
+    } else {
+        glm::vec3 ballPosRaised(m_state.ballX, m_state.ballY, 0.15f);
+        glm::mat4 ballModel = glm::translate(
+            glm::scale(glm::mat4(1.0f), glm::vec3(m_config.ballRadius * 2.5f)),
+            ballPosRaised
+        );
+        m_renderer.drawCube(ballModel, glm::vec3(1.0f, 1.0f, 0.0f));
+    }
 
-    m_renderer.drawScore(m_scoreLeft, m_scoreRight, 1.0f, glm::vec3(1.0f, 1.0f, 1.0f));
+    if (m_showOverlay && m_profiler) {
+        float aspect = (float)m_width / (float)m_height;
+        float viewHeight = 14.0f;
+        m_overlay.draw(m_renderer, *m_profiler, -aspect * viewHeight + 0.6f, -viewHeight + 0.6f);
+    }
+
+    // Last, so the paddles see the freshest input before the batch goes out
+    drawPaddles();
+    m_renderer.flush();
+    m_hud.draw();
+
+    if (m_gpuTimer) {
+        m_gpuTimer->end();
+        m_gpuTimer->collect();
+    }
+    if (m_profiler) {
+        m_profiler->count(m_glIssuedPhase, m_gl.stats().issued);
+        m_profiler->count(m_glElidedPhase, m_gl.stats().elided);
+    }
+}
+
+void Game::framePresented() {
+    if (!m_frameInputNs) return;
+    std::int64_t latency = sim::steadyNowNs() - m_frameInputNs;
+    m_frameInputNs = 0;
+    m_latencySum += latency * 1e-6;
+    m_latencyCount++;
+    if (m_profiler) {
+        std::uint64_t now = m_profiler->now();
+        m_profiler->record(m_latencyPhase, now - static_cast<std::uint64_t>(latency), static_cast<std::uint64_t>(latency));
+    }
 }
 
 void Game::resize(int width, int height) {
@@ -225,4 +446,6 @@ void Game::resize(int width, int height) {
     float viewHeight = 14.0f;
     m_projection = glm::ortho(-aspect * viewHeight, aspect * viewHeight, -viewHeight, viewHeight, 0.1f, 100.0f);
     m_renderer.setProjection(m_projection);
+    m_hud.resize(width, height);
+    m_needsRedraw = true;
 }
@@ -1,52 +1,190 @@
 #pragma once
 
 #include "Renderer.h"
+#include "GLState.h"
+#include "GpuTimer.h"
+#include "Hud.h"
+#include "InputLog.h"
+#include "MultiBall.h"
+#include "NetSession.h"
+#include "Profiler.h"
+#include "ProfilerOverlay.h"
+#include "SimThread.h"
+#include "SpectatorClient.h"
+#include "Simulation.h"
+#include "Telemetry.h"
+#include "WorkStealingPool.h"
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
-
-struct GLFWwindow;
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
 
 class Game {
 public:
-    Game(int width, int height);
+    // Where construction went, for the startup breakdown
+    struct StartupTimes {
+        double shadersMs = 0.0;  // embedded source look-up, compile and link or binary load
+        double buffersMs = 0.0;  // the rest: meshes, buffers, font atlas, table layer
+        int programs = 0;
+        int cachedPrograms = 0;  // of `programs`, loaded as driver binaries
+    };
+
+    // With `programCache`, shader programs are loaded from and stored to it
+    Game(int width, int height, std::uint64_t seed, ProgramCache* programCache = nullptr);
     ~Game();
 
-    void processInput(GLFWwindow* window, float deltaTime);
+    const StartupTimes& startupTimes() const { return m_startupTimes; }
+
+    // Log every tick's inputs so the session can be replayed by cpong_headless.
+    bool startRecording(const std::string& path);
+    // Write every tick's state and events to a telemetry file (cpong_telemetry
+    // queries it). Local single-ball matches; call before runSimulationThread().
+    bool startTelemetry(const std::string& path);
+
+    // Adds integrator iteration counts, GL state calls issued/elided per
+    // frame and GPU render time to `profiler`.
+    // The overlay (F3) graphs `framePhase` and stacks `overlayPhases`.
+    void setProfiler(Profiler& profiler, int framePhase, std::vector<int> overlayPhases);
+    void setOverlayVisible(bool visible) { m_showOverlay = visible; }
+
+    // Moves the simulation to its own thread ticking at `tickRate` Hz; update()
+    // then only hands over inputs and interpolates the latest two ticks.
+    // Call after startRecording() and setProfiler().
+    void runSimulationThread(double tickRate);
+
+    // Two-player match over the network: W/S move this peer's paddle (left
+    // on the host, right on the client), ticks run at the session's rate and
+    // update() polls, advances and shows the rolled-back state.
+    void startNetMatch(std::unique_ptr<sim::NetSession> session);
+
+    // Watch a broadcast match instead of playing; keys other than F3/Esc do nothing
+    void startSpectating(std::unique_ptr<sim::SpectatorClient> client);
+
+    // Stress mode: `balls` replace the single ball, ticking at 60 Hz on
+    // `threads` threads (0 = all cores). Lockstep mode only; not recorded.
+    void startMultiBall(std::unique_ptr<sim::MultiBall> balls, unsigned threads);
+
+    // Restarts with another seed and config, e.g. to play back an input log.
+    // Lockstep mode only.
+    void startMatch(std::uint64_t seed, const sim::MatchConfig& config);
+
+    // Freezes a local match: update() then moves nothing (the sim thread
+    // sleeps) and render() draws the same frame with PAUSED on it. Network
+    // and spectator matches run on and ignore it; returns false there.
+    bool setPaused(bool paused);
+    bool paused() const { return m_paused; }
+
+    // While paused only: true after something visible changed (pause text,
+    // resize, overlay, requestRedraw()) until the next render()
+    bool needsRedraw() const { return !m_paused || m_needsRedraw; }
+    void requestRedraw() { m_needsRedraw = true; }
+
+    // Key callback: W/S move the left paddle, P pauses, F3 toggles the overlay, Esc quits.
+    // Each change is timestamped and reaches the simulation on its own tick.
+    void onKey(int key, int action);
     void update(float deltaTime);
+    // One tick (lockstep mode) with explicit inputs instead of the keyboard (replays, offscreen renders)
+    void applyFrame(const sim::InputFrame& frame);
     void render();
+    // Call right after the swap: closes input-to-present latency samples
+    void framePresented();
     void resize(int width, int height);
 
+    // Draw the player's paddle from the newest tick plus the live input at
+    // the last moment before submit, instead of one interpolated tick behind
+    void setLateLatch(bool enabled) { m_lateLatch = enabled; }
+
     bool shouldClose() const { return m_shouldClose; }
     void setShouldClose(bool value) { m_shouldClose = value; }
 
-    int scoreLeft() const { return m_scoreLeft; }
-    int scoreRight() const { return m_scoreRight; }
+    // State-cache counters of the last render()
+    const GLState::Stats& glStats() const { return m_gl.stats(); }
+
+    int scoreLeft() const { return m_state.scoreLeft; }
+    int scoreRight() const { return m_state.scoreRight; }
 
 private:
+    void buildTable();
+    void updateHud(float deltaTime);
+    void drawPaddles();
+    void sendInputs();
+    void updateNet(float deltaTime);
+    void updateMultiBall(float deltaTime);
+
     int m_width, m_height;
     bool m_shouldClose = false;
+    std::chrono::steady_clock::time_point m_constructStart;  // before the members below
+    StartupTimes m_startupTimes;
 
+    // Declared first: the renderer and HUD route their GL state through it
+    GLState m_gl;
     Renderer m_renderer;
     glm::mat4 m_view;
     glm::mat4 m_projection;
 
-    // Ball - manual physics (no Box2D for reliable paddle collision)
-    glm::vec2 m_ballPos;
-    glm::vec2 m_ballVel;
-
-    // Paddle positions
-    float m_paddleLeftY;
-    float m_paddleRightY;
-    int m_scoreLeft;
-    int m_scoreRight;
-    float m_tableLength;
-    float m_tableWidth;
-    float m_paddleHeight;
-    float m_paddleDepth;
-    float m_ballRadius;
-    float m_aiTargetOffset = 0.0f;
-    float m_aiMistakeTimer = 0.0f;
-
-    void resetBall();
-    void updateAIPaddle(float deltaTime);
+    unsigned int m_tableLayer;  // retained, built once
+
+    // Score and frame stats; HUD text is only re-laid out when it changes
+    Hud m_hud;
+    int m_scoreLine;
+    int m_statsLine;
+    int m_pauseLine;
+    int m_shownScoreLeft = -1;
+    int m_shownScoreRight = -1;
+    int m_statFrames = 0;
+    float m_statTime = 0.0f;
+    float m_statMaxDt = 0.0f;
+
+    // Ball, paddles and scores - stepped by the GL-free simulation, either
+    // here in lockstep with frames or on m_simThread. With the thread,
+    // m_state is only the interpolated copy being drawn.
+    sim::MatchConfig m_config;
+    sim::StaticStep m_staticStep = sim::findStaticStep(m_config);  // predefined tables only
+    sim::MatchState m_state;
+    std::unique_ptr<sim::SimThread> m_simThread;
+    bool m_keyUp = false, m_keyDown = false;
+    bool m_lateLatch = true;
+    bool m_paused = false;
+    bool m_needsRedraw = false;
+
+    // Network play: frame time not yet spent on ticks
+    std::unique_ptr<sim::NetSession> m_net;
+    float m_netAccumulator = 0.0f;
+    std::unique_ptr<sim::SpectatorClient> m_spectator;
+
+    // Multi-ball mode; m_state then only carries its paddles and score
+    std::unique_ptr<sim::MultiBall> m_balls;
+    std::unique_ptr<WorkStealingPool> m_ballPool;
+    float m_ballAccumulator = 0.0f;
+
+    // Input changes the sim thread's queue had no room for yet
+    struct PendingInput {
+        sim::MatchInputs inputs;
+        std::int64_t timeNs;
+    };
+    std::vector<PendingInput> m_unsentInputs;
+
+    // Input-to-present latency: the oldest key event not yet on screen, and
+    // the one carried by the frame being presented
+    std::int64_t m_pendingInputNs = 0;
+    std::int64_t m_frameInputNs = 0;
+    double m_latencySum = 0.0;
+    int m_latencyCount = 0;
+    sim::MatchInputs m_inputs;
+    std::uint64_t m_seed;
+    sim::InputRecorder m_recorder;
+    sim::TelemetryRecorder m_telemetry;
+
+    Profiler* m_profiler = nullptr;
+    int m_iterationsPhase = -1;
+    int m_simTickPhase = -1;
+    int m_glIssuedPhase = -1;
+    int m_glElidedPhase = -1;
+    int m_latencyPhase = -1;
+    std::unique_ptr<GpuTimer> m_gpuTimer;
+    ProfilerOverlay m_overlay;
+    bool m_showOverlay = false;
 };
@@ -0,0 +1,39 @@
+#include "GpuTimer.h"
+
+GpuTimer::GpuTimer(Profiler& profiler, int phase) : m_profiler(profiler), m_phase(phase) {
+    glGenQueries(QueryCount, m_queries);
+}
+
+GpuTimer::~GpuTimer() {
+    glDeleteQueries(QueryCount, m_queries);
+}
+
+void GpuTimer::begin() {
+    // All queries in flight: skip this frame rather than wait on the GPU
+    if (!m_profiler.enabled() || m_pending == QueryCount) return;
+    unsigned slot = m_next % QueryCount;
+    m_issuedAt[slot] = m_profiler.now();
+    glBeginQuery(GL_TIME_ELAPSED, m_queries[slot]);
+    m_active = true;
+}
+
+void GpuTimer::end() {
+    if (!m_active) return;
+    glEndQuery(GL_TIME_ELAPSED);
+    m_active = false;
+    m_next++;
+    m_pending++;
+}
+
+void GpuTimer::collect() {
+    while (m_pending > 0) {
+        unsigned slot = (m_next - m_pending) % QueryCount;
+        GLint available = 0;
+        glGetQueryObjectiv(m_queries[slot], GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) return;
+        GLuint64 elapsed = 0;
+        glGetQueryObjectui64v(m_queries[slot], GL_QUERY_RESULT, &elapsed);
+        m_profiler.record(m_phase, m_issuedAt[slot], elapsed);
+        m_pending--;
+    }
+}
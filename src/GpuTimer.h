@@ -0,0 +1,33 @@
+#pragma once
+
+#include "Profiler.h"
+#include <glad/glad.h>
+#include <cstdint>
+
+// GL_TIME_ELAPSED queries around a block of GL work. Results are read a few
+// frames later, without stalling, and recorded into a profiler phase stamped
+// with the CPU time the block was issued.
+class GpuTimer {
+public:
+    GpuTimer(Profiler& profiler, int phase);
+    ~GpuTimer();
+
+    GpuTimer(const GpuTimer&) = delete;
+    GpuTimer& operator=(const GpuTimer&) = delete;
+
+    void begin();
+    void end();
+    // Records every query whose result is ready. Call once per frame.
+    void collect();
+
+private:
+    static const int QueryCount = 4;
+
+    Profiler& m_profiler;
+    int m_phase;
+    GLuint m_queries[QueryCount] = {};
+    std::uint64_t m_issuedAt[QueryCount] = {};
+    unsigned m_next = 0;     // query the next begin() uses
+    unsigned m_pending = 0;  // issued, not yet collected
+    bool m_active = false;
+};
@@ -0,0 +1,217 @@
+#include "Hud.h"
+#include <cstddef>
+#include <cstdint>
+
+// 5x7 bitmap font, one byte per row (bit 4 = leftmost column), for ASCII
+// 32 (' ') through 96 ('`'). Lower case is drawn with the upper-case glyphs.
+static const std::uint8_t FontLow[][7] = {
+    {0b00000, 0b00000, 0b00000, 0b00000, 0b00000, 0b00000, 0b00000},  // ' '
+    {0b00100, 0b00100, 0b00100, 0b00100, 0b00100, 0b00000, 0b00100},  // !
+    {0b01010, 0b01010, 0b00000, 0b00000, 0b00000, 0b00000, 0b00000},  // "
+    {0b01010, 0b01010, 0b11111, 0b01010, 0b11111, 0b01010, 0b01010},  // #
+    {0b00100, 0b01111, 0b10100, 0b01110, 0b00101, 0b11110, 0b00100},  // $
+    {0b11000, 0b11001, 0b00010, 0b00100, 0b01000, 0b10011, 0b00011},  // %
+    {0b01100, 0b10010, 0b10100, 0b01000, 0b10101, 0b10010, 0b01101},  // &
+    {0b00100, 0b00100, 0b00000, 0b00000, 0b00000, 0b00000, 0b00000},  // '
+    {0b00010, 0b00100, 0b01000, 0b01000, 0b01000, 0b00100, 0b00010},  // (
+    {0b01000, 0b00100, 0b00010, 0b00010, 0b00010, 0b00100, 0b01000},  // )
+    {0b00000, 0b00100, 0b10101, 0b01110, 0b10101, 0b00100, 0b00000},  // *
+    {0b00000, 0b00100, 0b00100, 0b11111, 0b00100, 0b00100, 0b00000},  // +
+    {0b00000, 0b00000, 0b00000, 0b00000, 0b01100, 0b00100, 0b01000},  // ,
+    {0b00000, 0b00000, 0b00000, 0b11111, 0b00000, 0b00000, 0b00000},  // -
+    {0b00000, 0b00000, 0b00000, 0b00000, 0b00000, 0b01100, 0b01100},  // .
+    {0b00000, 0b00001, 0b00010, 0b00100, 0b01000, 0b10000, 0b00000},  // /
+    {0b01110, 0b10001, 0b10011, 0b10101, 0b11001, 0b10001, 0b01110},  // 0
+    {0b00100, 0b01100, 0b00100, 0b00100, 0b00100, 0b00100, 0b01110},  // 1
+    {0b01110, 0b10001, 0b00001, 0b00010, 0b00100, 0b01000, 0b11111},  // 2
+    {0b11111, 0b00010, 0b00100, 0b00010, 0b00001, 0b10001, 0b01110},  // 3
+    {0b00010, 0b00110, 0b01010, 0b10010, 0b11111, 0b00010, 0b00010},  // 4
+    {0b11111, 0b10000, 0b11110, 0b00001, 0b00001, 0b10001, 0b01110},  // 5
+    {0b00110, 0b01000, 0b10000, 0b11110, 0b10001, 0b10001, 0b01110},  // 6
+    {0b11111, 0b00001, 0b00010, 0b00100, 0b01000, 0b01000, 0b01000},  // 7
+    {0b01110, 0b10001, 0b10001, 0b01110, 0b10001, 0b10001, 0b01110},  // 8
+    {0b01110, 0b10001, 0b10001, 0b01111, 0b00001, 0b00010, 0b01100},  // 9
+    {0b00000, 0b01100, 0b01100, 0b00000, 0b01100, 0b01100, 0b00000},  // :
+    {0b00000, 0b01100, 0b01100, 0b00000, 0b01100, 0b00100, 0b01000},  // ;
+    {0b00010, 0b00100, 0b01000, 0b10000, 0b01000, 0b00100, 0b00010},  // <
+    {0b00000, 0b00000, 0b11111, 0b00000, 0b11111, 0b00000, 0b00000},  // =
+    {0b01000, 0b00100, 0b00010, 0b00001, 0b00010, 0b00100, 0b01000},  // >
+    {0b01110, 0b10001, 0b00001, 0b00010, 0b00100, 0b00000, 0b00100},  // ?
+    {0b01110, 0b10001, 0b00001, 0b01101, 0b10101, 0b10101, 0b01110},  // @
+    {0b01110, 0b10001, 0b10001, 0b10001, 0b11111, 0b10001, 0b10001},  // A
+    {0b11110, 0b10001, 0b10001, 0b11110, 0b10001, 0b10001, 0b11110},  // B
+    {0b01110, 0b10001, 0b10000, 0b10000, 0b10000, 0b10001, 0b01110},  // C
+    {0b11100, 0b10010, 0b10001, 0b10001, 0b10001, 0b10010, 0b11100},  // D
+    {0b11111, 0b10000, 0b10000, 0b11110, 0b10000, 0b10000, 0b11111},  // E
+    {0b11111, 0b10000, 0b10000, 0b11110, 0b10000, 0b10000, 0b10000},  // F
+    {0b01110, 0b10001, 0b10000, 0b10111, 0b10001, 0b10001, 0b01111},  // G
+    {0b10001, 0b10001, 0b10001, 0b11111, 0b10001, 0b10001, 0b10001},  // H
+    {0b01110, 0b00100, 0b00100, 0b00100, 0b00100, 0b00100, 0b01110},  // I
+    {0b00111, 0b00010, 0b00010, 0b00010, 0b00010, 0b10010, 0b01100},  // J
+    {0b10001, 0b10010, 0b10100, 0b11000, 0b10100, 0b10010, 0b10001},  // K
+    {0b10000, 0b10000, 0b10000, 0b10000, 0b10000, 0b10000, 0b11111},  // L
+    {0b10001, 0b11011, 0b10101, 0b10101, 0b10001, 0b10001, 0b10001},  // M
+    {0b10001, 0b10001, 0b11001, 0b10101, 0b10011, 0b10001, 0b10001},  // N
+    {0b01110, 0b10001, 0b10001, 0b10001, 0b10001, 0b10001, 0b01110},  // O
+    {0b11110, 0b10001, 0b10001, 0b11110, 0b10000, 0b10000, 0b10000},  // P
+    {0b01110, 0b10001, 0b10001, 0b10001, 0b10101, 0b10010, 0b01101},  // Q
+    {0b11110, 0b10001, 0b10001, 0b11110, 0b10100, 0b10010, 0b10001},  // R
+    {0b01111, 0b10000, 0b10000, 0b01110, 0b00001, 0b00001, 0b11110},  // S
+    {0b11111, 0b00100, 0b00100, 0b00100, 0b00100, 0b00100, 0b00100},  // T
+    {0b10001, 0b10001, 0b10001, 0b10001, 0b10001, 0b10001, 0b01110},  // U
+    {0b10001, 0b10001, 0b10001, 0b10001, 0b10001, 0b01010, 0b00100},  // V
+    {0b10001, 0b10001, 0b10001, 0b10101, 0b10101, 0b10101, 0b01010},  // W
+    {0b10001, 0b10001, 0b01010, 0b00100, 0b01010, 0b10001, 0b10001},  // X
+    {0b10001, 0b10001, 0b10001, 0b01010, 0b00100, 0b00100, 0b00100},  // Y
+    {0b11111, 0b00001, 0b00010, 0b00100, 0b01000, 0b10000, 0b11111},  // Z
+    {0b01110, 0b01000, 0b01000, 0b01000, 0b01000, 0b01000, 0b01110},  // [
+    {0b00000, 0b10000, 0b01000, 0b00100, 0b00010, 0b00001, 0b00000},  // backslash
+    {0b01110, 0b00010, 0b00010, 0b00010, 0b00010, 0b00010, 0b01110},  // ]
+    {0b00100, 0b01010, 0b10001, 0b00000, 0b00000, 0b00000, 0b00000},  // ^
+    {0b00000, 0b00000, 0b00000, 0b00000, 0b00000, 0b00000, 0b11111},  // _
+    {0b01000, 0b00100, 0b00000, 0b00000, 0b00000, 0b00000, 0b00000},  // `
+};
+
+// ASCII 123 ('{') through 126 ('~')
+static const std::uint8_t FontHigh[][7] = {
+    {0b00010, 0b00100, 0b00100, 0b01000, 0b00100, 0b00100, 0b00010},  // {
+    {0b00100, 0b00100, 0b00100, 0b00100, 0b00100, 0b00100, 0b00100},  // |
+    {0b01000, 0b00100, 0b00100, 0b00010, 0b00100, 0b00100, 0b01000},  // }
+    {0b00000, 0b00000, 0b01000, 0b10101, 0b00010, 0b00000, 0b00000},  // ~
+};
+
+static const int GlyphW = 5, GlyphH = 7;
+static const int CellW = 8, CellH = 8;    // one empty texel border keeps glyphs apart
+static const int AtlasCols = 16, AtlasRows = 6;  // ASCII 32..127
+static const int AtlasW = AtlasCols * CellW, AtlasH = AtlasRows * CellH;
+static const int Advance = GlyphW + 1;  // in font pixels
+
+static const std::uint8_t* glyphRows(int c) {
+    if (c >= 'a' && c <= 'z') c -= 'a' - 'A';
+    if (c >= 32 && c <= 96) return FontLow[c - 32];
+    if (c >= 123 && c <= 126) return FontHigh[c - 123];
+    return FontLow['?' - 32];
+}
+
+static const float QuadCorners[] = {0.0f, 0.0f, 1.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f};
+
+Hud::Hud(GLState& gl, int width, int height, ProgramCache* programCache)
+    : gl(gl),
+      shader(gl, "shaders/hud_vertex.glsl", "shaders/hud_fragment.glsl", programCache),
+      width(width),
+      height(height) {
+    screenSizeUniform = shader.vec2Uniform("screenSize");
+    shader.use();
+    shader.set(shader.intUniform("atlas"), 0);
+    buildAtlas();
+
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(1, &quadVBO);
+    glGenBuffers(1, &glyphVBO);
+    gl.bindVertexArray(vao);
+    gl.bindBuffer(GL_ARRAY_BUFFER, quadVBO);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(QuadCorners), QuadCorners, GL_STATIC_DRAW);
+    glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * sizeof(float), nullptr);
+    glEnableVertexAttribArray(0);
+
+    gl.bindBuffer(GL_ARRAY_BUFFER, glyphVBO);
+    glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, sizeof(Glyph), reinterpret_cast<const void*>(offsetof(Glyph, rect)));
+    glVertexAttribPointer(2, 4, GL_FLOAT, GL_FALSE, sizeof(Glyph), reinterpret_cast<const void*>(offsetof(Glyph, uv)));
+    glVertexAttribPointer(3, 3, GL_FLOAT, GL_FALSE, sizeof(Glyph), reinterpret_cast<const void*>(offsetof(Glyph, color)));
+    for (GLuint i = 1; i <= 3; ++i) {
+        glEnableVertexAttribArray(i);
+        glVertexAttribDivisor(i, 1);
+    }
+    gl.bindVertexArray(0);
+}
+
+Hud::~Hud() {
+    gl.deleteVertexArray(vao);
+    gl.deleteBuffer(quadVBO);
+    gl.deleteBuffer(glyphVBO);
+    gl.deleteTexture(atlas);
+}
+
+// Single-channel coverage texture, one 8x8 cell per character
+void Hud::buildAtlas() {
+    std::vector<std::uint8_t> pixels(AtlasW * AtlasH, 0);
+    for (int c = 32; c < 128; ++c) {
+        int cellX = (c - 32) % AtlasCols * CellW;
+        int cellY = (c - 32) / AtlasCols * CellH;
+        const std::uint8_t* rows = glyphRows(c);
+        for (int y = 0; y < GlyphH; ++y)
+            for (int x = 0; x < GlyphW; ++x)
+                if (rows[y] & (1 << (GlyphW - 1 - x))) pixels[(cellY + y) * AtlasW + cellX + x] = 255;
+    }
+
+    glGenTextures(1, &atlas);
+    gl.activeTexture(GL_TEXTURE0);
+    gl.bindTexture2D(atlas);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8, AtlasW, AtlasH, 0, GL_RED, GL_UNSIGNED_BYTE, pixels.data());
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+}
+
+void Hud::resize(int w, int h) {
+    width = w;
+    height = h;
+    dirty = true;  // centred and right-aligned lines move
+}
+
+int Hud::addLine(Anchor anchor, float marginX, float marginY, int scale, const glm::vec3& color) {
+    lines.push_back({anchor, marginX, marginY, scale, color, std::string()});
+    return static_cast<int>(lines.size() - 1);
+}
+
+void Hud::setText(int line, const std::string& text) {
+    if (lines[line].text == text) return;
+    lines[line].text = text;
+    dirty = true;
+}
+
+void Hud::rebuildGlyphs() {
+    glyphs.clear();
+    for (const Line& line : lines) {
+        float pixel = static_cast<float>(line.scale);
+        float lineW = line.text.size() * Advance * pixel - pixel;
+        float x = line.marginX;
+        if (line.anchor == TopCenter) x = (width - lineW) * 0.5f + line.marginX;
+        if (line.anchor == TopRight) x = width - lineW - line.marginX;
+
+        for (char ch : line.text) {
+            int c = static_cast<unsigned char>(ch);
+            if (c < 32 || c > 126) c = '?';  // no atlas cell; same fallback as glyphRows()
+            if (c != ' ') {
+                float u = static_cast<float>((c - 32) % AtlasCols * CellW) / AtlasW;
+                float v = static_cast<float>((c - 32) / AtlasCols * CellH) / AtlasH;
+                glyphs.push_back({glm::vec4(x, line.marginY, GlyphW * pixel, GlyphH * pixel),
+                                  glm::vec4(u, v, u + static_cast<float>(GlyphW) / AtlasW, v + static_cast<float>(GlyphH) / AtlasH),
+                                  line.color});
+            }
+            x += Advance * pixel;
+        }
+    }
+    gl.bindBuffer(GL_ARRAY_BUFFER, glyphVBO);
+    glBufferData(GL_ARRAY_BUFFER, glyphs.size() * sizeof(Glyph), glyphs.data(), GL_DYNAMIC_DRAW);
+    dirty = false;
+}
+
+void Hud::draw() {
+    if (dirty) rebuildGlyphs();
+    if (glyphs.empty()) return;
+
+    shader.use();
+    shader.set(screenSizeUniform, glm::vec2(static_cast<float>(width), static_cast<float>(height)));
+    gl.activeTexture(GL_TEXTURE0);
+    gl.bindTexture2D(atlas);
+
+    gl.setEnabled(GL_DEPTH_TEST, false);
+    gl.setEnabled(GL_BLEND, true);
+    gl.blendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+    gl.bindVertexArray(vao);
+    glDrawArraysInstanced(GL_TRIANGLE_STRIP, 0, 4, static_cast<GLsizei>(glyphs.size()));
+}
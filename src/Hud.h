@@ -0,0 +1,63 @@
+#pragma once
+
+#include "GLState.h"
+#include "Shader.h"
+#include <glad/glad.h>
+#include <glm/glm.hpp>
+#include <string>
+#include <vector>
+
+// Screen-space text. Glyphs come from a 5x7 bitmap font baked into one atlas
+// texture at startup; every glyph on screen is one instance of a single
+// instanced draw. The glyph buffer is rebuilt only when a line's text changes.
+class Hud {
+public:
+    enum Anchor { TopLeft, TopCenter, TopRight };
+
+    // `programCache`, if given, is used only while constructing
+    Hud(GLState& gl, int width, int height, ProgramCache* programCache = nullptr);
+    ~Hud();
+
+    Hud(const Hud&) = delete;
+    Hud& operator=(const Hud&) = delete;
+
+    const Shader& program() const { return shader; }
+
+    void resize(int width, int height);
+
+    // A text line `margin` pixels in from its anchor; glyphs are 5x7 pixels
+    // times `scale`. Returns the line's id.
+    int addLine(Anchor anchor, float marginX, float marginY, int scale, const glm::vec3& color);
+    void setText(int line, const std::string& text);  // cheap when unchanged
+
+    // Draws on top of the scene (leaves depth test off, blending on)
+    void draw();
+
+private:
+    struct Line {
+        Anchor anchor;
+        float marginX, marginY;
+        int scale;
+        glm::vec3 color;
+        std::string text;
+    };
+
+    struct Glyph {
+        glm::vec4 rect;  // x, y, w, h in pixels from the top-left
+        glm::vec4 uv;    // u0, v0, u1, v1
+        glm::vec3 color;
+    };
+
+    GLState& gl;
+    Shader shader;
+    UniformVec2 screenSizeUniform;
+    unsigned int atlas = 0;
+    unsigned int vao = 0, quadVBO = 0, glyphVBO = 0;
+    int width, height;
+    std::vector<Line> lines;
+    std::vector<Glyph> glyphs;
+    bool dirty = true;
+
+    void buildAtlas();
+    void rebuildGlyphs();
+};
@@ -0,0 +1,255 @@
+#include "InputLog.h"
+#include <cmath>
+#include <cstring>
+#include <iterator>
+
+namespace sim {
+
+namespace {
+
+const char kMagic[4] = {'C', 'P', 'L', 'G'};
+const char kTrailerMagic[4] = {'C', 'P', 'L', 'E'};
+const std::uint16_t kVersion = 2;  // 1: no policy specs
+constexpr std::size_t kFrameSize = 7;
+
+// Every persisted MatchConfig / MatchState field, in file order. Shared by the
+// writer and reader so the two cannot drift apart.
+template <typename Config, typename Fn>
+void visitConfig(Config& c, Fn&& fn) {
+    fn(c.tableLength); fn(c.tableWidth); fn(c.paddleHeight); fn(c.paddleDepth); fn(c.ballRadius);
+    fn(c.paddleSpeed); fn(c.speedBoost); fn(c.maxSpeed);
+    fn(c.aiLeft.speed); fn(c.aiLeft.mistakeRange); fn(c.aiLeft.mistakeChangeInterval);
+    fn(c.aiRight.speed); fn(c.aiRight.mistakeRange); fn(c.aiRight.mistakeChangeInterval);
+    fn(c.integrator); fn(c.fixedDt); fn(c.maxSteps); fn(c.maxEvents); fn(c.maxFrameDt);
+}
+
+template <typename State, typename Fn>
+void visitState(State& s, Fn&& fn) {
+    fn(s.ballX); fn(s.ballY); fn(s.ballVelX); fn(s.ballVelY);
+    fn(s.paddleLeftY); fn(s.paddleRightY);
+    fn(s.scoreLeft); fn(s.scoreRight);
+    fn(s.aiLeft.targetOffset); fn(s.aiLeft.mistakeTimer);
+    fn(s.aiRight.targetOffset); fn(s.aiRight.mistakeTimer);
+    fn(s.rng);
+}
+
+void putBytes(std::string& out, std::uint64_t value, int bytes) {
+    for (int i = 0; i < bytes; ++i) out.push_back(static_cast<char>((value >> (8 * i)) & 0xFF));
+}
+
+// Appends any persisted field little-endian; floats keep their exact bits
+struct Writer {
+    std::string& out;
+    void operator()(float v) const {
+        std::uint32_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        putBytes(out, bits, 4);
+    }
+    void operator()(int v) const { putBytes(out, static_cast<std::uint32_t>(v), 4); }
+    void operator()(Integrator v) const { putBytes(out, static_cast<std::uint32_t>(v), 4); }
+    void operator()(std::uint64_t v) const { putBytes(out, v, 8); }
+};
+
+struct Reader {
+    const unsigned char* data;
+    std::size_t size;
+    std::size_t pos = 0;
+    bool ok = true;
+
+    std::uint64_t take(int bytes) {
+        if (pos + bytes > size) {
+            ok = false;
+            return 0;
+        }
+        std::uint64_t v = 0;
+        for (int i = 0; i < bytes; ++i) v |= static_cast<std::uint64_t>(data[pos + i]) << (8 * i);
+        pos += bytes;
+        return v;
+    }
+    void operator()(float& v) {
+        std::uint32_t bits = static_cast<std::uint32_t>(take(4));
+        std::memcpy(&v, &bits, sizeof(v));
+    }
+    void operator()(int& v) { v = static_cast<int>(static_cast<std::uint32_t>(take(4))); }
+    void operator()(Integrator& v) { v = static_cast<Integrator>(take(4)); }
+    void operator()(std::uint64_t& v) { v = take(8); }
+};
+
+void putString(std::string& out, const std::string& text) {
+    putBytes(out, text.size(), 2);
+    out.append(text);
+}
+
+bool takeString(Reader& in, std::string& text) {
+    std::size_t length = static_cast<std::size_t>(in.take(2));
+    if (!in.ok || in.pos + length > in.size) {
+        in.ok = false;
+        return false;
+    }
+    text.assign(reinterpret_cast<const char*>(in.data + in.pos), length);
+    in.pos += length;
+    return true;
+}
+
+// The spec to store for a side, false if its policy cannot be rebuilt
+bool policySpec(const AIPolicy* policy, std::string& spec) {
+    spec = policy ? policy->spec() : std::string();
+    return !(policy && spec.empty()) && spec.size() <= 0xFFFF;
+}
+
+// Builds a stored policy again and points `params` at it
+bool loadPolicy(const std::string& spec, std::unique_ptr<AIPolicy>& policy, AIParams& params, std::string& error) {
+    if (spec.empty()) return true;
+    policy = makeAIPolicy(spec, error);
+    params.policy = policy.get();
+    return policy != nullptr;
+}
+
+std::size_t stateSize() {
+    std::string bytes;
+    MatchState s;
+    visitState(s, Writer{bytes});
+    return bytes.size();
+}
+
+std::int8_t quantizeAxis(float axis) {
+    float clamped = axis < -1.0f ? -1.0f : (axis > 1.0f ? 1.0f : axis);
+    return static_cast<std::int8_t>(std::lround(clamped * 127.0f));
+}
+
+}  // namespace
+
+InputFrame encodeFrame(const MatchInputs& inputs, float dt) {
+    InputFrame frame;
+    frame.dt = dt;
+    frame.leftAxis = quantizeAxis(inputs.leftAxis);
+    frame.rightAxis = quantizeAxis(inputs.rightAxis);
+    frame.flags = static_cast<std::uint8_t>((inputs.leftAI ? 1u : 0u) | (inputs.rightAI ? 2u : 0u));
+    return frame;
+}
+
+MatchInputs decodeInputs(const InputFrame& frame) {
+    MatchInputs inputs;
+    inputs.leftAxis = frame.leftAxis / 127.0f;
+    inputs.rightAxis = frame.rightAxis / 127.0f;
+    inputs.leftAI = (frame.flags & 1u) != 0;
+    inputs.rightAI = (frame.flags & 2u) != 0;
+    return inputs;
+}
+
+InputRecorder::~InputRecorder() {
+    // Without a final state the log stays replayable but unverifiable
+    if (m_file.is_open()) m_file.close();
+}
+
+bool InputRecorder::open(const std::string& path, std::uint64_t seed, const MatchConfig& config) {
+    std::string leftSpec, rightSpec;
+    if (!policySpec(config.aiLeft.policy, leftSpec) || !policySpec(config.aiRight.policy, rightSpec)) return false;
+    m_file.open(path, std::ios::binary | std::ios::trunc);
+    if (!m_file) return false;
+    m_frames = 0;
+
+    std::string header(kMagic, sizeof(kMagic));
+    putBytes(header, kVersion, 2);
+    putBytes(header, 0, 2);
+    putBytes(header, seed, 8);
+    visitConfig(config, Writer{header});
+    putString(header, leftSpec);
+    putString(header, rightSpec);
+    m_file.write(header.data(), static_cast<std::streamsize>(header.size()));
+    return static_cast<bool>(m_file);
+}
+
+void InputRecorder::record(const InputFrame& frame) {
+    if (!m_file.is_open()) return;
+    std::uint32_t dtBits;
+    std::memcpy(&dtBits, &frame.dt, sizeof(dtBits));
+    char bytes[kFrameSize] = {
+        static_cast<char>(dtBits & 0xFF), static_cast<char>((dtBits >> 8) & 0xFF),
+        static_cast<char>((dtBits >> 16) & 0xFF), static_cast<char>((dtBits >> 24) & 0xFF),
+        static_cast<char>(frame.leftAxis), static_cast<char>(frame.rightAxis), static_cast<char>(frame.flags)};
+    m_file.write(bytes, sizeof(bytes));
+    m_frames++;
+}
+
+void InputRecorder::close(const MatchState& finalState) {
+    if (!m_file.is_open()) return;
+    std::string trailer;
+    putBytes(trailer, m_frames, 8);
+    visitState(finalState, Writer{trailer});
+    trailer.append(kTrailerMagic, sizeof(kTrailerMagic));
+    m_file.write(trailer.data(), static_cast<std::streamsize>(trailer.size()));
+    m_file.close();
+}
+
+bool loadInputLog(const std::string& path, InputLog& log, std::string& error) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file) {
+        error = "cannot open " + path;
+        return false;
+    }
+    std::string bytes((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    Reader in{reinterpret_cast<const unsigned char*>(bytes.data()), bytes.size()};
+
+    if (bytes.size() < sizeof(kMagic) || std::memcmp(bytes.data(), kMagic, sizeof(kMagic)) != 0) {
+        error = "not a CPong input log";
+        return false;
+    }
+    in.pos = sizeof(kMagic);
+    std::uint16_t version = static_cast<std::uint16_t>(in.take(2));
+    in.take(2);
+    if (version != kVersion && version != 1) {
+        error = "unsupported input log version " + std::to_string(version);
+        return false;
+    }
+    log = InputLog{};
+    log.seed = in.take(8);
+    visitConfig(log.config, in);
+    if (version >= 2) {
+        takeString(in, log.leftPolicySpec);
+        takeString(in, log.rightPolicySpec);
+    }
+    if (!in.ok) {
+        error = "truncated header";
+        return false;
+    }
+    if (!loadPolicy(log.leftPolicySpec, log.leftPolicy, log.config.aiLeft, error) ||
+        !loadPolicy(log.rightPolicySpec, log.rightPolicy, log.config.aiRight, error)) {
+        error = "AI policy: " + error;
+        return false;
+    }
+
+    std::size_t framesEnd = bytes.size();
+    const std::size_t trailerSize = 8 + stateSize() + sizeof(kTrailerMagic);
+    if (bytes.size() >= in.pos + trailerSize &&
+        std::memcmp(bytes.data() + bytes.size() - sizeof(kTrailerMagic), kTrailerMagic, sizeof(kTrailerMagic)) == 0) {
+        framesEnd = bytes.size() - trailerSize;
+        Reader trailer{in.data, bytes.size(), framesEnd};
+        std::uint64_t count = trailer.take(8);
+        visitState(log.finalState, trailer);
+        if (count * kFrameSize != framesEnd - in.pos) {
+            error = "frame count does not match trailer";
+            return false;
+        }
+        log.hasFinalState = true;
+    }
+
+    std::size_t count = (framesEnd - in.pos) / kFrameSize;  // drops a torn last frame
+    log.frames.resize(count);
+    for (InputFrame& frame : log.frames) {
+        in(frame.dt);
+        frame.leftAxis = static_cast<std::int8_t>(in.take(1));
+        frame.rightAxis = static_cast<std::int8_t>(in.take(1));
+        frame.flags = static_cast<std::uint8_t>(in.take(1));
+    }
+    return true;
+}
+
+bool sameState(const MatchState& a, const MatchState& b) {
+    std::string x, y;
+    visitState(a, Writer{x});
+    visitState(b, Writer{y});
+    return x == y;
+}
+
+}  // namespace sim
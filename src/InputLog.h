@@ -0,0 +1,68 @@
+#pragma once
+
+// Compact binary input log: everything needed to re-run a match exactly.
+//
+//   header   "CPLG", u16 version, u16 reserved, u64 seed, MatchConfig fields,
+//            then the left and right AI policy specs (u16 length + bytes,
+//            empty for the built-in AI; version 2 on)
+//   frames   7 bytes per tick: f32 dt, i8 left axis, i8 right axis, u8 flags
+//   trailer  u64 frame count, final MatchState fields, "CPLE"
+//
+// All values little-endian. A log without a trailer (e.g. after a crash)
+// still replays; it just cannot be verified.
+
+#include "AIPolicy.h"
+#include "Simulation.h"
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sim {
+
+// One tick of input as stored. Axes are quantized to [-127, 127].
+struct InputFrame {
+    float dt = 0.0f;
+    std::int8_t leftAxis = 0;
+    std::int8_t rightAxis = 0;
+    std::uint8_t flags = 0;  // bit 0: left AI, bit 1: right AI
+};
+
+InputFrame encodeFrame(const MatchInputs& inputs, float dt);
+MatchInputs decodeInputs(const InputFrame& frame);
+
+class InputRecorder {
+public:
+    InputRecorder() = default;
+    ~InputRecorder();
+
+    // Fails if the file cannot be written or a policy in `config` has no
+    // spec to rebuild it from
+    bool open(const std::string& path, std::uint64_t seed, const MatchConfig& config);
+    bool isOpen() const { return m_file.is_open(); }
+    void record(const InputFrame& frame);
+    // Writes the trailer so replays can verify they reach `finalState`.
+    void close(const MatchState& finalState);
+
+private:
+    std::ofstream m_file;
+    std::uint64_t m_frames = 0;
+};
+
+struct InputLog {
+    std::uint64_t seed = 0;
+    MatchConfig config;  // its policies point into leftPolicy / rightPolicy
+    std::string leftPolicySpec, rightPolicySpec;  // empty: built-in AI
+    std::unique_ptr<AIPolicy> leftPolicy, rightPolicy;
+    std::vector<InputFrame> frames;
+    bool hasFinalState = false;
+    MatchState finalState;
+};
+
+bool loadInputLog(const std::string& path, InputLog& log, std::string& error);
+
+// Bitwise comparison of every simulated field.
+bool sameState(const MatchState& a, const MatchState& b);
+
+}  // namespace sim
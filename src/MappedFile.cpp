@@ -0,0 +1,186 @@
+#include "MappedFile.h"
+#include <cstring>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <cerrno>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+std::string lastError(const char* what, const std::string& path) {
+#ifdef _WIN32
+    return std::string(what) + " " + path + ": error " + std::to_string(GetLastError());
+#else
+    return std::string(what) + " " + path + ": " + std::strerror(errno);
+#endif
+}
+
+}  // namespace
+
+#ifdef _WIN32
+
+bool MappedFile::create(const std::string& path, std::size_t size, std::string& error) {
+    close();
+    m_file = CreateFileA(path.c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS,
+                         FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE) {
+        m_file = nullptr;
+        error = lastError("cannot create", path);
+        return false;
+    }
+    m_writable = true;
+    return resize(size, error);
+}
+
+bool MappedFile::openReadOnly(const std::string& path, std::string& error) {
+    close();
+    m_file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING,
+                         FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (m_file == INVALID_HANDLE_VALUE) {
+        m_file = nullptr;
+        error = lastError("cannot open", path);
+        return false;
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(m_file, &size)) {
+        error = lastError("cannot stat", path);
+        close();
+        return false;
+    }
+    m_size = static_cast<std::size_t>(size.QuadPart);
+    m_writable = false;
+    if (!map(error)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool MappedFile::resize(std::size_t size, std::string& error) {
+    if (!m_writable) {
+        error = "mapping is read-only";
+        return false;
+    }
+    unmap();
+    LARGE_INTEGER end;
+    end.QuadPart = static_cast<LONGLONG>(size);
+    if (!SetFilePointerEx(m_file, end, nullptr, FILE_BEGIN) || !SetEndOfFile(m_file)) {
+        error = lastError("cannot resize", "file");
+        return false;
+    }
+    m_size = size;
+    return map(error);
+}
+
+bool MappedFile::map(std::string& error) {
+    if (m_size == 0) return true;
+    m_mapping = CreateFileMappingA(m_file, nullptr, m_writable ? PAGE_READWRITE : PAGE_READONLY, 0, 0, nullptr);
+    if (!m_mapping) {
+        error = lastError("cannot map", "file");
+        return false;
+    }
+    m_data = static_cast<unsigned char*>(
+        MapViewOfFile(m_mapping, m_writable ? FILE_MAP_WRITE : FILE_MAP_READ, 0, 0, m_size));
+    if (!m_data) {
+        error = lastError("cannot map", "file");
+        CloseHandle(m_mapping);
+        m_mapping = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void MappedFile::unmap() {
+    if (m_data) UnmapViewOfFile(m_data);
+    if (m_mapping) CloseHandle(m_mapping);
+    m_data = nullptr;
+    m_mapping = nullptr;
+}
+
+void MappedFile::close() {
+    unmap();
+    if (m_file) CloseHandle(m_file);
+    m_file = nullptr;
+    m_size = 0;
+}
+
+#else
+
+bool MappedFile::create(const std::string& path, std::size_t size, std::string& error) {
+    close();
+    m_fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (m_fd < 0) {
+        error = lastError("cannot create", path);
+        return false;
+    }
+    m_writable = true;
+    return resize(size, error);
+}
+
+bool MappedFile::openReadOnly(const std::string& path, std::string& error) {
+    close();
+    m_fd = ::open(path.c_str(), O_RDONLY);
+    if (m_fd < 0) {
+        error = lastError("cannot open", path);
+        return false;
+    }
+    struct stat info;
+    if (fstat(m_fd, &info) != 0) {
+        error = lastError("cannot stat", path);
+        close();
+        return false;
+    }
+    m_size = static_cast<std::size_t>(info.st_size);
+    m_writable = false;
+    if (!map(error)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+bool MappedFile::resize(std::size_t size, std::string& error) {
+    if (!m_writable) {
+        error = "mapping is read-only";
+        return false;
+    }
+    unmap();
+    if (ftruncate(m_fd, static_cast<off_t>(size)) != 0) {
+        error = lastError("cannot resize", "file");
+        return false;
+    }
+    m_size = size;
+    return map(error);
+}
+
+bool MappedFile::map(std::string& error) {
+    if (m_size == 0) return true;
+    int protection = m_writable ? PROT_READ | PROT_WRITE : PROT_READ;
+    void* data = mmap(nullptr, m_size, protection, MAP_SHARED, m_fd, 0);
+    if (data == MAP_FAILED) {
+        error = lastError("cannot map", "file");
+        return false;
+    }
+    m_data = static_cast<unsigned char*>(data);
+    return true;
+}
+
+void MappedFile::unmap() {
+    if (m_data) munmap(m_data, m_size);
+    m_data = nullptr;
+}
+
+void MappedFile::close() {
+    unmap();
+    if (m_fd >= 0) ::close(m_fd);
+    m_fd = -1;
+    m_size = 0;
+}
+
+#endif
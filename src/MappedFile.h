@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// A whole file mapped into memory, POSIX mmap or Win32 file mappings.
+// Writable mappings can grow or shrink; the data pointer then moves.
+class MappedFile {
+public:
+    MappedFile() = default;
+    ~MappedFile() { close(); }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    // Creates (or truncates) `path` at `size` bytes, mapped read-write
+    bool create(const std::string& path, std::size_t size, std::string& error);
+    // Maps an existing file read-only
+    bool openReadOnly(const std::string& path, std::string& error);
+    // Writable mappings only. Contents up to the smaller size are kept.
+    bool resize(std::size_t size, std::string& error);
+    void close();
+
+    bool isOpen() const { return m_data != nullptr; }
+    unsigned char* data() { return m_data; }
+    const unsigned char* data() const { return m_data; }
+    std::size_t size() const { return m_size; }
+
+private:
+    bool map(std::string& error);
+    void unmap();
+
+    unsigned char* m_data = nullptr;
+    std::size_t m_size = 0;
+    bool m_writable = false;
+#ifdef _WIN32
+    void* m_file = nullptr;     // HANDLE
+    void* m_mapping = nullptr;  // HANDLE
+#else
+    int m_fd = -1;
+#endif
+};
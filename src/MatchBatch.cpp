@@ -0,0 +1,449 @@
+#include "MatchBatch.h"
+#include "AIPolicy.h"
+#include <algorithm>
+#include <cmath>
+
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define CPONG_BATCH_AVX2 1
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define CPONG_BATCH_SSE2 1
+#endif
+
+namespace sim {
+
+// ---------------------------------------------------------------------------
+// Lane types. Each provides the handful of operations the kernel needs with
+// exactly the semantics of the scalar code in Simulation.cpp (std::min/max
+// argument order, strict compares), so every lane matches sim::step bit for bit.
+// ---------------------------------------------------------------------------
+
+namespace {
+
+struct ScalarLanes {
+    static constexpr int width = 1;
+    using V = float;
+    using M = bool;
+
+    static V load(const float* p) { return *p; }
+    static void store(float* p, V v) { *p = v; }
+    static V set1(float v) { return v; }
+    static M lt(V a, V b) { return a < b; }
+    static M gt(V a, V b) { return a > b; }
+    static M ge(V a, V b) { return a >= b; }
+    static M both(M a, M b) { return a && b; }
+    static M either(M a, M b) { return a || b; }
+    static V select(M m, V a, V b) { return m ? a : b; }
+    static V vmin(V a, V b) { return std::min(a, b); }
+    static V vmax(V a, V b) { return std::max(a, b); }
+    static V vabs(V a) { return std::abs(a); }
+    static V neg(V a) { return -a; }
+    static V vsqrt(V a) { return std::sqrt(a); }
+    static V copysign(V mag, V sign) { return std::copysign(mag, sign); }
+    static int bits(M m) { return m ? 1 : 0; }
+};
+
+#if defined(CPONG_BATCH_SSE2) || defined(CPONG_BATCH_AVX2)
+struct F4 { __m128 v; };
+inline F4 operator+(F4 a, F4 b) { return {_mm_add_ps(a.v, b.v)}; }
+inline F4 operator-(F4 a, F4 b) { return {_mm_sub_ps(a.v, b.v)}; }
+inline F4 operator*(F4 a, F4 b) { return {_mm_mul_ps(a.v, b.v)}; }
+inline F4 operator/(F4 a, F4 b) { return {_mm_div_ps(a.v, b.v)}; }
+
+struct SSELanes {
+    static constexpr int width = 4;
+    using V = F4;
+    using M = F4;
+
+    static V load(const float* p) { return {_mm_loadu_ps(p)}; }
+    static void store(float* p, V v) { _mm_storeu_ps(p, v.v); }
+    static V set1(float v) { return {_mm_set1_ps(v)}; }
+    static M lt(V a, V b) { return {_mm_cmplt_ps(a.v, b.v)}; }
+    static M gt(V a, V b) { return {_mm_cmpgt_ps(a.v, b.v)}; }
+    static M ge(V a, V b) { return {_mm_cmpge_ps(a.v, b.v)}; }
+    static M both(M a, M b) { return {_mm_and_ps(a.v, b.v)}; }
+    static M either(M a, M b) { return {_mm_or_ps(a.v, b.v)}; }
+    static V select(M m, V a, V b) { return {_mm_or_ps(_mm_and_ps(m.v, a.v), _mm_andnot_ps(m.v, b.v))}; }
+    // std::min(a, b) == (b < a) ? b : a; _mm_min_ps(x, y) == (x < y) ? x : y
+    static V vmin(V a, V b) { return {_mm_min_ps(b.v, a.v)}; }
+    static V vmax(V a, V b) { return {_mm_max_ps(b.v, a.v)}; }
+    static V vabs(V a) { return {_mm_andnot_ps(_mm_set1_ps(-0.0f), a.v)}; }
+    static V neg(V a) { return {_mm_xor_ps(_mm_set1_ps(-0.0f), a.v)}; }
+    static V vsqrt(V a) { return {_mm_sqrt_ps(a.v)}; }
+    static V copysign(V mag, V sign) {
+        const __m128 signBit = _mm_set1_ps(-0.0f);
+        return {_mm_or_ps(_mm_andnot_ps(signBit, mag.v), _mm_and_ps(signBit, sign.v))};
+    }
+    static int bits(M m) { return _mm_movemask_ps(m.v); }
+};
+#endif
+
+#if defined(CPONG_BATCH_AVX2)
+struct F8 { __m256 v; };
+inline F8 operator+(F8 a, F8 b) { return {_mm256_add_ps(a.v, b.v)}; }
+inline F8 operator-(F8 a, F8 b) { return {_mm256_sub_ps(a.v, b.v)}; }
+inline F8 operator*(F8 a, F8 b) { return {_mm256_mul_ps(a.v, b.v)}; }
+inline F8 operator/(F8 a, F8 b) { return {_mm256_div_ps(a.v, b.v)}; }
+
+struct AVX2Lanes {
+    static constexpr int width = 8;
+    using V = F8;
+    using M = F8;
+
+    static V load(const float* p) { return {_mm256_loadu_ps(p)}; }
+    static void store(float* p, V v) { _mm256_storeu_ps(p, v.v); }
+    static V set1(float v) { return {_mm256_set1_ps(v)}; }
+    static M lt(V a, V b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_LT_OQ)}; }
+    static M gt(V a, V b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_GT_OQ)}; }
+    static M ge(V a, V b) { return {_mm256_cmp_ps(a.v, b.v, _CMP_GE_OQ)}; }
+    static M both(M a, M b) { return {_mm256_and_ps(a.v, b.v)}; }
+    static M either(M a, M b) { return {_mm256_or_ps(a.v, b.v)}; }
+    static V select(M m, V a, V b) { return {_mm256_blendv_ps(b.v, a.v, m.v)}; }
+    static V vmin(V a, V b) { return {_mm256_min_ps(b.v, a.v)}; }
+    static V vmax(V a, V b) { return {_mm256_max_ps(b.v, a.v)}; }
+    static V vabs(V a) { return {_mm256_andnot_ps(_mm256_set1_ps(-0.0f), a.v)}; }
+    static V neg(V a) { return {_mm256_xor_ps(_mm256_set1_ps(-0.0f), a.v)}; }
+    static V vsqrt(V a) { return {_mm256_sqrt_ps(a.v)}; }
+    static V copysign(V mag, V sign) {
+        const __m256 signBit = _mm256_set1_ps(-0.0f);
+        return {_mm256_or_ps(_mm256_andnot_ps(signBit, mag.v), _mm256_and_ps(signBit, sign.v))};
+    }
+    static int bits(M m) { return _mm256_movemask_ps(m.v); }
+};
+#endif
+
+// Frame constants shared by every lane, derived exactly as sim::step derives them.
+struct FrameConstants {
+    float dt;
+    int steps;
+    float leftInput, rightInput;
+    float limit;
+    float ballRadius, halfLen, halfWidth, paddleHalfH;
+    float leftPaddleMinX, leftPaddleMaxX, rightPaddleMinX, rightPaddleMaxX;
+    float wallTopY, wallBottomY;
+    float leftSnapX, rightSnapX;
+    float fixedDt, speedBoost, maxSpeed;
+    float leftMistakeInterval, rightMistakeInterval;
+    float leftAIStep, rightAIStep;
+    float aiTargetMin, aiTargetMax;
+};
+
+FrameConstants makeFrameConstants(const MatchConfig& config, const MatchInputs& inputs, float deltaTime) {
+    FrameConstants k{};
+    deltaTime = std::min(deltaTime, config.maxFrameDt);
+    k.dt = deltaTime;
+
+    float accumulated = deltaTime;
+    while (accumulated >= config.fixedDt && k.steps < config.maxSteps) {
+        k.steps++;
+        accumulated -= config.fixedDt;
+    }
+
+    k.leftInput = inputs.leftAI ? 0.0f : inputs.leftAxis * config.paddleSpeed * deltaTime;
+    k.rightInput = inputs.rightAI ? 0.0f : inputs.rightAxis * config.paddleSpeed * deltaTime;
+    k.limit = (config.tableWidth - config.paddleHeight) / 2.0f;
+
+    k.ballRadius = config.ballRadius;
+    k.halfLen = config.tableLength / 2.0f;
+    k.halfWidth = config.tableWidth / 2.0f;
+    k.paddleHalfH = config.paddleHeight / 2.0f;
+
+    const float pad = k.ballRadius * 1.2f;
+    k.leftPaddleMinX = -k.halfLen;
+    k.leftPaddleMaxX = -k.halfLen + config.paddleDepth + pad;
+    k.rightPaddleMinX = k.halfLen - config.paddleDepth - pad;
+    k.rightPaddleMaxX = k.halfLen;
+
+    k.wallTopY = k.halfWidth - k.ballRadius;
+    k.wallBottomY = -k.halfWidth + k.ballRadius;
+    const float leftPaddleFaceX = -k.halfLen + config.paddleDepth;
+    const float rightPaddleFaceX = k.halfLen - config.paddleDepth;
+    k.leftSnapX = leftPaddleFaceX + k.ballRadius + 0.01f;
+    k.rightSnapX = rightPaddleFaceX - k.ballRadius - 0.01f;
+
+    k.fixedDt = config.fixedDt;
+    k.speedBoost = config.speedBoost;
+    k.maxSpeed = config.maxSpeed;
+    k.leftMistakeInterval = config.aiLeft.mistakeChangeInterval;
+    k.rightMistakeInterval = config.aiRight.mistakeChangeInterval;
+    k.leftAIStep = config.aiLeft.speed * deltaTime;
+    k.rightAIStep = config.aiRight.speed * deltaTime;
+    k.aiTargetMin = -k.limit - 1.0f;
+    k.aiTargetMax = k.limit + 1.0f;
+    return k;
+}
+
+template <typename L>
+typename L::V clampLanes(typename L::V v, typename L::V lo, typename L::V hi) {
+    // std::clamp(v, lo, hi) == (v < lo) ? lo : (hi < v) ? hi : v
+    return L::select(L::lt(v, lo), lo, L::select(L::lt(hi, v), hi, v));
+}
+
+template <typename L>
+void moveAIPaddleLanes(typename L::V ballY, typename L::M approaching, typename L::V offset,
+                       typename L::V& paddleY, float aiStep, const FrameConstants& k) {
+    using V = typename L::V;
+    V targetY = clampLanes<L>(ballY + offset, L::set1(k.aiTargetMin), L::set1(k.aiTargetMax));
+    V diff = targetY - paddleY;
+    V absDiff = L::vabs(diff);
+    V move = L::copysign(L::vmin(L::set1(aiStep), absDiff), diff);
+    V moved = clampLanes<L>(paddleY + move, L::set1(-k.limit), L::set1(k.limit));
+    paddleY = L::select(L::both(approaching, L::gt(absDiff, L::set1(0.15f))), moved, paddleY);
+}
+
+// Steps lanes [begin, begin + L::width) through one whole frame.
+template <typename L>
+void stepLanes(MatchBatch& b, std::size_t begin, const FrameConstants& k,
+               const MatchConfig& config, const MatchInputs& inputs) {
+    using V = typename L::V;
+    using M = typename L::M;
+
+    V x = L::load(&b.ballX[begin]);
+    V y = L::load(&b.ballY[begin]);
+    V vx = L::load(&b.ballVelX[begin]);
+    V vy = L::load(&b.ballVelY[begin]);
+    V pl = L::load(&b.paddleLeftY[begin]);
+    V pr = L::load(&b.paddleRightY[begin]);
+
+    const V zero = L::set1(0.0f);
+    const V limitLo = L::set1(-k.limit);
+    const V limitHi = L::set1(k.limit);
+
+    // Paddle input
+    if (!inputs.leftAI) pl = pl + L::set1(k.leftInput);
+    if (!inputs.rightAI) pr = pr + L::set1(k.rightInput);
+    pl = clampLanes<L>(pl, limitLo, limitHi);
+    pr = clampLanes<L>(pr, limitLo, limitHi);
+
+    // Fixed-step ball physics; every branch of the scalar loop becomes a mask
+    const V r = L::set1(k.ballRadius);
+    const V fixedDt = L::set1(k.fixedDt);
+    const V halfWidth = L::set1(k.halfWidth);
+    const V negHalfWidth = L::set1(-k.halfWidth);
+    const V wallTopY = L::set1(k.wallTopY);
+    const V wallBottomY = L::set1(k.wallBottomY);
+    const V paddleHalfH = L::set1(k.paddleHalfH);
+    const V leftMinX = L::set1(k.leftPaddleMinX);
+    const V leftMaxX = L::set1(k.leftPaddleMaxX);
+    const V rightMinX = L::set1(k.rightPaddleMinX);
+    const V rightMaxX = L::set1(k.rightPaddleMaxX);
+    const V leftSnapX = L::set1(k.leftSnapX);
+    const V rightSnapX = L::set1(k.rightSnapX);
+    const V speedBoost = L::set1(k.speedBoost);
+    const V maxSpeed = L::set1(k.maxSpeed);
+
+    const V leftMinY = pl - paddleHalfH;
+    const V leftMaxY = pl + paddleHalfH;
+    const V rightMinY = pr - paddleHalfH;
+    const V rightMaxY = pr + paddleHalfH;
+
+    for (int s = 0; s < k.steps; ++s) {
+        V prevX = x;
+        V prevY = y;
+        x = x + vx * fixedDt;
+        y = y + vy * fixedDt;
+
+        M top = L::gt(y + r, halfWidth);
+        y = L::select(top, wallTopY, y);
+        vy = L::select(top, L::neg(L::vabs(vy)), vy);
+        M bottom = L::lt(y - r, negHalfWidth);
+        y = L::select(bottom, wallBottomY, y);
+        vy = L::select(bottom, L::vabs(vy), vy);
+
+        V bMinX = L::vmin(prevX, x) - r;
+        V bMaxX = L::vmax(prevX, x) + r;
+        V bMinY = L::vmin(prevY, y) - r;
+        V bMaxY = L::vmax(prevY, y) + r;
+
+        M hitLeft = L::both(L::both(L::lt(vx, zero), L::both(L::lt(bMinX, leftMaxX), L::gt(bMaxX, leftMinX))),
+                            L::both(L::lt(bMinY, leftMaxY), L::gt(bMaxY, leftMinY)));
+        if (L::bits(hitLeft)) {
+            V speed = L::vsqrt(vx * vx + vy * vy);
+            V scale = L::vmin(speed * speedBoost, maxSpeed) / speed;
+            x = L::select(hitLeft, leftSnapX, x);
+            vx = L::select(hitLeft, L::vabs(vx) * scale, vx);
+            vy = L::select(hitLeft, vy * scale, vy);
+        }
+
+        M hitRight = L::both(L::both(L::gt(vx, zero), L::both(L::lt(bMinX, rightMaxX), L::gt(bMaxX, rightMinX))),
+                             L::both(L::lt(bMinY, rightMaxY), L::gt(bMaxY, rightMinY)));
+        if (L::bits(hitRight)) {
+            V speed = L::vsqrt(vx * vx + vy * vy);
+            V scale = L::vmin(speed * speedBoost, maxSpeed) / speed;
+            x = L::select(hitRight, rightSnapX, x);
+            vx = L::select(hitRight, L::neg(L::vabs(vx)) * scale, vx);
+            vy = L::select(hitRight, vy * scale, vy);
+        }
+    }
+
+    // Goals and AI aim re-rolls draw from each match's random stream, so
+    // lanes that need one fall back to the scalar stages; the rest stay vectorized.
+    const V dt = L::set1(k.dt);
+    V tl = L::load(&b.aiLeftTimer[begin]);
+    V tr = L::load(&b.aiRightTimer[begin]);
+
+    M events = L::either(L::lt(x, L::set1(-k.halfLen)), L::gt(x, L::set1(k.halfLen)));
+    V tlNext = tl, trNext = tr;
+    if (inputs.leftAI) {
+        M approaching = L::lt(vx, zero);
+        tlNext = L::select(approaching, tl + dt, tl);
+        events = L::either(events, L::both(approaching, L::ge(tlNext, L::set1(k.leftMistakeInterval))));
+    }
+    if (inputs.rightAI) {
+        M approaching = L::gt(vx, zero);
+        trNext = L::select(approaching, tr + dt, tr);
+        events = L::either(events, L::both(approaching, L::ge(trNext, L::set1(k.rightMistakeInterval))));
+    }
+
+    L::store(&b.ballX[begin], x);
+    L::store(&b.ballY[begin], y);
+    L::store(&b.ballVelX[begin], vx);
+    L::store(&b.ballVelY[begin], vy);
+    L::store(&b.paddleLeftY[begin], pl);
+    L::store(&b.paddleRightY[begin], pr);
+    L::store(&b.aiLeftTimer[begin], L::select(events, tl, tlNext));
+    L::store(&b.aiRightTimer[begin], L::select(events, tr, trNext));
+
+    if (int mask = L::bits(events)) {
+        for (int lane = 0; lane < L::width; ++lane) {
+            if (!(mask & (1 << lane))) continue;
+            MatchState s = b.get(begin + lane);
+            scoreGoals(s, config);
+            updateAIMistakes(s, config, inputs, k.dt);
+            b.set(begin + lane, s);
+        }
+        x = L::load(&b.ballX[begin]);
+        y = L::load(&b.ballY[begin]);
+        vx = L::load(&b.ballVelX[begin]);
+        vy = L::load(&b.ballVelY[begin]);
+    }
+
+    // Built-in AI paddle movement; policy sides run batched after all lanes
+    if (inputs.leftAI && !config.aiLeft.policy) {
+        moveAIPaddleLanes<L>(y, L::lt(vx, zero), L::load(&b.aiLeftOffset[begin]), pl, k.leftAIStep, k);
+        L::store(&b.paddleLeftY[begin], pl);
+    }
+    if (inputs.rightAI && !config.aiRight.policy) {
+        moveAIPaddleLanes<L>(y, L::gt(vx, zero), L::load(&b.aiRightOffset[begin]), pr, k.rightAIStep, k);
+        L::store(&b.paddleRightY[begin], pr);
+    }
+}
+
+}  // namespace
+
+#if defined(CPONG_BATCH_AVX2)
+using BatchLanes = AVX2Lanes;
+#elif defined(CPONG_BATCH_SSE2)
+using BatchLanes = SSELanes;
+#else
+using BatchLanes = ScalarLanes;
+#endif
+
+const char* batchKernelName() {
+#if defined(CPONG_BATCH_AVX2)
+    return "avx2";
+#elif defined(CPONG_BATCH_SSE2)
+    return "sse2";
+#else
+    return "scalar";
+#endif
+}
+
+MatchBatch::MatchBatch(std::size_t count) {
+    resize(count);
+}
+
+void MatchBatch::resize(std::size_t count) {
+    m_count = count;
+    for (std::vector<float>* column : {&ballX, &ballY, &ballVelX, &ballVelY, &paddleLeftY, &paddleRightY,
+                                       &aiLeftOffset, &aiLeftTimer, &aiRightOffset, &aiRightTimer})
+        column->resize(count, 0.0f);
+    scoreLeft.resize(count, 0);
+    scoreRight.resize(count, 0);
+    rng.resize(count, 0);
+}
+
+void MatchBatch::set(std::size_t i, const MatchState& state) {
+    ballX[i] = state.ballX;
+    ballY[i] = state.ballY;
+    ballVelX[i] = state.ballVelX;
+    ballVelY[i] = state.ballVelY;
+    paddleLeftY[i] = state.paddleLeftY;
+    paddleRightY[i] = state.paddleRightY;
+    scoreLeft[i] = state.scoreLeft;
+    scoreRight[i] = state.scoreRight;
+    aiLeftOffset[i] = state.aiLeft.targetOffset;
+    aiLeftTimer[i] = state.aiLeft.mistakeTimer;
+    aiRightOffset[i] = state.aiRight.targetOffset;
+    aiRightTimer[i] = state.aiRight.mistakeTimer;
+    rng[i] = state.rng;
+}
+
+MatchState MatchBatch::get(std::size_t i) const {
+    MatchState state;
+    state.ballX = ballX[i];
+    state.ballY = ballY[i];
+    state.ballVelX = ballVelX[i];
+    state.ballVelY = ballVelY[i];
+    state.paddleLeftY = paddleLeftY[i];
+    state.paddleRightY = paddleRightY[i];
+    state.scoreLeft = scoreLeft[i];
+    state.scoreRight = scoreRight[i];
+    state.aiLeft.targetOffset = aiLeftOffset[i];
+    state.aiLeft.mistakeTimer = aiLeftTimer[i];
+    state.aiRight.targetOffset = aiRightOffset[i];
+    state.aiRight.mistakeTimer = aiRightTimer[i];
+    state.rng = rng[i];
+    return state;
+}
+
+void MatchBatch::step(const MatchConfig& config, const MatchInputs& inputs, float dt) {
+    if (config.integrator != Integrator::Substep) {
+        // Event and Fixed have no SIMD kernel; step lanes one at a time
+        MatchInputs builtInAI = inputs;
+        builtInAI.leftAI = inputs.leftAI && !config.aiLeft.policy;
+        builtInAI.rightAI = inputs.rightAI && !config.aiRight.policy;
+        for (std::size_t i = 0; i < m_count; ++i) {
+            MatchState s = get(i);
+            stepBeforeAI(s, config, inputs, dt);
+            moveAIPaddles(s, config, builtInAI, dt);
+            set(i, s);
+        }
+    } else {
+        const FrameConstants k = makeFrameConstants(config, inputs, dt);
+
+        std::size_t i = 0;
+        for (; i + BatchLanes::width <= m_count; i += BatchLanes::width)
+            stepLanes<BatchLanes>(*this, i, k, config, inputs);
+        for (; i < m_count; ++i)
+            stepLanes<ScalarLanes>(*this, i, k, config, inputs);
+    }
+
+    dt = std::min(dt, config.maxFrameDt);
+    if (inputs.leftAI && config.aiLeft.policy)
+        movePolicyPaddles(config, config.aiLeft, -1.0f, paddleLeftY, aiLeftOffset, dt);
+    if (inputs.rightAI && config.aiRight.policy)
+        movePolicyPaddles(config, config.aiRight, 1.0f, paddleRightY, aiRightOffset, dt);
+}
+
+// One policy call for the whole batch, straight over the columns
+void MatchBatch::movePolicyPaddles(const MatchConfig& config, const AIParams& params, float side,
+                                   std::vector<float>& paddleY, const std::vector<float>& aimOffset, float dt) {
+    AIObservations obs;
+    obs.count = m_count;
+    obs.side = side;
+    obs.ballX = ballX.data();
+    obs.ballY = ballY.data();
+    obs.ballVelX = ballVelX.data();
+    obs.ballVelY = ballVelY.data();
+    obs.paddleY = paddleY.data();
+    obs.aimOffset = aimOffset.data();
+
+    m_targets.resize(m_count);
+    params.policy->evaluate(obs, config, m_targets.data());
+    moveTowardTargets(m_targets.data(), paddleY.data(), m_count, params.speed * dt,
+                      (config.tableWidth - config.paddleHeight) / 2.0f);
+}
+
+}  // namespace sim
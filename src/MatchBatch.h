@@ -0,0 +1,50 @@
+#pragma once
+
+#include "Simulation.h"
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace sim {
+
+// N independent matches in structure-of-arrays form, stepped together by a
+// SIMD kernel (AVX2 when compiled with CPONG_AVX2, SSE2 on x86, scalar
+// elsewhere). Produces bit-identical results to calling sim::step on each
+// match, including each match's random stream.
+// The kernel implements Integrator::Substep; other integrators fall back to
+// sim::step per match. Sides with an AIPolicy are evaluated for the whole
+// batch in one call after the physics.
+class MatchBatch {
+public:
+    explicit MatchBatch(std::size_t count = 0);
+
+    std::size_t size() const { return m_count; }
+    void resize(std::size_t count);
+
+    void set(std::size_t index, const MatchState& state);
+    MatchState get(std::size_t index) const;
+
+    // Same contract as sim::step, applied to every match. Inputs are shared.
+    void step(const MatchConfig& config, const MatchInputs& inputs, float dt);
+
+    // Columns (one entry per match)
+    std::vector<float> ballX, ballY;
+    std::vector<float> ballVelX, ballVelY;
+    std::vector<float> paddleLeftY, paddleRightY;
+    std::vector<int> scoreLeft, scoreRight;
+    std::vector<float> aiLeftOffset, aiLeftTimer;
+    std::vector<float> aiRightOffset, aiRightTimer;
+    std::vector<std::uint64_t> rng;
+
+private:
+    void movePolicyPaddles(const MatchConfig& config, const AIParams& params, float side,
+                           std::vector<float>& paddleY, const std::vector<float>& aimOffset, float dt);
+
+    std::size_t m_count = 0;
+    std::vector<float> m_targets;
+};
+
+// Name of the kernel compiled in: "avx2", "sse2" or "scalar".
+const char* batchKernelName();
+
+}  // namespace sim
@@ -0,0 +1,206 @@
+#include "MockGL.h"
+#include <glad/glad.h>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+
+// Every stub bumps its own counter; load() pairs each with its GL name
+#define MOCK(ret, name, params, ...)             \
+    std::uint64_t calls_##name = 0;              \
+    ret APIENTRY mock_##name params {            \
+        ++calls_##name;                          \
+        __VA_ARGS__                              \
+    }
+
+GLuint nextName = 1;
+std::uint64_t uploadBytes = 0;
+std::vector<unsigned char> mapped;
+int syncObject;
+
+void genNames(GLsizei n, GLuint* names) {
+    for (GLsizei i = 0; i < n; ++i) names[i] = nextName++;
+}
+
+// glad, on load: version, then extensions (none)
+MOCK(const GLubyte*, glGetString, (GLenum name),
+     return reinterpret_cast<const GLubyte*>(name == GL_VERSION ? "3.3.0 Mock" : name == GL_RENDERER ? "MockGL" : "Mock");)
+MOCK(const GLubyte*, glGetStringi, (GLenum, GLuint), return reinterpret_cast<const GLubyte*>("");)
+MOCK(void, glGetIntegerv, (GLenum pname, GLint* data),
+     *data = pname == GL_MAJOR_VERSION ? 3 : pname == GL_MINOR_VERSION ? 3 : 0;)
+
+// State
+MOCK(void, glEnable, (GLenum))
+MOCK(void, glDisable, (GLenum))
+MOCK(void, glBlendFunc, (GLenum, GLenum))
+MOCK(void, glViewport, (GLint, GLint, GLsizei, GLsizei))
+MOCK(void, glClearColor, (GLfloat, GLfloat, GLfloat, GLfloat))
+MOCK(void, glClear, (GLbitfield))
+MOCK(void, glLineWidth, (GLfloat))
+MOCK(void, glPixelStorei, (GLenum, GLint))
+
+// Buffers and vertex arrays
+MOCK(void, glGenBuffers, (GLsizei n, GLuint* names), genNames(n, names);)
+MOCK(void, glDeleteBuffers, (GLsizei, const GLuint*))
+MOCK(void, glBindBuffer, (GLenum, GLuint))
+MOCK(void, glBindBufferBase, (GLenum, GLuint, GLuint))
+MOCK(void, glBufferData, (GLenum, GLsizeiptr size, const void*, GLenum), uploadBytes += static_cast<std::uint64_t>(size);)
+MOCK(void, glBufferSubData, (GLenum, GLintptr, GLsizeiptr size, const void*),
+     uploadBytes += static_cast<std::uint64_t>(size);)
+MOCK(void*, glMapBufferRange, (GLenum, GLintptr, GLsizeiptr length, GLbitfield),
+     if (mapped.size() < static_cast<std::size_t>(length)) mapped.resize(static_cast<std::size_t>(length));
+     return mapped.data();)
+MOCK(GLboolean, glUnmapBuffer, (GLenum), return GL_TRUE;)
+MOCK(void, glGenVertexArrays, (GLsizei n, GLuint* names), genNames(n, names);)
+MOCK(void, glDeleteVertexArrays, (GLsizei, const GLuint*))
+MOCK(void, glBindVertexArray, (GLuint))
+MOCK(void, glEnableVertexAttribArray, (GLuint))
+MOCK(void, glVertexAttribPointer, (GLuint, GLint, GLenum, GLboolean, GLsizei, const void*))
+MOCK(void, glVertexAttribDivisor, (GLuint, GLuint))
+
+// Draws
+MOCK(void, glDrawArrays, (GLenum, GLint, GLsizei))
+MOCK(void, glDrawArraysInstanced, (GLenum, GLint, GLsizei, GLsizei))
+MOCK(void, glDrawElements, (GLenum, GLsizei, GLenum, const void*))
+MOCK(void, glDrawElementsInstanced, (GLenum, GLsizei, GLenum, const void*, GLsizei))
+MOCK(void, glDrawElementsInstancedBaseVertex, (GLenum, GLsizei, GLenum, const void*, GLsizei, GLint))
+
+// Shaders: everything compiles and links, no uniforms are active
+MOCK(GLuint, glCreateShader, (GLenum), return nextName++;)
+MOCK(void, glShaderSource, (GLuint, GLsizei, const GLchar* const*, const GLint*))
+MOCK(void, glCompileShader, (GLuint))
+MOCK(void, glGetShaderiv, (GLuint, GLenum pname, GLint* params), *params = pname == GL_COMPILE_STATUS ? GL_TRUE : 0;)
+MOCK(void, glGetShaderInfoLog, (GLuint, GLsizei, GLsizei* length, GLchar* log),
+     if (length) *length = 0;
+     if (log) *log = '\0';)
+MOCK(void, glDeleteShader, (GLuint))
+MOCK(GLuint, glCreateProgram, (), return nextName++;)
+MOCK(void, glAttachShader, (GLuint, GLuint))
+MOCK(void, glLinkProgram, (GLuint))
+MOCK(void, glGetProgramiv, (GLuint, GLenum pname, GLint* params), *params = pname == GL_LINK_STATUS ? GL_TRUE : 0;)
+MOCK(void, glGetProgramInfoLog, (GLuint, GLsizei, GLsizei* length, GLchar* log),
+     if (length) *length = 0;
+     if (log) *log = '\0';)
+MOCK(void, glDeleteProgram, (GLuint))
+MOCK(void, glUseProgram, (GLuint))
+MOCK(void, glGetActiveUniform, (GLuint, GLuint, GLsizei, GLsizei* length, GLint*, GLenum*, GLchar*), *length = 0;)
+MOCK(GLint, glGetUniformLocation, (GLuint, const GLchar*), return -1;)
+MOCK(GLuint, glGetUniformBlockIndex, (GLuint, const GLchar*), return 0;)
+MOCK(void, glUniformBlockBinding, (GLuint, GLuint, GLuint))
+MOCK(void, glUniform1i, (GLint, GLint))
+MOCK(void, glUniform2fv, (GLint, GLsizei, const GLfloat*))
+MOCK(void, glUniform3fv, (GLint, GLsizei, const GLfloat*))
+MOCK(void, glUniformMatrix4fv, (GLint, GLsizei, GLboolean, const GLfloat*))
+
+// Textures
+MOCK(void, glGenTextures, (GLsizei n, GLuint* names), genNames(n, names);)
+MOCK(void, glDeleteTextures, (GLsizei, const GLuint*))
+MOCK(void, glBindTexture, (GLenum, GLuint))
+MOCK(void, glActiveTexture, (GLenum))
+MOCK(void, glTexParameteri, (GLenum, GLenum, GLint))
+MOCK(void, glTexImage2D, (GLenum, GLint, GLint, GLsizei width, GLsizei height, GLint, GLenum, GLenum, const void*),
+     uploadBytes += static_cast<std::uint64_t>(width) * static_cast<std::uint64_t>(height);)
+MOCK(void, glTexBuffer, (GLenum, GLenum, GLuint))
+
+// Framebuffers, readback, sync and queries
+MOCK(void, glGenFramebuffers, (GLsizei n, GLuint* names), genNames(n, names);)
+MOCK(void, glDeleteFramebuffers, (GLsizei, const GLuint*))
+MOCK(void, glBindFramebuffer, (GLenum, GLuint))
+MOCK(GLenum, glCheckFramebufferStatus, (GLenum), return GL_FRAMEBUFFER_COMPLETE;)
+MOCK(void, glGenRenderbuffers, (GLsizei n, GLuint* names), genNames(n, names);)
+MOCK(void, glDeleteRenderbuffers, (GLsizei, const GLuint*))
+MOCK(void, glBindRenderbuffer, (GLenum, GLuint))
+MOCK(void, glRenderbufferStorage, (GLenum, GLenum, GLsizei, GLsizei))
+MOCK(void, glFramebufferRenderbuffer, (GLenum, GLenum, GLenum, GLuint))
+MOCK(void, glReadBuffer, (GLenum))
+MOCK(void, glReadPixels, (GLint, GLint, GLsizei, GLsizei, GLenum, GLenum, void*))
+MOCK(GLsync, glFenceSync, (GLenum, GLbitfield), return reinterpret_cast<GLsync>(&syncObject);)
+MOCK(GLenum, glClientWaitSync, (GLsync, GLbitfield, GLuint64), return GL_ALREADY_SIGNALED;)
+MOCK(void, glDeleteSync, (GLsync))
+MOCK(void, glGenQueries, (GLsizei n, GLuint* names), genNames(n, names);)
+MOCK(void, glDeleteQueries, (GLsizei, const GLuint*))
+MOCK(void, glBeginQuery, (GLenum, GLuint))
+MOCK(void, glEndQuery, (GLenum))
+MOCK(void, glGetQueryObjectiv, (GLuint, GLenum, GLint* params), *params = 1;)
+MOCK(void, glGetQueryObjectui64v, (GLuint, GLenum, GLuint64* params), *params = 0;)
+
+#undef MOCK
+
+struct Entry {
+    const char* name;
+    void* proc;
+    std::uint64_t* calls;
+    bool draw;
+};
+
+#define ENTRY(name) {#name, reinterpret_cast<void*>(&mock_##name), &calls_##name, false}
+#define DRAW(name) {#name, reinterpret_cast<void*>(&mock_##name), &calls_##name, true}
+
+const Entry entries[] = {
+    ENTRY(glGetString), ENTRY(glGetStringi), ENTRY(glGetIntegerv),
+    ENTRY(glEnable), ENTRY(glDisable), ENTRY(glBlendFunc), ENTRY(glViewport), ENTRY(glClearColor), ENTRY(glClear),
+    ENTRY(glLineWidth), ENTRY(glPixelStorei),
+    ENTRY(glGenBuffers), ENTRY(glDeleteBuffers), ENTRY(glBindBuffer), ENTRY(glBindBufferBase), ENTRY(glBufferData),
+    ENTRY(glBufferSubData), ENTRY(glMapBufferRange), ENTRY(glUnmapBuffer), ENTRY(glGenVertexArrays),
+    ENTRY(glDeleteVertexArrays), ENTRY(glBindVertexArray), ENTRY(glEnableVertexAttribArray),
+    ENTRY(glVertexAttribPointer), ENTRY(glVertexAttribDivisor),
+    DRAW(glDrawArrays), DRAW(glDrawArraysInstanced), DRAW(glDrawElements), DRAW(glDrawElementsInstanced),
+    DRAW(glDrawElementsInstancedBaseVertex),
+    ENTRY(glCreateShader), ENTRY(glShaderSource), ENTRY(glCompileShader), ENTRY(glGetShaderiv),
+    ENTRY(glGetShaderInfoLog), ENTRY(glDeleteShader), ENTRY(glCreateProgram), ENTRY(glAttachShader),
+    ENTRY(glLinkProgram), ENTRY(glGetProgramiv), ENTRY(glGetProgramInfoLog), ENTRY(glDeleteProgram),
+    ENTRY(glUseProgram), ENTRY(glGetActiveUniform), ENTRY(glGetUniformLocation), ENTRY(glGetUniformBlockIndex),
+    ENTRY(glUniformBlockBinding), ENTRY(glUniform1i), ENTRY(glUniform2fv), ENTRY(glUniform3fv),
+    ENTRY(glUniformMatrix4fv),
+    ENTRY(glGenTextures), ENTRY(glDeleteTextures), ENTRY(glBindTexture), ENTRY(glActiveTexture),
+    ENTRY(glTexParameteri), ENTRY(glTexImage2D), ENTRY(glTexBuffer),
+    ENTRY(glGenFramebuffers), ENTRY(glDeleteFramebuffers), ENTRY(glBindFramebuffer), ENTRY(glCheckFramebufferStatus),
+    ENTRY(glGenRenderbuffers), ENTRY(glDeleteRenderbuffers), ENTRY(glBindRenderbuffer), ENTRY(glRenderbufferStorage),
+    ENTRY(glFramebufferRenderbuffer), ENTRY(glReadBuffer), ENTRY(glReadPixels), ENTRY(glFenceSync),
+    ENTRY(glClientWaitSync), ENTRY(glDeleteSync), ENTRY(glGenQueries), ENTRY(glDeleteQueries), ENTRY(glBeginQuery),
+    ENTRY(glEndQuery), ENTRY(glGetQueryObjectiv), ENTRY(glGetQueryObjectui64v),
+};
+
+#undef ENTRY
+#undef DRAW
+
+void* getProcAddress(const char* name) {
+    for (const Entry& entry : entries)
+        if (std::strcmp(entry.name, name) == 0) return entry.proc;
+    return nullptr;
+}
+
+}  // namespace
+
+namespace MockGL {
+
+bool load() {
+    return gladLoadGLLoader(reinterpret_cast<GLADloadproc>(getProcAddress)) != 0;
+}
+
+void reset() {
+    for (const Entry& entry : entries) *entry.calls = 0;
+    uploadBytes = 0;
+}
+
+Totals totals() {
+    Totals t;
+    for (const Entry& entry : entries) {
+        t.calls += *entry.calls;
+        if (entry.draw) t.draws += *entry.calls;
+    }
+    t.uploadBytes = uploadBytes;
+    return t;
+}
+
+std::vector<std::pair<std::string, std::uint64_t>> calls() {
+    std::vector<std::pair<std::string, std::uint64_t>> counts;
+    for (const Entry& entry : entries)
+        if (*entry.calls) counts.emplace_back(entry.name, *entry.calls);
+    std::stable_sort(counts.begin(), counts.end(),
+                     [](const std::pair<std::string, std::uint64_t>& a,
+                        const std::pair<std::string, std::uint64_t>& b) { return a.second > b.second; });
+    return counts;
+}
+
+}  // namespace MockGL
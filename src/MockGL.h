@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// A stand-in GL driver for benchmarks: every entry point the game uses,
+// loaded through glad like a real context. Calls are counted and otherwise
+// do next to nothing - object names are handed out, shaders always compile,
+// maps return scratch memory - so render code runs without a GPU or display
+// and its cost is the CPU side of submission alone.
+namespace MockGL {
+
+struct Totals {
+    std::uint64_t calls = 0;
+    std::uint64_t draws = 0;        // glDraw*
+    std::uint64_t uploadBytes = 0;  // glBufferData / glBufferSubData / glTexImage2D
+};
+
+// Points glad at the mock entry points. Other GL functions stay null.
+bool load();
+
+void reset();
+Totals totals();
+// Calls per entry point since reset(), most frequent first; unused ones omitted
+std::vector<std::pair<std::string, std::uint64_t>> calls();
+
+}  // namespace MockGL
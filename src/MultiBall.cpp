@@ -0,0 +1,292 @@
+#include "MultiBall.h"
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace sim {
+
+static const std::size_t Grain = 4096;
+static const float CoverFraction = 0.08f;
+
+// Stateless random stream: serves and the initial layout depend only on the
+// seed and where they happen, never on which thread got there first
+static std::uint64_t mix(std::uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+// Uniform in [-1, 1)
+static float signedUnit(std::uint64_t bits) {
+    return static_cast<float>(bits >> 40) * (2.0f / 16777216.0f) - 1.0f;
+}
+
+MultiBall::MultiBall(const MatchConfig& config, const MultiBallConfig& balls, std::uint64_t seed)
+    : m_config(config), m_serveSpeed(balls.serveSpeed), m_collisions(balls.collisions), m_seed(seed) {
+    const std::size_t count = std::max<std::size_t>(1, balls.balls);
+    const float area = config.tableLength * config.tableWidth;
+    m_radius = balls.radius > 0.0f ? balls.radius : std::sqrt(CoverFraction * area / (3.14159265f * count));
+
+    // Cells at least one diameter wide, so every contact is within the 3x3
+    // neighbourhood; capped at 4M cells for tiny radii
+    m_cellSize = std::max(2.0f * m_radius, std::sqrt(area / 4194304.0f));
+    m_invCellSize = 1.0f / m_cellSize;
+    m_columns = std::max(1, static_cast<int>(std::ceil(config.tableLength * m_invCellSize)));
+    m_rows = std::max(1, static_cast<int>(std::ceil(config.tableWidth * m_invCellSize)));
+    m_cellStart.resize(static_cast<std::size_t>(m_columns) * m_rows + 1);
+
+    x.resize(count);
+    y.resize(count);
+    velX.resize(count);
+    velY.resize(count);
+    m_cellOf.resize(count);
+    m_scratchX.resize(count);
+    m_scratchY.resize(count);
+    m_scratchVelX.resize(count);
+    m_scratchVelY.resize(count);
+
+    // Jittered lattice across the table, clear of the paddles
+    const float halfLen = config.tableLength / 2.0f - config.paddleDepth - 2.0f * m_radius;
+    const float halfWidth = config.tableWidth / 2.0f - m_radius;
+    const float spacing = std::sqrt(4.0f * halfLen * halfWidth / count);
+    const std::size_t perRow = std::max<std::size_t>(1, static_cast<std::size_t>(2.0f * halfLen / spacing));
+    const float jitter = std::max(0.0f, spacing / 2.0f - m_radius);
+    for (std::size_t i = 0; i < count; ++i) {
+        std::uint64_t r = mix(seed ^ mix(i));
+        float px = -halfLen + spacing * (0.5f + static_cast<float>(i % perRow));
+        float py = -halfWidth + spacing * (0.5f + static_cast<float>(i / perRow));
+        x[i] = std::clamp(px + signedUnit(r) * jitter, -halfLen, halfLen);
+        y[i] = std::clamp(py + signedUnit(mix(r)) * jitter, -halfWidth, halfWidth);
+        float angle = signedUnit(mix(r + 1)) * 3.14159265f;
+        velX[i] = std::cos(angle) * m_serveSpeed;
+        velY[i] = std::sin(angle) * m_serveSpeed;
+    }
+    sortByCell();
+}
+
+template <typename Fn>
+void MultiBall::forRanges(std::size_t count, const Fn& body) {
+    if (m_pool && m_pool->threadCount() > 1)
+        m_pool->parallelFor(count, Grain, body);
+    else
+        body(0, count, 0);
+}
+
+void MultiBall::step(const MatchInputs& inputs, float dt) {
+    dt = std::min(dt, m_config.maxFrameDt);
+    m_tick++;
+    m_stats = Stats();
+    movePaddles(inputs, dt);
+    integrate(dt);
+    sortByCell();
+    if (m_collisions) collide();
+}
+
+// Players move by axis; an AI paddle heads for the ball found to reach it
+// first on the previous tick
+void MultiBall::movePaddles(const MatchInputs& inputs, float dt) {
+    const float limit = (m_config.tableWidth - m_config.paddleHeight) / 2.0f;
+    auto move = [&](float& paddleY, bool ai, float axis, float targetY, const AIParams& params) {
+        if (ai) {
+            float diff = targetY - paddleY;
+            paddleY += std::copysign(std::min(params.speed * dt, std::abs(diff)), diff);
+        } else {
+            paddleY += axis * m_config.paddleSpeed * dt;
+        }
+        paddleY = std::clamp(paddleY, -limit, limit);
+    };
+    move(paddleLeftY, inputs.leftAI, inputs.leftAxis, m_targetLeftY, m_config.aiLeft);
+    move(paddleRightY, inputs.rightAI, inputs.rightAxis, m_targetRightY, m_config.aiRight);
+}
+
+void MultiBall::serve(std::size_t ball) {
+    std::uint64_t r = mix(m_seed ^ mix(m_tick * 0x100000001B3ULL + ball));
+    x[ball] = 0.0f;
+    y[ball] = signedUnit(r) * (m_config.tableWidth / 2.0f - m_radius);
+    velX[ball] = (r & 1 ? 1.0f : -1.0f) * m_serveSpeed;
+    velY[ball] = signedUnit(mix(r)) * 0.5f * m_serveSpeed;
+}
+
+// Flight, walls, paddles and goals: independent per ball
+void MultiBall::integrate(float dt) {
+    const float r = m_radius;
+    const float halfLen = m_config.tableLength / 2.0f;
+    const float top = m_config.tableWidth / 2.0f - r;
+    const float leftFace = -halfLen + m_config.paddleDepth;
+    const float rightFace = halfLen - m_config.paddleDepth;
+    const float reach = m_config.paddleHeight / 2.0f + r;
+    const float leftY = paddleLeftY, rightY = paddleRightY;
+    const float boost = m_config.speedBoost, maxSpeed = m_config.maxSpeed;
+
+    m_nextLeft = {INFINITY, 0};
+    m_nextRight = {INFINITY, 0};
+    forRanges(size(), [&](std::size_t begin, std::size_t end, unsigned) {
+        int scoredLeft = 0, scoredRight = 0;
+        Approach left = {INFINITY, 0}, right = {INFINITY, 0};
+        for (std::size_t i = begin; i < end; ++i) {
+            float px = x[i], py = y[i], vx = velX[i], vy = velY[i];
+            float nx = px + vx * dt;
+            float ny = py + vy * dt;
+
+            if (ny > top) {
+                ny = top;
+                vy = -std::abs(vy);
+            } else if (ny < -top) {
+                ny = -top;
+                vy = std::abs(vy);
+            }
+
+            // Crossed a paddle face this tick within the paddle's span
+            bool hitLeft = vx < 0.0f && px - r >= leftFace && nx - r < leftFace && std::abs(ny - leftY) < reach;
+            bool hitRight = vx > 0.0f && px + r <= rightFace && nx + r > rightFace && std::abs(ny - rightY) < reach;
+            if (hitLeft || hitRight) {
+                float speed = std::sqrt(vx * vx + vy * vy);
+                float scale = std::min(speed * boost, maxSpeed) / speed;
+                vx = (hitLeft ? std::abs(vx) : -std::abs(vx)) * scale;
+                vy *= scale;
+                nx = hitLeft ? leftFace + r : rightFace - r;
+            }
+
+            x[i] = nx;
+            y[i] = ny;
+            velX[i] = vx;
+            velY[i] = vy;
+            if (nx < -halfLen || nx > halfLen) {
+                (nx < 0.0f ? scoredRight : scoredLeft)++;
+                serve(i);
+                continue;
+            }
+
+            // Ties go to the lower index, so the result is order-independent
+            std::uint32_t ball = static_cast<std::uint32_t>(i);
+            if (vx < 0.0f) {
+                float t = (nx - r - leftFace) / -vx;
+                if (t < left.time) left = {t, ball};
+            } else if (vx > 0.0f) {
+                float t = (rightFace - nx - r) / vx;
+                if (t < right.time) right = {t, ball};
+            }
+        }
+
+        std::lock_guard<std::mutex> lock(m_merge);
+        scoreLeft += scoredLeft;
+        scoreRight += scoredRight;
+        auto earlier = [](const Approach& a, const Approach& b) {
+            return a.time < b.time || (a.time == b.time && a.ball < b.ball);
+        };
+        if (earlier(left, m_nextLeft)) m_nextLeft = left;
+        if (earlier(right, m_nextRight)) m_nextRight = right;
+    });
+
+    // Where each ball will meet its paddle's face, ignoring walls
+    if (m_nextLeft.time < INFINITY) m_targetLeftY = y[m_nextLeft.ball] + velY[m_nextLeft.ball] * m_nextLeft.time;
+    if (m_nextRight.time < INFINITY) m_targetRightY = y[m_nextRight.ball] + velY[m_nextRight.ball] * m_nextRight.time;
+}
+
+// Counting sort by cell, row-major, stable; the columns are permuted with it
+void MultiBall::sortByCell() {
+    const std::size_t n = size();
+    const float halfLen = m_config.tableLength / 2.0f;
+    const float halfWidth = m_config.tableWidth / 2.0f;
+    std::fill(m_cellStart.begin(), m_cellStart.end(), 0u);
+    for (std::size_t i = 0; i < n; ++i) {
+        int cx = std::clamp(static_cast<int>((x[i] + halfLen) * m_invCellSize), 0, m_columns - 1);
+        int cy = std::clamp(static_cast<int>((y[i] + halfWidth) * m_invCellSize), 0, m_rows - 1);
+        std::uint32_t cell = static_cast<std::uint32_t>(cy * m_columns + cx);
+        m_cellOf[i] = cell;
+        m_cellStart[cell + 1]++;
+    }
+    for (std::size_t c = 1; c < m_cellStart.size(); ++c) m_cellStart[c] += m_cellStart[c - 1];
+
+    // cellStart[c] doubles as the insertion cursor, then is restored
+    for (std::size_t i = 0; i < n; ++i) {
+        std::uint32_t slot = m_cellStart[m_cellOf[i]]++;
+        m_scratchX[slot] = x[i];
+        m_scratchY[slot] = y[i];
+        m_scratchVelX[slot] = velX[i];
+        m_scratchVelY[slot] = velY[i];
+    }
+    std::memmove(&m_cellStart[1], &m_cellStart[0], (m_cellStart.size() - 1) * sizeof(std::uint32_t));
+    m_cellStart[0] = 0;
+    x.swap(m_scratchX);
+    y.swap(m_scratchY);
+    velX.swap(m_scratchVelX);
+    velY.swap(m_scratchVelY);
+}
+
+// Each ball sums the impulses and separations from every ball it touches,
+// reading the sorted columns and writing the scratch ones
+void MultiBall::collide() {
+    const float r = m_radius;
+    const float reach2 = 4.0f * r * r;
+    const float halfLen = m_config.tableLength / 2.0f;
+    const float halfWidth = m_config.tableWidth / 2.0f;
+
+    forRanges(size(), [&](std::size_t begin, std::size_t end, unsigned) {
+        std::uint64_t tests = 0, contacts = 0;
+        for (std::size_t i = begin; i < end; ++i) {
+            const float px = x[i], py = y[i], vx = velX[i], vy = velY[i];
+            int cx = std::clamp(static_cast<int>((px + halfLen) * m_invCellSize), 0, m_columns - 1);
+            int cy = std::clamp(static_cast<int>((py + halfWidth) * m_invCellSize), 0, m_rows - 1);
+            int x0 = std::max(cx - 1, 0), x1 = std::min(cx + 1, m_columns - 1);
+            float dvx = 0.0f, dvy = 0.0f, dx = 0.0f, dy = 0.0f;
+
+            // A row of three cells is one contiguous run of balls
+            for (int row = std::max(cy - 1, 0); row <= std::min(cy + 1, m_rows - 1); ++row) {
+                std::uint32_t first = m_cellStart[row * m_columns + x0];
+                std::uint32_t last = m_cellStart[row * m_columns + x1 + 1];
+                tests += last - first;
+                for (std::uint32_t j = first; j < last; ++j) {
+                    float ox = px - x[j], oy = py - y[j];
+                    float d2 = ox * ox + oy * oy;
+                    if (d2 >= reach2 || d2 == 0.0f) continue;
+                    float d = std::sqrt(d2);
+                    float nx = ox / d, ny = oy / d;
+                    contacts++;
+
+                    // Equal masses: swap the velocity components along the normal
+                    float closing = (vx - velX[j]) * nx + (vy - velY[j]) * ny;
+                    if (closing < 0.0f) {
+                        dvx -= closing * nx;
+                        dvy -= closing * ny;
+                    }
+                    float push = (2.0f * r - d) * 0.5f;
+                    dx += nx * push;
+                    dy += ny * push;
+                }
+            }
+            m_scratchX[i] = px + dx;
+            m_scratchY[i] = py + dy;
+            m_scratchVelX[i] = vx + dvx;
+            m_scratchVelY[i] = vy + dvy;
+        }
+
+        std::lock_guard<std::mutex> lock(m_merge);
+        m_stats.neighbourTests += tests - (end - begin);  // not itself
+        m_stats.contacts += contacts;
+    });
+    m_stats.contacts /= 2;
+
+    x.swap(m_scratchX);
+    y.swap(m_scratchY);
+    velX.swap(m_scratchVelX);
+    velY.swap(m_scratchVelY);
+}
+
+std::uint64_t MultiBall::checksum() const {
+    std::uint64_t hash = 1469598103934665603ULL;
+    auto add = [&](const void* data, std::size_t bytes) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        for (std::size_t i = 0; i < bytes; ++i) hash = (hash ^ p[i]) * 1099511628211ULL;
+    };
+    for (const std::vector<float>* column : {&x, &y, &velX, &velY}) add(column->data(), column->size() * sizeof(float));
+    add(&paddleLeftY, sizeof(paddleLeftY));
+    add(&paddleRightY, sizeof(paddleRightY));
+    add(&scoreLeft, sizeof(scoreLeft));
+    add(&scoreRight, sizeof(scoreRight));
+    return hash;
+}
+
+}  // namespace sim
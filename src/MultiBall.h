@@ -0,0 +1,98 @@
+#pragma once
+
+#include "Simulation.h"
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+class WorkStealingPool;
+
+namespace sim {
+
+// Stress mode: thousands of balls on one table, bouncing off the walls, the
+// two paddles and each other. Scoring works as in a match; a scored ball is
+// served again from the centre line.
+struct MultiBallConfig {
+    std::size_t balls = 10000;
+    float radius = 0.0f;  // 0 = sized so the balls cover ~8% of the table
+    float serveSpeed = 8.0f;
+    bool collisions = true;  // ball-ball
+};
+
+// Balls are stored structure-of-arrays and re-sorted by grid cell every
+// tick (a counting sort over a uniform grid of ball-diameter cells, the
+// spatial hash of a bounded table), so each ball's neighbours are a few
+// contiguous runs. Ball-ball contacts are resolved Jacobi-style: every ball
+// reads only last tick's positions and velocities and writes only its own,
+// so the tick can be split across threads and the result is bit-identical
+// for any thread count. Collisions are discrete: balls faster than a radius
+// per tick can pass through each other.
+class MultiBall {
+public:
+    struct Stats {
+        std::uint64_t neighbourTests = 0;  // candidate pairs, each counted from both balls
+        std::uint64_t contacts = 0;        // touching pairs
+    };
+
+    MultiBall(const MatchConfig& config, const MultiBallConfig& balls, std::uint64_t seed);
+
+    // Runs ticks on `pool` (nullptr = the calling thread only)
+    void setPool(WorkStealingPool* pool) { m_pool = pool; }
+
+    // Paddles move first (AI sides chase the ball that reaches them first),
+    // then balls fly, bounce and score, then touching balls are separated.
+    void step(const MatchInputs& inputs, float dt);
+
+    std::size_t size() const { return x.size(); }
+    float radius() const { return m_radius; }
+    std::uint64_t ticks() const { return m_tick; }
+    const Stats& stats() const { return m_stats; }  // of the last step()
+
+    // Hash of every ball and paddle and the scores, for cross-checks
+    std::uint64_t checksum() const;
+
+    // Columns, in grid-cell order (order changes every tick)
+    std::vector<float> x, y;
+    std::vector<float> velX, velY;
+    float paddleLeftY = 0.0f, paddleRightY = 0.0f;
+    int scoreLeft = 0, scoreRight = 0;
+
+private:
+    template <typename Fn>
+    void forRanges(std::size_t count, const Fn& body);
+
+    void movePaddles(const MatchInputs& inputs, float dt);
+    void integrate(float dt);
+    void sortByCell();
+    void collide();
+    void serve(std::size_t ball);
+
+    MatchConfig m_config;
+    float m_radius;
+    float m_serveSpeed;
+    bool m_collisions;
+    std::uint64_t m_seed;
+    std::uint64_t m_tick = 0;
+    WorkStealingPool* m_pool = nullptr;
+
+    // Grid over the table; cellStart[c]..cellStart[c + 1] are cell c's balls
+    float m_cellSize, m_invCellSize;
+    int m_columns, m_rows;
+    std::vector<std::uint32_t> m_cellStart;
+    std::vector<std::uint32_t> m_cellOf;
+    std::vector<float> m_scratchX, m_scratchY, m_scratchVelX, m_scratchVelY;
+
+    // Earliest ball to reach each paddle this tick: time, then index
+    struct Approach {
+        float time;
+        std::uint32_t ball;
+    };
+    Approach m_nextLeft, m_nextRight;
+    float m_targetLeftY = 0.0f, m_targetRightY = 0.0f;
+
+    std::mutex m_merge;  // per-range results of parallel passes
+    Stats m_stats;
+};
+
+}  // namespace sim
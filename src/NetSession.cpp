@@ -0,0 +1,164 @@
+#include "NetSession.h"
+#include <algorithm>
+#include <cstring>
+
+namespace sim {
+
+namespace {
+
+const unsigned char Magic[4] = {'C', 'P', 'N', 'P'};
+const std::int64_t HelloIntervalNs = 100000000;  // 100 ms
+const std::size_t MaxPacket = 512;
+
+void putU32(std::vector<unsigned char>& out, std::uint32_t v) {
+    for (int i = 0; i < 4; ++i) out.push_back(static_cast<unsigned char>(v >> (8 * i)));
+}
+
+std::uint32_t getU32(const unsigned char* p) {
+    return static_cast<std::uint32_t>(p[0]) | static_cast<std::uint32_t>(p[1]) << 8 |
+           static_cast<std::uint32_t>(p[2]) << 16 | static_cast<std::uint32_t>(p[3]) << 24;
+}
+
+std::vector<unsigned char> packet(std::uint8_t type) {
+    std::vector<unsigned char> out(Magic, Magic + sizeof(Magic));
+    out.push_back(type);
+    return out;
+}
+
+}  // namespace
+
+NetSession::NetSession(const MatchConfig& config, float tickDt, std::uint32_t maxPrediction)
+    // Peers may each lead by the window, so the send history needs twice it
+    : m_config(config), m_dt(tickDt), m_maxPrediction(std::min(maxPrediction, RollbackSession::HistorySize / 4)) {}
+
+bool NetSession::host(std::uint16_t port, std::uint64_t seed, std::string& error) {
+    if (!m_socket.open(port, error)) return false;
+    m_isHost = true;
+    m_seed = seed;
+    return true;
+}
+
+bool NetSession::connect(const std::string& host, std::uint16_t port, std::string& error) {
+    if (!UdpSocket::resolve(host, port, m_peer, error)) return false;
+    if (!m_socket.open(0, error)) return false;
+    m_isHost = false;
+    m_hasPeer = true;
+    return true;
+}
+
+void NetSession::setConditions(const Conditions& conditions) {
+    m_conditions = conditions;
+    m_rng = conditions.seed;
+}
+
+// SplitMix64 to [0, 1)
+double NetSession::random() {
+    std::uint64_t z = (m_rng += 0x9E3779B97F4A7C15ULL);
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z ^= z >> 31;
+    return (z >> 11) * (1.0 / 9007199254740992.0);
+}
+
+void NetSession::send(std::vector<unsigned char> bytes, std::int64_t nowNs) {
+    m_lastSendNs = nowNs;
+    if (m_conditions.loss > 0.0 && random() < m_conditions.loss) {
+        m_stats.packetsDropped++;
+        return;
+    }
+    double delayMs = m_conditions.latencyMs;
+    if (m_conditions.jitterMs > 0.0) delayMs += (random() * 2.0 - 1.0) * m_conditions.jitterMs;
+    if (delayMs <= 0.0) {
+        m_socket.send(m_peer, bytes.data(), bytes.size());
+        m_stats.packetsSent++;
+        return;
+    }
+    m_delayed.push_back({nowNs + static_cast<std::int64_t>(delayMs * 1e6), std::move(bytes)});
+}
+
+void NetSession::poll(std::int64_t nowNs) {
+    if (!m_socket.isOpen()) return;
+
+    // Release delayed packets that are due
+    auto due = std::stable_partition(m_delayed.begin(), m_delayed.end(),
+                                     [nowNs](const Delayed& d) { return d.dueNs > nowNs; });
+    for (auto it = due; it != m_delayed.end(); ++it) {
+        m_socket.send(m_peer, it->bytes.data(), it->bytes.size());
+        m_stats.packetsSent++;
+    }
+    m_delayed.erase(due, m_delayed.end());
+
+    unsigned char buffer[MaxPacket];
+    UdpSocket::Address from;
+    for (int size; (size = m_socket.receive(buffer, sizeof(buffer), from)) > 0;) handle(buffer, size, from, nowNs);
+
+    if (!connected() && !m_isHost && nowNs - m_lastHelloNs >= HelloIntervalNs) {
+        m_lastHelloNs = nowNs;
+        send(packet(Hello), nowNs);
+    }
+    // Keep acks flowing while stalled
+    if (connected() && nowNs - m_lastSendNs >= static_cast<std::int64_t>(m_dt * 1e9f)) sendInputs(nowNs);
+}
+
+void NetSession::handle(const unsigned char* data, int size, const UdpSocket::Address& from,
+                        std::int64_t nowNs) {
+    if (size < 5 || std::memcmp(data, Magic, sizeof(Magic)) != 0) return;
+    if (m_hasPeer && from != m_peer) return;
+    m_stats.packetsReceived++;
+
+    switch (data[4]) {
+    case Hello:
+        if (!m_isHost) return;
+        if (!m_hasPeer) {
+            m_peer = from;
+            m_hasPeer = true;
+            m_rollback.reset(new RollbackSession(m_config, m_seed, 0, m_dt, m_maxPrediction));
+        }
+        {
+            // Answered every time: the previous Welcome may have been lost
+            std::vector<unsigned char> welcome = packet(Welcome);
+            putU32(welcome, static_cast<std::uint32_t>(m_seed));
+            putU32(welcome, static_cast<std::uint32_t>(m_seed >> 32));
+            send(std::move(welcome), nowNs);
+        }
+        break;
+    case Welcome:
+        if (m_isHost || connected() || size < 13) return;
+        m_seed = getU32(data + 5) | static_cast<std::uint64_t>(getU32(data + 9)) << 32;
+        m_rollback.reset(new RollbackSession(m_config, m_seed, 1, m_dt, m_maxPrediction));
+        break;
+    case Inputs: {
+        if (!connected() || size < 14) return;
+        std::uint32_t ack = getU32(data + 5);
+        std::uint32_t start = getU32(data + 9);
+        int count = data[13];
+        if (size < 14 + count) return;
+        m_peerAck = std::max(m_peerAck, std::min(ack, m_rollback->tick()));
+        for (int i = 0; i < count; ++i)
+            m_rollback->addRemoteInput(start + i, static_cast<std::int8_t>(data[14 + i]));
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+void NetSession::sendInputs(std::int64_t nowNs) {
+    std::uint32_t tick = m_rollback->tick();
+    // Everything the peer has not acknowledged (bounded by both windows)
+    std::uint32_t start = std::max(m_peerAck, tick - std::min(tick, RollbackSession::HistorySize / 2));
+    std::vector<unsigned char> out = packet(Inputs);
+    putU32(out, m_rollback->remoteNext());
+    putU32(out, start);
+    out.push_back(static_cast<unsigned char>(tick - start));
+    for (std::uint32_t t = start; t < tick; ++t) out.push_back(static_cast<unsigned char>(m_rollback->localInput(t)));
+    send(std::move(out), nowNs);
+}
+
+bool NetSession::advance(std::int8_t localAxis, std::int64_t nowNs) {
+    if (!connected() || !m_rollback->advance(localAxis)) return false;
+    sendInputs(nowNs);
+    return true;
+}
+
+}  // namespace sim
@@ -0,0 +1,98 @@
+#pragma once
+
+// Two-player match over UDP on top of RollbackSession.
+//
+//   Hello    client -> host, repeated until answered
+//   Welcome  host -> client: match seed; the host plays left
+//   Inputs   both ways every tick: ack (next tick of ours the sender
+//            needs) plus every local input the peer has not acknowledged
+//
+// Packets carry all unacknowledged inputs, so a lost packet costs nothing
+// as long as a later one arrives. For testing, outgoing packets can be
+// delayed, jittered (which also reorders them) and dropped.
+//
+// All calls take the caller's clock, so tests can run on virtual time.
+
+#include "Rollback.h"
+#include "UdpSocket.h"
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace sim {
+
+class NetSession {
+public:
+    struct Conditions {
+        double latencyMs = 0.0;  // one way, added to each outgoing packet
+        double jitterMs = 0.0;   // +- uniform
+        double loss = 0.0;       // drop probability
+        std::uint64_t seed = 1;
+    };
+
+    struct Stats {
+        std::uint64_t packetsSent = 0;
+        std::uint64_t packetsDropped = 0;  // by the injected loss
+        std::uint64_t packetsReceived = 0;
+    };
+
+    NetSession(const MatchConfig& config, float tickDt, std::uint32_t maxPrediction = 12);
+
+    bool host(std::uint16_t port, std::uint64_t seed, std::string& error);
+    bool connect(const std::string& host, std::uint16_t port, std::string& error);
+    void setConditions(const Conditions& conditions);
+
+    // Receives, answers the handshake and flushes delayed packets. Call
+    // every frame.
+    void poll(std::int64_t nowNs);
+
+    bool connected() const { return m_rollback != nullptr; }
+    bool isHost() const { return m_isHost; }
+    std::uint16_t localPort() const { return m_socket.localPort(); }
+
+    // Steps one tick with the local input and sends it. False while not
+    // connected or stalled waiting for the peer.
+    bool advance(std::int8_t localAxis, std::int64_t nowNs);
+
+    // Null until connected
+    const RollbackSession* rollback() const { return m_rollback.get(); }
+    RollbackSession* rollback() { return m_rollback.get(); }
+    const Stats& stats() const { return m_stats; }
+    float tickDt() const { return m_dt; }
+
+private:
+    enum PacketType : std::uint8_t { Hello = 1, Welcome = 2, Inputs = 3 };
+
+    struct Delayed {
+        std::int64_t dueNs;
+        std::vector<unsigned char> bytes;
+    };
+
+    void handle(const unsigned char* data, int size, const UdpSocket::Address& from, std::int64_t nowNs);
+    void sendInputs(std::int64_t nowNs);
+    void send(std::vector<unsigned char> bytes, std::int64_t nowNs);
+    double random();
+
+    MatchConfig m_config;
+    float m_dt;
+    std::uint32_t m_maxPrediction;
+
+    UdpSocket m_socket;
+    UdpSocket::Address m_peer;
+    bool m_isHost = false;
+    bool m_hasPeer = false;
+    std::uint64_t m_seed = 0;
+    std::int64_t m_lastHelloNs = 0;
+    std::int64_t m_lastSendNs = 0;
+
+    std::unique_ptr<RollbackSession> m_rollback;
+    std::uint32_t m_peerAck = 0;  // next tick of our inputs the peer is missing
+
+    Conditions m_conditions;
+    std::uint64_t m_rng = 0;
+    std::vector<Delayed> m_delayed;
+    Stats m_stats;
+};
+
+}  // namespace sim
@@ -0,0 +1,95 @@
+#include "OffscreenContext.h"
+#include <glad/glad.h>
+#include <EGL/egl.h>
+#include <EGL/eglext.h>
+#include <cstring>
+
+OffscreenContext::~OffscreenContext() {
+    if (!m_display) return;
+    EGLDisplay display = static_cast<EGLDisplay>(m_display);
+    eglMakeCurrent(display, EGL_NO_SURFACE, EGL_NO_SURFACE, EGL_NO_CONTEXT);
+    if (m_context) eglDestroyContext(display, static_cast<EGLContext>(m_context));
+    if (m_surface) eglDestroySurface(display, static_cast<EGLSurface>(m_surface));
+    eglTerminate(display);
+}
+
+static EGLDisplay openDisplay() {
+    const char* clientExtensions = eglQueryString(EGL_NO_DISPLAY, EGL_EXTENSIONS);
+    if (clientExtensions && std::strstr(clientExtensions, "EGL_MESA_platform_surfaceless")) {
+        auto getPlatformDisplay = reinterpret_cast<PFNEGLGETPLATFORMDISPLAYEXTPROC>(
+            eglGetProcAddress("eglGetPlatformDisplayEXT"));
+        if (getPlatformDisplay) {
+            EGLDisplay display = getPlatformDisplay(EGL_PLATFORM_SURFACELESS_MESA, EGL_DEFAULT_DISPLAY, nullptr);
+            if (display != EGL_NO_DISPLAY && eglInitialize(display, nullptr, nullptr)) return display;
+        }
+    }
+    EGLDisplay display = eglGetDisplay(EGL_DEFAULT_DISPLAY);
+    if (display != EGL_NO_DISPLAY && eglInitialize(display, nullptr, nullptr)) return display;
+    return EGL_NO_DISPLAY;
+}
+
+bool OffscreenContext::create(std::string& error) {
+    EGLDisplay display = openDisplay();
+    if (display == EGL_NO_DISPLAY) {
+        error = "no EGL display";
+        return false;
+    }
+    m_display = display;
+
+    if (!eglBindAPI(EGL_OPENGL_API)) {
+        error = "EGL has no desktop OpenGL";
+        return false;
+    }
+
+    // A 1x1 pbuffer if the platform offers one, otherwise surfaceless
+    EGLint configAttribs[] = {
+        EGL_SURFACE_TYPE, EGL_PBUFFER_BIT,
+        EGL_RENDERABLE_TYPE, EGL_OPENGL_BIT,
+        EGL_RED_SIZE, 8, EGL_GREEN_SIZE, 8, EGL_BLUE_SIZE, 8,
+        EGL_NONE
+    };
+    EGLConfig config = nullptr;
+    EGLint count = 0;
+    bool pbuffer = eglChooseConfig(display, configAttribs, &config, 1, &count) && count > 0;
+    if (!pbuffer) {
+        configAttribs[1] = 0;
+        if (!eglChooseConfig(display, configAttribs, &config, 1, &count) || count == 0) {
+            error = "no EGL config with desktop OpenGL";
+            return false;
+        }
+    }
+
+    const EGLint contextAttribs[] = {
+        EGL_CONTEXT_MAJOR_VERSION, 3,
+        EGL_CONTEXT_MINOR_VERSION, 3,
+        EGL_CONTEXT_OPENGL_PROFILE_MASK, EGL_CONTEXT_OPENGL_CORE_PROFILE_BIT,
+        EGL_NONE
+    };
+    EGLContext context = eglCreateContext(display, config, EGL_NO_CONTEXT, contextAttribs);
+    if (context == EGL_NO_CONTEXT) {
+        error = "cannot create an OpenGL 3.3 core context";
+        return false;
+    }
+    m_context = context;
+
+    EGLSurface surface = EGL_NO_SURFACE;
+    if (pbuffer) {
+        const EGLint surfaceAttribs[] = {EGL_WIDTH, 1, EGL_HEIGHT, 1, EGL_NONE};
+        surface = eglCreatePbufferSurface(display, config, surfaceAttribs);
+        m_surface = surface != EGL_NO_SURFACE ? surface : nullptr;
+    }
+    if (!eglMakeCurrent(display, surface, surface, context)) {
+        error = "eglMakeCurrent failed";
+        return false;
+    }
+    return true;
+}
+
+void* OffscreenContext::getProcAddress(const char* name) {
+    return reinterpret_cast<void*>(eglGetProcAddress(name));
+}
+
+std::string OffscreenContext::rendererName() const {
+    const GLubyte* name = glGetString(GL_RENDERER);
+    return name ? reinterpret_cast<const char*>(name) : "unknown";
+}
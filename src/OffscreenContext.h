@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+
+// OpenGL 3.3 core context without a window system, via EGL. Prefers Mesa's
+// surfaceless platform (works on llvmpipe with no X/Wayland/GPU) and falls
+// back to the default display. Render into an FBO; there is no default
+// framebuffer worth drawing to.
+class OffscreenContext {
+public:
+    OffscreenContext() = default;
+    ~OffscreenContext();
+
+    OffscreenContext(const OffscreenContext&) = delete;
+    OffscreenContext& operator=(const OffscreenContext&) = delete;
+
+    // Creates the context and makes it current on the calling thread
+    bool create(std::string& error);
+
+    // For gladLoadGLLoader
+    static void* getProcAddress(const char* name);
+
+    std::string rendererName() const;
+
+private:
+    void* m_display = nullptr;
+    void* m_context = nullptr;
+    void* m_surface = nullptr;
+};
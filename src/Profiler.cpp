@@ -0,0 +1,167 @@
+#include "Profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+
+namespace {
+
+std::int64_t steadyNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// Log-linear buckets: values 0-7 exactly, then 8 buckets per power of two
+// (at most 12.5% wide)
+int bucketOf(std::uint64_t v) {
+    if (v < 8) return static_cast<int>(v);
+    int e = 63;
+    while (!(v >> e)) --e;
+    return (e - 3) * 8 + static_cast<int>(v >> (e - 3));
+}
+
+std::uint64_t bucketUpper(int b) {
+    if (b < 8) return static_cast<std::uint64_t>(b);
+    int e = b / 8 + 2;
+    std::uint64_t m = static_cast<std::uint64_t>(b % 8 + 8);
+    return ((m + 1) << (e - 3)) - 1;
+}
+
+void writeEscaped(std::ostream& out, const std::string& s) {
+    for (char c : s) {
+        if (c == '"' || c == '\\') out << '\\';
+        out << c;
+    }
+}
+
+}  // namespace
+
+Profiler::Profiler(bool enabled)
+    : m_enabled(enabled), m_phases(new Phase[MaxPhases]), m_origin(steadyNs()) {
+    for (int p = 0; p < MaxPhases; ++p)
+        for (std::atomic<std::uint64_t>& b : m_phases[p].buckets) b.store(0, std::memory_order_relaxed);
+}
+
+int Profiler::addPhase(const char* name, Kind kind, int track) {
+    if (m_phaseCount >= MaxPhases) return -1;
+    Phase& phase = m_phases[m_phaseCount];
+    phase.name = name;
+    phase.kind = kind;
+    phase.track = track;
+    return m_phaseCount++;
+}
+
+std::uint64_t Profiler::now() const {
+    return static_cast<std::uint64_t>(steadyNs() - m_origin);
+}
+
+void Profiler::record(int index, std::uint64_t start, std::uint64_t value) {
+    if (!enabled() || index < 0 || index >= m_phaseCount) return;
+    Phase& phase = m_phases[index];
+
+    // Single writer per phase. The release fence orders the slot write after
+    // the head that covers its previous contents (see recent()), then the new
+    // head is published.
+    std::uint64_t head = phase.head.load(std::memory_order_relaxed);
+    Phase::Slot& slot = phase.ring[head & (RingSize - 1)];
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.start.store(start, std::memory_order_relaxed);
+    slot.value.store(value, std::memory_order_relaxed);
+    phase.head.store(head + 1, std::memory_order_release);
+
+    phase.buckets[bucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+    phase.sum.fetch_add(value, std::memory_order_relaxed);
+    if (value > phase.max.load(std::memory_order_relaxed)) phase.max.store(value, std::memory_order_relaxed);
+}
+
+Profiler::Summary Profiler::summary(int index) const {
+    Summary s;
+    if (index < 0 || index >= m_phaseCount) return s;
+    const Phase& phase = m_phases[index];
+    s.name = phase.name;
+    s.kind = phase.kind;
+    s.track = phase.track;
+
+    std::uint64_t counts[BucketCount];
+    for (int b = 0; b < BucketCount; ++b) {
+        counts[b] = phase.buckets[b].load(std::memory_order_relaxed);
+        s.count += counts[b];
+    }
+    if (s.count == 0) return s;
+
+    const double scale = phase.kind == Duration ? 1e-3 : 1.0;
+    auto percentile = [&](double q) {
+        std::uint64_t rank = static_cast<std::uint64_t>(q * static_cast<double>(s.count - 1)) + 1;
+        std::uint64_t seen = 0;
+        for (int b = 0; b < BucketCount; ++b) {
+            seen += counts[b];
+            if (seen >= rank) return static_cast<double>(bucketUpper(b));
+        }
+        return 0.0;
+    };
+    double max = static_cast<double>(phase.max.load(std::memory_order_relaxed));
+    s.mean = static_cast<double>(phase.sum.load(std::memory_order_relaxed)) / s.count * scale;
+    s.p50 = std::min(percentile(0.50), max) * scale;
+    s.p99 = std::min(percentile(0.99), max) * scale;
+    s.max = max * scale;
+    return s;
+}
+
+std::vector<Profiler::Sample> Profiler::recent(int index, std::size_t max) const {
+    std::vector<Sample> out;
+    if (index < 0 || index >= m_phaseCount) return out;
+    const Phase& phase = m_phases[index];
+    std::uint64_t head = phase.head.load(std::memory_order_acquire);
+    std::uint64_t n = std::min<std::uint64_t>({head, RingSize, max});
+    out.reserve(static_cast<std::size_t>(n));
+    for (std::uint64_t i = head - n; i < head; ++i) {
+        const Phase::Slot& slot = phase.ring[i & (RingSize - 1)];
+        out.push_back({slot.start.load(std::memory_order_relaxed), slot.value.load(std::memory_order_relaxed)});
+    }
+
+    // Sample i's slot is rewritten by sample i + RingSize, which starts once
+    // the head reaches i + RingSize. A head read after the copies (the fences
+    // pair with record()'s) shows every slot that may have changed; drop them.
+    std::atomic_thread_fence(std::memory_order_acquire);
+    std::uint64_t after = phase.head.load(std::memory_order_relaxed);
+    std::uint64_t firstValid = after >= RingSize ? after - RingSize + 1 : 0;
+    std::uint64_t first = head - n;
+    if (firstValid > first)
+        out.erase(out.begin(), out.begin() + static_cast<std::ptrdiff_t>(std::min(firstValid - first, n)));
+    return out;
+}
+
+// Chrome trace event format (chrome://tracing, Perfetto): durations become
+// complete ("X") events, counters become counter ("C") events
+bool Profiler::writeChromeTrace(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out) return false;
+    out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+    bool first = true;
+    for (int p = 0; p < m_phaseCount; ++p) {
+        const Phase& phase = m_phases[p];
+        for (const Sample& s : recent(p)) {
+            out << (first ? "" : ",\n") << "{\"name\":\"";
+            writeEscaped(out, phase.name);
+            out << "\",\"pid\":1,\"tid\":" << phase.track << ",\"ts\":" << s.start / 1000.0;
+            if (phase.kind == Duration)
+                out << ",\"ph\":\"X\",\"dur\":" << s.value / 1000.0 << "}";
+            else
+                out << ",\"ph\":\"C\",\"args\":{\"value\":" << s.value << "}}";
+            first = false;
+        }
+    }
+    out << "\n]}\n";
+    return static_cast<bool>(out);
+}
+
+bool Profiler::writeCsv(const std::string& path) const {
+    std::ofstream out(path);
+    if (!out) return false;
+    out << "phase,kind,count,mean,p50,p99,max\n";
+    for (int p = 0; p < m_phaseCount; ++p) {
+        Summary s = summary(p);
+        out << s.name << ',' << (s.kind == Duration ? "us" : "count") << ',' << s.count << ','
+            << s.mean << ',' << s.p50 << ',' << s.p99 << ',' << s.max << '\n';
+    }
+    return static_cast<bool>(out);
+}
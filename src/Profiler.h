@@ -0,0 +1,101 @@
+#pragma once
+
+// Low-overhead frame profiler. Each registered phase keeps
+//  - a fixed-size ring of its most recent samples (start time + value), and
+//  - a log-linear histogram over the whole run for p50/p99/max.
+// Both are lock-free; every phase must be recorded from a single thread, but
+// any thread may read summaries or export while it runs. Ring slots are
+// atomics, and recent() drops any slot the writer may have overwritten while
+// it was being copied, so exports never contain torn samples.
+//
+// Durations are stored in nanoseconds, counters as raw values.
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+class Profiler {
+public:
+    enum Kind { Duration, Counter };
+
+    static const int MaxPhases = 16;
+    static const std::size_t RingSize = 4096;  // power of two
+    static const int BucketCount = 496;        // 8 sub-buckets per power of two of a u64
+
+    struct Sample {
+        std::uint64_t start;  // ns since the profiler was created
+        std::uint64_t value;  // ns for durations
+    };
+
+    struct Summary {
+        std::string name;
+        Kind kind = Duration;
+        int track = 0;
+        std::uint64_t count = 0;
+        double mean = 0, p50 = 0, p99 = 0, max = 0;  // microseconds for durations
+    };
+
+    explicit Profiler(bool enabled = false);
+
+    // Recording is a no-op while disabled
+    void setEnabled(bool enabled) { m_enabled.store(enabled, std::memory_order_relaxed); }
+    bool enabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    // Returns the phase id, or -1 once MaxPhases are taken. `track` becomes
+    // the trace's thread id so e.g. GPU timings get their own row.
+    int addPhase(const char* name, Kind kind = Duration, int track = 0);
+
+    std::uint64_t now() const;
+    void record(int phase, std::uint64_t start, std::uint64_t value);
+    void count(int phase, std::uint64_t value) { record(phase, now(), value); }
+
+    Summary summary(int phase) const;
+    // Up to `max` most recent samples, oldest first
+    std::vector<Sample> recent(int phase, std::size_t max = RingSize) const;
+    int phaseCount() const { return m_phaseCount; }
+
+    bool writeChromeTrace(const std::string& path) const;
+    bool writeCsv(const std::string& path) const;
+
+private:
+    struct Phase {
+        std::string name;
+        Kind kind = Duration;
+        int track = 0;
+        struct Slot {
+            std::atomic<std::uint64_t> start{0};
+            std::atomic<std::uint64_t> value{0};
+        };
+        Slot ring[RingSize];
+        std::atomic<std::uint64_t> head{0};
+        std::atomic<std::uint64_t> buckets[BucketCount];
+        std::atomic<std::uint64_t> sum{0};
+        std::atomic<std::uint64_t> max{0};
+    };
+
+    std::atomic<bool> m_enabled;
+    int m_phaseCount = 0;
+    std::unique_ptr<Phase[]> m_phases;
+    std::int64_t m_origin;
+};
+
+// Records the lifetime of the scope as one sample of `phase`.
+class ScopedTimer {
+public:
+    ScopedTimer(Profiler& profiler, int phase)
+        : m_profiler(profiler), m_phase(phase), m_start(profiler.enabled() ? profiler.now() : 0) {}
+    ~ScopedTimer() {
+        if (m_profiler.enabled()) m_profiler.record(m_phase, m_start, m_profiler.now() - m_start);
+    }
+
+    ScopedTimer(const ScopedTimer&) = delete;
+    ScopedTimer& operator=(const ScopedTimer&) = delete;
+
+private:
+    Profiler& m_profiler;
+    int m_phase;
+    std::uint64_t m_start;
+};
@@ -0,0 +1,51 @@
+#include "ProfilerOverlay.h"
+#include <algorithm>
+
+static const int GraphFrames = 120;
+static const float BarWidth = 0.1f;
+static const float UnitsPerMs = 0.15f;  // 60 Hz budget = 2.5 units
+static const float MaxBarHeight = 6.0f;
+static const float BudgetMs = 1000.0f / 60.0f;
+static const float Z = 5.0f;
+
+static const glm::vec3 PhaseColors[] = {
+    {0.3f, 0.8f, 1.0f}, {1.0f, 0.8f, 0.2f}, {0.6f, 1.0f, 0.4f}, {1.0f, 0.4f, 0.8f},
+    {0.7f, 0.6f, 1.0f}, {1.0f, 0.6f, 0.3f}, {0.8f, 0.8f, 0.8f}, {0.4f, 1.0f, 0.9f},
+};
+
+static float barHeight(std::uint64_t ns) {
+    return std::min(ns * 1e-6f * UnitsPerMs, MaxBarHeight);
+}
+
+void ProfilerOverlay::draw(Renderer& renderer, const Profiler& profiler, float left, float bottom) const {
+    const float graphW = GraphFrames * BarWidth;
+    renderer.drawRectFilled(left - 0.2f, bottom - 0.2f, left + graphW + 1.2f, bottom + MaxBarHeight + 0.2f,
+                            Z - 0.01f, glm::vec3(0.05f, 0.05f, 0.08f));
+
+    std::vector<Profiler::Sample> frames = profiler.recent(m_framePhase, GraphFrames);
+    float x = left + (GraphFrames - static_cast<float>(frames.size())) * BarWidth;
+    for (const Profiler::Sample& s : frames) {
+        bool over = s.value * 1e-6f > BudgetMs;
+        glm::vec3 color = over ? glm::vec3(1.0f, 0.2f, 0.2f) : glm::vec3(0.2f, 0.9f, 0.3f);
+        renderer.drawRectFilled(x, bottom, x + BarWidth * 0.8f, bottom + barHeight(s.value), Z, color);
+        x += BarWidth;
+    }
+
+    // Budget line
+    float budgetY = bottom + BudgetMs * UnitsPerMs;
+    renderer.drawRectFilled(left, budgetY - 0.02f, left + graphW, budgetY + 0.02f, Z + 0.01f,
+                            glm::vec3(1.0f, 1.0f, 1.0f));
+
+    // Latest frame broken down by phase
+    float y = bottom;
+    float stackLeft = left + graphW + 0.3f;
+    for (std::size_t i = 0; i < m_stackPhases.size(); ++i) {
+        std::vector<Profiler::Sample> last = profiler.recent(m_stackPhases[i], 1);
+        if (last.empty()) continue;
+        float h = std::min(barHeight(last[0].value), bottom + MaxBarHeight - y);
+        if (h <= 0.0f) break;
+        const glm::vec3& color = PhaseColors[i % (sizeof(PhaseColors) / sizeof(PhaseColors[0]))];
+        renderer.drawRectFilled(stackLeft, y, stackLeft + 0.7f, y + h, Z, color);
+        y += h;
+    }
+}
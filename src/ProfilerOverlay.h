@@ -0,0 +1,22 @@
+#pragma once
+
+#include "Profiler.h"
+#include "Renderer.h"
+#include <vector>
+
+// On-screen frame-time graph drawn with renderer rects: one bar per recent
+// frame (red past the 60 Hz budget) and, beside it, the latest sample of
+// each phase stacked in its own colour.
+class ProfilerOverlay {
+public:
+    ProfilerOverlay() = default;
+    ProfilerOverlay(int framePhase, std::vector<int> stackPhases)
+        : m_framePhase(framePhase), m_stackPhases(std::move(stackPhases)) {}
+
+    // Bottom-left corner in world units; drawn in front of the scene
+    void draw(Renderer& renderer, const Profiler& profiler, float left, float bottom) const;
+
+private:
+    int m_framePhase = -1;
+    std::vector<int> m_stackPhases;
+};
@@ -0,0 +1,179 @@
+#include "ProgramCache.h"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <iostream>
+#include <system_error>
+#include <vector>
+
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+
+namespace {
+
+const char Magic[4] = {'C', 'P', 'P', 'B'};
+const std::uint32_t FormatVersion = 1;
+
+// Precedes the driver's binary in every entry
+struct EntryHeader {
+    char magic[4];
+    std::uint32_t version;
+    std::uint64_t driverHash;  // guards against a hash collision in the file name
+    std::uint32_t binaryFormat;
+    std::uint32_t binaryLength;
+};
+
+std::uint64_t fnv1a(const void* data, std::size_t size, std::uint64_t hash) {
+    const unsigned char* bytes = static_cast<const unsigned char*>(data);
+    for (std::size_t i = 0; i < size; ++i) hash = (hash ^ bytes[i]) * 0x100000001B3ULL;
+    return hash;
+}
+
+std::uint64_t hashString(const std::string& text, std::uint64_t hash) {
+    // The length separates fields, so "ab"+"c" and "a"+"bc" differ
+    std::uint64_t size = text.size();
+    hash = fnv1a(&size, sizeof(size), hash);
+    return fnv1a(text.data(), text.size(), hash);
+}
+
+std::string glString(GLenum name) {
+    const GLubyte* value = glGetString(name);
+    return value ? reinterpret_cast<const char*>(value) : "";
+}
+
+}  // namespace
+
+ProgramCache::ProgramCache(GLADloadproc loader, const std::string& directory) : m_directory(directory) {
+    m_getProgramBinary = reinterpret_cast<GetProgramBinaryProc>(loader("glGetProgramBinary"));
+    m_programBinary = reinterpret_cast<ProgramBinaryProc>(loader("glProgramBinary"));
+    m_programParameteri = reinterpret_cast<ProgramParameteriProc>(loader("glProgramParameteri"));
+    if (!m_getProgramBinary || !m_programBinary || !m_programParameteri || m_directory.empty()) return;
+
+    GLint formats = 0;
+    glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &formats);
+    if (formats <= 0) return;
+
+    std::error_code ec;
+    std::filesystem::create_directories(m_directory, ec);
+    if (ec) {
+        std::cerr << "Program cache: cannot create " << m_directory << ": " << ec.message() << "\n";
+        return;
+    }
+
+    std::uint64_t hash = 0xCBF29CE484222325ULL;
+    hash = hashString(glString(GL_VENDOR), hash);
+    hash = hashString(glString(GL_RENDERER), hash);
+    hash = hashString(glString(GL_VERSION), hash);
+    hash = hashString(glString(GL_SHADING_LANGUAGE_VERSION), hash);
+    m_driverHash = hash;
+    m_enabled = true;
+}
+
+std::string ProgramCache::entryPath(const std::string& vertexSource, const std::string& fragmentSource) const {
+    std::uint64_t key = hashString(fragmentSource, hashString(vertexSource, m_driverHash));
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.bin", static_cast<unsigned long long>(key));
+    return (std::filesystem::path(m_directory) / name).string();
+}
+
+GLuint ProgramCache::load(const std::string& vertexSource, const std::string& fragmentSource) {
+    if (!m_enabled) return 0;
+
+    std::FILE* file = std::fopen(entryPath(vertexSource, fragmentSource).c_str(), "rb");
+    if (!file) {
+        m_stats.misses++;
+        return 0;
+    }
+    EntryHeader header;
+    std::vector<unsigned char> binary;
+    bool valid = std::fread(&header, sizeof(header), 1, file) == 1 &&
+                 std::memcmp(header.magic, Magic, sizeof(Magic)) == 0 && header.version == FormatVersion &&
+                 header.driverHash == m_driverHash && header.binaryLength > 0;
+    if (valid) {
+        binary.resize(header.binaryLength);
+        valid = std::fread(binary.data(), 1, binary.size(), file) == binary.size();
+    }
+    std::fclose(file);
+    if (!valid) {
+        m_stats.misses++;
+        return 0;
+    }
+
+    // Drivers may refuse their own binaries after an update the version
+    // string does not show; that is reported as a failed link, not an error
+    GLuint program = glCreateProgram();
+    m_programBinary(program, header.binaryFormat, binary.data(), static_cast<GLsizei>(binary.size()));
+    GLint linked = GL_FALSE;
+    glGetProgramiv(program, GL_LINK_STATUS, &linked);
+    if (!linked) {
+        glDeleteProgram(program);
+        m_stats.rejected++;
+        return 0;
+    }
+    m_stats.hits++;
+    return program;
+}
+
+void ProgramCache::prepare(GLuint program) {
+    if (m_enabled) m_programParameteri(program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+}
+
+void ProgramCache::store(GLuint program, const std::string& vertexSource, const std::string& fragmentSource) {
+    if (!m_enabled) return;
+
+    GLint length = 0;
+    glGetProgramiv(program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0) return;
+    std::vector<unsigned char> binary(static_cast<std::size_t>(length));
+    GLenum format = 0;
+    GLsizei written = 0;
+    m_getProgramBinary(program, length, &written, &format, binary.data());
+    if (written <= 0) return;
+
+    EntryHeader header;
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = FormatVersion;
+    header.driverHash = m_driverHash;
+    header.binaryFormat = format;
+    header.binaryLength = static_cast<std::uint32_t>(written);
+
+    // Written aside and renamed into place, so a crash mid-write or a second
+    // instance starting up never reads a torn entry
+    std::string path = entryPath(vertexSource, fragmentSource);
+    std::string temp = path + ".tmp";
+    std::FILE* file = std::fopen(temp.c_str(), "wb");
+    if (!file) return;
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1 &&
+              std::fwrite(binary.data(), 1, header.binaryLength, file) == header.binaryLength;
+    ok = std::fclose(file) == 0 && ok;
+    std::error_code ec;
+    if (ok) std::filesystem::rename(temp, path, ec);
+    if (!ok || ec) {
+        std::filesystem::remove(temp, ec);
+        return;
+    }
+    m_stats.stored++;
+}
+
+std::string ProgramCache::defaultDirectory() {
+#if defined(_WIN32)
+    const char* base = std::getenv("LOCALAPPDATA");
+    return base && *base ? (std::filesystem::path(base) / "CPong" / "programs").string() : std::string();
+#elif defined(__APPLE__)
+    const char* home = std::getenv("HOME");
+    return home && *home ? std::string(home) + "/Library/Caches/CPong/programs" : std::string();
+#else
+    const char* base = std::getenv("XDG_CACHE_HOME");
+    if (base && *base) return std::string(base) + "/cpong/programs";
+    const char* home = std::getenv("HOME");
+    return home && *home ? std::string(home) + "/.cache/cpong/programs" : std::string();
+#endif
+}
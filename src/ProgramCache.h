@@ -0,0 +1,63 @@
+#pragma once
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <string>
+
+// Linked shader programs kept on disk as driver binaries (glGetProgramBinary),
+// so a warm start skips GLSL compilation. Entries are keyed by a hash of the
+// driver's vendor, renderer and version strings plus both sources: a driver
+// update or a shader edit simply misses. A binary the driver rejects is a miss
+// too, and the caller compiles from source and stores the result again.
+//
+// The entry points are core in GL 4.1 and ARB_get_program_binary; the 3.3
+// loader does not fetch them, so they are resolved here. Without them, or
+// when the driver reports no binary formats, load() always misses and
+// store() does nothing.
+class ProgramCache {
+public:
+    struct Stats {
+        unsigned hits = 0;
+        unsigned misses = 0;
+        unsigned rejected = 0;  // found on disk, refused by the driver
+        unsigned stored = 0;
+    };
+
+    // Needs a current context. Creates `directory` if missing.
+    ProgramCache(GLADloadproc loader, const std::string& directory);
+
+    ProgramCache(const ProgramCache&) = delete;
+    ProgramCache& operator=(const ProgramCache&) = delete;
+
+    bool enabled() const { return m_enabled; }
+    const std::string& directory() const { return m_directory; }
+
+    // A linked program for these sources, or 0 on a miss
+    GLuint load(const std::string& vertexSource, const std::string& fragmentSource);
+    // Before glLinkProgram on a program that will be stored
+    void prepare(GLuint program);
+    // Writes a successfully linked program's binary
+    void store(GLuint program, const std::string& vertexSource, const std::string& fragmentSource);
+
+    const Stats& stats() const { return m_stats; }
+
+    // Per-user location: %LOCALAPPDATA%\CPong\programs, ~/Library/Caches/
+    // CPong/programs or $XDG_CACHE_HOME/cpong/programs (default ~/.cache).
+    // Empty if none is known.
+    static std::string defaultDirectory();
+
+private:
+    typedef void(APIENTRY* GetProgramBinaryProc)(GLuint, GLsizei, GLsizei*, GLenum*, void*);
+    typedef void(APIENTRY* ProgramBinaryProc)(GLuint, GLenum, const void*, GLsizei);
+    typedef void(APIENTRY* ProgramParameteriProc)(GLuint, GLenum, GLint);
+
+    std::string entryPath(const std::string& vertexSource, const std::string& fragmentSource) const;
+
+    GetProgramBinaryProc m_getProgramBinary = nullptr;
+    ProgramBinaryProc m_programBinary = nullptr;
+    ProgramParameteriProc m_programParameteri = nullptr;
+    bool m_enabled = false;
+    std::string m_directory;
+    std::uint64_t m_driverHash = 0;
+    Stats m_stats;
+};
@@ -1,110 +1,248 @@
 #include "Renderer.h"
 #include "Shader.h"
 #include <glm/gtc/matrix_transform.hpp>
+#include <algorithm>
 #include <cmath>
+#include <cstddef>
 #include <iostream>
 
-// Cube vertices (position only)
-static const float cubeVertices[] = {
-    -0.5f, -0.5f, -0.5f,  0.5f, -0.5f, -0.5f,  0.5f,  0.5f, -0.5f,  0.5f,  0.5f, -0.5f, -0.5f,  0.5f, -0.5f, -0.5f, -0.5f, -0.5f,
-    -0.5f, -0.5f,  0.5f,  0.5f, -0.5f,  0.5f,  0.5f,  0.5f,  0.5f,  0.5f,  0.5f,  0.5f, -0.5f,  0.5f,  0.5f, -0.5f, -0.5f,  0.5f,
-    -0.5f,  0.5f,  0.5f, -0.5f,  0.5f, -0.5f, -0.5f, -0.5f, -0.5f, -0.5f, -0.5f, -0.5f, -0.5f, -0.5f,  0.5f, -0.5f,  0.5f,  0.5f,
-     0.5f,  0.5f,  0.5f,  0.5f,  0.5f, -0.5f,  0.5f, -0.5f, -0.5f,  0.5f, -0.5f, -0.5f,  0.5f, -0.5f,  0.5f,  0.5f,  0.5f,  0.5f,
-    -0.5f, -0.5f, -0.5f,  0.5f, -0.5f, -0.5f,  0.5f, -0.5f,  0.5f,  0.5f, -0.5f,  0.5f, -0.5f, -0.5f,  0.5f, -0.5f, -0.5f, -0.5f,
-    -0.5f,  0.5f, -0.5f,  0.5f,  0.5f, -0.5f,  0.5f,  0.5f,  0.5f,  0.5f,  0.5f,  0.5f, -0.5f,  0.5f,  0.5f, -0.5f,  0.5f, -0.5f
+// Unit cube, 8 corners; two triangles per face
+static const std::vector<glm::vec3> cubeVertices = {
+    {-0.5f, -0.5f, -0.5f}, {0.5f, -0.5f, -0.5f}, {0.5f, 0.5f, -0.5f}, {-0.5f, 0.5f, -0.5f},
+    {-0.5f, -0.5f,  0.5f}, {0.5f, -0.5f,  0.5f}, {0.5f, 0.5f,  0.5f}, {-0.5f, 0.5f,  0.5f}
+};
+static const std::vector<std::uint16_t> cubeIndices = {
+    0, 1, 2, 2, 3, 0,  4, 5, 6, 6, 7, 4,  7, 3, 0, 0, 4, 7,
+    6, 2, 1, 1, 5, 6,  0, 1, 5, 5, 4, 0,  3, 2, 6, 6, 7, 3
 };
 
-// Quad vertices (flat rectangle)
-static const float quadVertices[] = {
-    -0.5f, -0.5f, 0.0f,  0.5f, -0.5f, 0.0f,  0.5f,  0.5f, 0.0f,
-     0.5f,  0.5f, 0.0f, -0.5f,  0.5f, 0.0f, -0.5f, -0.5f, 0.0f
+// Flat rectangle
+static const std::vector<glm::vec3> quadVertices = {
+    {-0.5f, -0.5f, 0.0f}, {0.5f, -0.5f, 0.0f}, {0.5f, 0.5f, 0.0f}, {-0.5f, 0.5f, 0.0f}
 };
+static const std::vector<std::uint16_t> quadIndices = {0, 1, 2, 2, 3, 0};
 
 // Unit rect for line outline (0,0)-(1,1), GL_LINE_LOOP
-static const float lineRectVertices[] = {
-    0.0f, 0.0f, 0.0f,  1.0f, 0.0f, 0.0f,  1.0f, 1.0f, 0.0f,  0.0f, 1.0f, 0.0f
+static const std::vector<glm::vec3> lineRectVertices = {
+    {0.0f, 0.0f, 0.0f}, {1.0f, 0.0f, 0.0f}, {1.0f, 1.0f, 0.0f}, {0.0f, 1.0f, 0.0f}
 };
 
 // Unit cube top face outline (-0.5 to 0.5), GL_LINE_LOOP - matches paddle/cube local space
-static const float cubeTopFaceVertices[] = {
-     0.5f,  0.5f, 0.5f,  -0.5f,  0.5f, 0.5f,  -0.5f, -0.5f, 0.5f,   0.5f, -0.5f, 0.5f
+static const std::vector<glm::vec3> cubeTopFaceVertices = {
+    {0.5f, 0.5f, 0.5f}, {-0.5f, 0.5f, 0.5f}, {-0.5f, -0.5f, 0.5f}, {0.5f, -0.5f, 0.5f}
 };
+static const std::vector<std::uint16_t> loopIndices = {0, 1, 2, 3};
+
+static const GLsizei TexelsPerInstance = sizeof(glm::mat4) / sizeof(glm::vec4) + 1;
+
+Renderer::Renderer(GLState& gl, ProgramCache* programCache)
+    : gl(gl), shader(gl, "shaders/vertex.glsl", "shaders/fragment.glsl", programCache) {
+    instanceBaseUniform = shader.intUniform("instanceBase");
+    shader.use();
+    shader.set(shader.intUniform("instances"), 0);  // texture unit 0
+    setupCamera();
+
+    // GL 3.3 guarantees 65536 texels
+    GLint maxTexels = 0;
+    glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &maxTexels);
+    maxInstances = std::max<GLint>(maxTexels, 65536) / TexelsPerInstance;
+
+    // Position only at location 0; the index buffer is VAO state
+    glGenVertexArrays(1, &vao);
+    glGenBuffers(1, &vertexBuffer);
+    glGenBuffers(1, &indexBuffer);
+    gl.bindVertexArray(vao);
+    gl.bindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, sizeof(glm::vec3), nullptr);
+    glEnableVertexAttribArray(0);
+    gl.bindBuffer(GL_ELEMENT_ARRAY_BUFFER, indexBuffer);
+    gl.bindVertexArray(0);
 
-Renderer::Renderer() : cubeVAO(0), cubeVBO(0), quadVAO(0), quadVBO(0), lineVAO(0), lineVBO(0), cubeOutlineVAO(0), cubeOutlineVBO(0), shaderProgram(0) {
-    loadShader();
-    setupCube();
-    setupQuad();
-    setupLineRect();
+    frameStream = createStream();
+    retainedStream = createStream();
+
+    addMesh(cubeVertices, cubeIndices, GL_TRIANGLES);
+    addMesh(quadVertices, quadIndices, GL_TRIANGLES);
+    addMesh(lineRectVertices, loopIndices, GL_LINE_LOOP);
+    addMesh(cubeTopFaceVertices, loopIndices, GL_LINE_LOOP);
 }
 
 Renderer::~Renderer() {
-    glDeleteVertexArrays(1, &cubeVAO);
-    glDeleteBuffers(1, &cubeVBO);
-    glDeleteVertexArrays(1, &quadVAO);
-    glDeleteBuffers(1, &quadVBO);
-    glDeleteVertexArrays(1, &lineVAO);
-    glDeleteBuffers(1, &lineVBO);
-    glDeleteVertexArrays(1, &cubeOutlineVAO);
-    glDeleteBuffers(1, &cubeOutlineVBO);
-    if (shaderProgram) glDeleteProgram(shaderProgram);
-}
-
-void Renderer::loadShader() {
-    Shader shader("shaders/vertex.glsl", "shaders/fragment.glsl");
-    shaderProgram = shader.ID;
-    shader.ID = 0;  // Prevent Shader destructor from deleting (we manage it)
-}
-
-void Renderer::setupCube() {
-    glGenVertexArrays(1, &cubeVAO);
-    glGenBuffers(1, &cubeVBO);
-    glBindVertexArray(cubeVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, cubeVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(cubeVertices), cubeVertices, GL_STATIC_DRAW);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), nullptr);
-    glEnableVertexAttribArray(0);
-    glBindVertexArray(0);
+    for (const InstanceStream* stream : {&frameStream, &retainedStream}) {
+        gl.deleteTexture(stream->texture);
+        gl.deleteBuffer(stream->buffer);
+    }
+    gl.deleteVertexArray(vao);
+    gl.deleteBuffer(vertexBuffer);
+    gl.deleteBuffer(indexBuffer);
+    gl.deleteBuffer(cameraUBO);
 }
 
-void Renderer::setupQuad() {
-    glGenVertexArrays(1, &quadVAO);
-    glGenBuffers(1, &quadVBO);
-    glBindVertexArray(quadVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, quadVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(quadVertices), quadVertices, GL_STATIC_DRAW);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), nullptr);
-    glEnableVertexAttribArray(0);
-    glBindVertexArray(0);
+// View and projection live in one uniform buffer shared by every program that
+// declares the Camera block; it is only written when the camera changes
+void Renderer::setupCamera() {
+    glGenBuffers(1, &cameraUBO);
+    gl.bindBuffer(GL_UNIFORM_BUFFER, cameraUBO);
+    CameraBlock identity = {glm::mat4(1.0f), glm::mat4(1.0f)};
+    glBufferData(GL_UNIFORM_BUFFER, sizeof(CameraBlock), &identity, GL_DYNAMIC_DRAW);
+    gl.bindBufferBase(GL_UNIFORM_BUFFER, CameraBinding, cameraUBO);
+    if (!shader.bindUniformBlock("Camera", CameraBinding))
+        std::cerr << "Shader has no Camera uniform block" << std::endl;
 }
 
-void Renderer::setupLineRect() {
-    glGenVertexArrays(1, &lineVAO);
-    glGenBuffers(1, &lineVBO);
-    glBindVertexArray(lineVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, lineVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(lineRectVertices), lineRectVertices, GL_STATIC_DRAW);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), nullptr);
-    glEnableVertexAttribArray(0);
-    glBindVertexArray(0);
-
-    glGenVertexArrays(1, &cubeOutlineVAO);
-    glGenBuffers(1, &cubeOutlineVBO);
-    glBindVertexArray(cubeOutlineVAO);
-    glBindBuffer(GL_ARRAY_BUFFER, cubeOutlineVBO);
-    glBufferData(GL_ARRAY_BUFFER, sizeof(cubeTopFaceVertices), cubeTopFaceVertices, GL_STATIC_DRAW);
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * sizeof(float), nullptr);
-    glEnableVertexAttribArray(0);
-    glBindVertexArray(0);
+Renderer::InstanceStream Renderer::createStream() {
+    InstanceStream stream;
+    glGenBuffers(1, &stream.buffer);
+    gl.bindBuffer(GL_TEXTURE_BUFFER, stream.buffer);
+    glBufferData(GL_TEXTURE_BUFFER, sizeof(Instance), nullptr, GL_STREAM_DRAW);
+    glGenTextures(1, &stream.texture);
+    gl.activeTexture(GL_TEXTURE0);
+    gl.bindTextureBuffer(stream.texture);
+    glTexBuffer(GL_TEXTURE_BUFFER, GL_RGBA32F, stream.buffer);
+    return stream;
+}
+
+unsigned int Renderer::addMesh(const std::vector<glm::vec3>& meshVertices, const std::vector<std::uint16_t>& meshIndices,
+                               GLenum mode) {
+    Mesh mesh;
+    mesh.mode = mode;
+    mesh.indexCount = static_cast<GLsizei>(meshIndices.size());
+    mesh.firstIndex = indices.size();
+    mesh.baseVertex = static_cast<GLint>(vertices.size());
+    vertices.insert(vertices.end(), meshVertices.begin(), meshVertices.end());
+    indices.insert(indices.end(), meshIndices.begin(), meshIndices.end());
+    meshes.push_back(mesh);
+    geometryDirty = true;
+    return static_cast<unsigned int>(meshes.size() - 1);
+}
+
+// Whole buffers are re-specified: meshes are few and added at startup
+void Renderer::uploadGeometry() {
+    gl.bindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(glm::vec3), vertices.data(), GL_STATIC_DRAW);
+    gl.bindVertexArray(vao);  // GL_ELEMENT_ARRAY_BUFFER is the VAO's
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(std::uint16_t), indices.data(), GL_STATIC_DRAW);
+    geometryDirty = false;
+}
+
+void Renderer::queue(unsigned int mesh, const glm::mat4& model, const glm::vec3& color) {
+    if (recordingLayer >= 0) {
+        Layer& layer = layers[recordingLayer];
+        if (layer.instances.size() <= mesh) layer.instances.resize(meshes.size());
+        layer.instances[mesh].push_back({model, glm::vec4(color, 1.0f)});
+        retainedDirty = true;
+    } else {
+        meshes[mesh].instances.push_back({model, glm::vec4(color, 1.0f)});
+    }
+}
+
+unsigned int Renderer::createLayer() {
+    layers.emplace_back();
+    return static_cast<unsigned int>(layers.size() - 1);
+}
+
+void Renderer::beginLayer(unsigned int layer) {
+    recordingLayer = static_cast<int>(layer);
+    for (std::vector<Instance>& old : layers[layer].instances) {
+        if (!old.empty()) retainedDirty = true;
+        old.clear();
+    }
+}
+
+void Renderer::endLayer() {
+    recordingLayer = -1;
+}
+
+// Instances past the buffer texture's size cannot be read; drop them
+GLsizei Renderer::fitInstances(GLsizei first, GLsizei count) {
+    if (first + count <= maxInstances) return count;
+    if (!warnedOverflow) {
+        std::cerr << "Renderer: more than " << maxInstances << " instances in one flush, extra ones dropped"
+                  << std::endl;
+        warnedOverflow = true;
+    }
+    return std::max<GLsizei>(0, maxInstances - first);
+}
+
+// Packs every layer's instances into the retained buffer, grouped by mesh
+void Renderer::uploadRetained() {
+    staging.clear();
+    for (std::size_t m = 0; m < meshes.size(); ++m) {
+        GLsizei first = static_cast<GLsizei>(staging.size());
+        for (const Layer& layer : layers)
+            if (m < layer.instances.size())
+                staging.insert(staging.end(), layer.instances[m].begin(), layer.instances[m].end());
+        meshes[m].retainedFirst = first;
+        meshes[m].retainedCount = fitInstances(first, static_cast<GLsizei>(staging.size()) - first);
+    }
+    gl.bindBuffer(GL_TEXTURE_BUFFER, retainedStream.buffer);
+    glBufferData(GL_TEXTURE_BUFFER, staging.size() * sizeof(Instance), staging.data(), GL_DYNAMIC_DRAW);
+    retainedDirty = false;
+}
+
+// This frame's instances of every mesh go out in one upload
+void Renderer::uploadFrame() {
+    staging.clear();
+    for (Mesh& mesh : meshes) {
+        mesh.frameFirst = static_cast<GLsizei>(staging.size());
+        mesh.frameCount = fitInstances(mesh.frameFirst, static_cast<GLsizei>(mesh.instances.size()));
+        staging.insert(staging.end(), mesh.instances.begin(), mesh.instances.end());
+        mesh.instances.clear();
+    }
+    if (staging.empty()) return;
+
+    // Orphan and refill: the driver never waits on last frame's copy
+    gl.bindBuffer(GL_TEXTURE_BUFFER, frameStream.buffer);
+    glBufferData(GL_TEXTURE_BUFFER, staging.size() * sizeof(Instance), staging.data(), GL_STREAM_DRAW);
+}
+
+// State is set, never restored: the cache drops whatever is already current
+void Renderer::drawInstances(const Mesh& mesh, GLsizei first, GLsizei count) {
+    if (mesh.mode == GL_LINES || mesh.mode == GL_LINE_LOOP || mesh.mode == GL_LINE_STRIP) gl.lineWidth(2.0f);
+    shader.set(instanceBaseUniform, first);
+    glDrawElementsInstancedBaseVertex(mesh.mode, mesh.indexCount, GL_UNSIGNED_SHORT,
+                                      reinterpret_cast<const void*>(mesh.firstIndex * sizeof(std::uint16_t)), count,
+                                      mesh.baseVertex);
+    lastDrawCalls++;
+    lastInstances += static_cast<unsigned int>(count);
+}
+
+void Renderer::flush() {
+    lastDrawCalls = 0;
+    lastInstances = 0;
+    if (geometryDirty) uploadGeometry();
+    if (retainedDirty) uploadRetained();
+    uploadFrame();
+
+    gl.setEnabled(GL_DEPTH_TEST, true);
+    gl.setEnabled(GL_BLEND, false);
+    shader.use();
+    gl.bindVertexArray(vao);
+    gl.activeTexture(GL_TEXTURE0);
+
+    // Retained first, then this frame's: one texture switch per frame
+    bool bound = false;
+    for (const Mesh& mesh : meshes) {
+        if (mesh.retainedCount == 0) continue;
+        if (!bound) gl.bindTextureBuffer(retainedStream.texture);
+        bound = true;
+        drawInstances(mesh, mesh.retainedFirst, mesh.retainedCount);
+    }
+    bound = false;
+    for (const Mesh& mesh : meshes) {
+        if (mesh.frameCount == 0) continue;
+        if (!bound) gl.bindTextureBuffer(frameStream.texture);
+        bound = true;
+        drawInstances(mesh, mesh.frameFirst, mesh.frameCount);
+    }
+}
+
+void Renderer::drawMesh(unsigned int mesh, const glm::mat4& model, const glm::vec3& color) {
+    queue(mesh, model, color);
 }
 
 void Renderer::drawModelOutline(const glm::mat4& model, const glm::vec3& color) {
-    glUseProgram(shaderProgram);
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 1, GL_FALSE, &model[0][0]);
-    glUniform3fv(glGetUniformLocation(shaderProgram, "objectColor"), 1, &color[0]);
-    glBindVertexArray(cubeOutlineVAO);
-    glLineWidth(2.0f);
-    glDrawArrays(GL_LINE_LOOP, 0, 4);
-    glLineWidth(1.0f);
+    queue(CubeOutline, model, color);
 }
 
 void Renderer::drawRectOutline(float minX, float minY, float maxX, float maxY, float z, const glm::vec3& color) {
@@ -112,14 +250,7 @@ void Renderer::drawRectOutline(float minX, float minY, float maxX, float maxY, f
     float h = maxY - minY;
     glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(minX, minY, z))
         * glm::scale(glm::mat4(1.0f), glm::vec3(w, h, 1.0f));
-
-    glUseProgram(shaderProgram);
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 1, GL_FALSE, &model[0][0]);
-    glUniform3fv(glGetUniformLocation(shaderProgram, "objectColor"), 1, &color[0]);
-    glBindVertexArray(lineVAO);
-    glLineWidth(2.0f);
-    glDrawArrays(GL_LINE_LOOP, 0, 4);
-    glLineWidth(1.0f);
+    queue(LineRect, model, color);
 }
 
 void Renderer::drawRectFilled(float minX, float minY, float maxX, float maxY, float z, const glm::vec3& color) {
@@ -129,79 +260,48 @@ void Renderer::drawRectFilled(float minX, float minY, float maxX, float maxY, fl
     float centerY = (minY + maxY) * 0.5f;
     glm::mat4 model = glm::translate(glm::mat4(1.0f), glm::vec3(centerX, centerY, z))
         * glm::scale(glm::mat4(1.0f), glm::vec3(w, h, 1.0f));
-
-    glUseProgram(shaderProgram);
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 1, GL_FALSE, &model[0][0]);
-    glUniform3fv(glGetUniformLocation(shaderProgram, "objectColor"), 1, &color[0]);
-    glBindVertexArray(quadVAO);
-    glDrawArrays(GL_TRIANGLES, 0, 6);
+    queue(Quad, model, color);
 }
 
 void Renderer::drawCube(const glm::mat4& model, const glm::vec3& color) {
-    glUseProgram(shaderProgram);
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 1, GL_FALSE, &model[0][0]);
-    glUniform3fv(glGetUniformLocation(shaderProgram, "objectColor"), 1, &color[0]);
-    glBindVertexArray(cubeVAO);
-    glDrawArrays(GL_TRIANGLES, 0, 36);
-}
-
-void Renderer::drawQuad(const glm::mat4& model, const glm::vec3& color) {
-    glUseProgram(shaderProgram);
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "model"), 1, GL_FALSE, &model[0][0]);
-    glUniform3fv(glGetUniformLocation(shaderProgram, "objectColor"), 1, &color[0]);
-    glBindVertexArray(quadVAO);
-    glDrawArrays(GL_TRIANGLES, 0, 6);
+    queue(Cube, model, color);
 }
 
-// 7-segment display: which segments are on for digits 0-9 (a,b,c,d,e,f,g)
-static const unsigned char SEGMENTS[] = {
-    0x7E, 0x30, 0x6D, 0x79, 0x33, 0x5B, 0x5F, 0x70, 0x7F, 0x7B
-};
-
-void Renderer::drawDigit(int digit, float x, float y, float size, float z, const glm::vec3& color) {
-    if (digit < 0 || digit > 9) return;
-    unsigned char seg = SEGMENTS[digit];
-    float t = size * 0.12f;
-    float w = size * 0.8f;
-    float h = size * 0.4f;
+void Renderer::drawCubes(const float* x, const float* y, std::size_t count, float z, float size,
+                         const glm::vec3& color) {
+    std::vector<Instance>* out = &meshes[Cube].instances;
+    if (recordingLayer >= 0) {
+        Layer& layer = layers[recordingLayer];
+        if (layer.instances.size() <= Cube) layer.instances.resize(meshes.size());
+        out = &layer.instances[Cube];
+        retainedDirty = true;
+    }
 
-    auto drawSeg = [this, x, y, size, z, &color](float lx, float ly, float lw, float lh) {
-        drawRectFilled(x + lx * size, y + ly * size, x + (lx + lw) * size, y + (ly + lh) * size, z, color);
-    };
-
-    if (seg & 0x40) drawSeg(0.05f, 1.15f, 0.9f, 0.12f);   // a top
-    if (seg & 0x20) drawSeg(0.83f, 0.62f, 0.12f, 0.55f);  // b top-right
-    if (seg & 0x10) drawSeg(0.83f, 0.07f, 0.12f, 0.55f);  // c bot-right
-    if (seg & 0x08) drawSeg(0.05f, 0.0f, 0.9f, 0.12f);    // d bottom
-    if (seg & 0x04) drawSeg(0.0f, 0.07f, 0.12f, 0.55f);   // e bot-left
-    if (seg & 0x02) drawSeg(0.0f, 0.62f, 0.12f, 0.55f);   // f top-left
-    if (seg & 0x01) drawSeg(0.05f, 0.575f, 0.9f, 0.12f);  // g middle
+    std::size_t first = out->size();
+    out->resize(first + count);
+    Instance instance = {glm::mat4(size), glm::vec4(color, 1.0f)};
+    instance.model[3][3] = 1.0f;
+    for (std::size_t i = 0; i < count; ++i) {
+        instance.model[3] = glm::vec4(x[i], y[i], z, 1.0f);
+        (*out)[first + i] = instance;
+    }
 }
 
-void Renderer::drawScore(int left, int right, float z, const glm::vec3& color) {
-    float digitW = 1.2f;
-    float gap = 0.5f;
-    float totalW = digitW * 4.0f + gap;
-    float x = -totalW * 0.5f;
-    float y = 5.5f;
-
-    drawDigit(left / 10, x, y, 1.0f, z, color);
-    drawDigit(left % 10, x + digitW, y, 1.0f, z, color);
-    drawRectFilled(x + digitW * 2 + gap * 0.2f, y + 0.4f, x + digitW * 2 + gap * 0.8f, y + 0.6f, z, color);
-    drawDigit(right / 10, x + digitW * 2 + gap, y, 1.0f, z, color);
-    drawDigit(right % 10, x + digitW * 3 + gap, y, 1.0f, z, color);
+void Renderer::drawQuad(const glm::mat4& model, const glm::vec3& color) {
+    queue(Quad, model, color);
 }
 
 void Renderer::setView(const glm::mat4& view) {
-    glUseProgram(shaderProgram);
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "view"), 1, GL_FALSE, &view[0][0]);
+    gl.bindBuffer(GL_UNIFORM_BUFFER, cameraUBO);
+    glBufferSubData(GL_UNIFORM_BUFFER, offsetof(CameraBlock, view), sizeof(glm::mat4), &view[0][0]);
 }
 
 void Renderer::setProjection(const glm::mat4& projection) {
-    glUseProgram(shaderProgram);
-    glUniformMatrix4fv(glGetUniformLocation(shaderProgram, "projection"), 1, GL_FALSE, &projection[0][0]);
+    gl.bindBuffer(GL_UNIFORM_BUFFER, cameraUBO);
+    glBufferSubData(GL_UNIFORM_BUFFER, offsetof(CameraBlock, projection), sizeof(glm::mat4), &projection[0][0]);
 }
 
 void Renderer::clear() {
+    gl.clearColor(0.1f, 0.1f, 0.15f, 1.0f);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 }
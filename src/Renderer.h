@@ -1,34 +1,132 @@
 #pragma once
 
+#include "GLState.h"
+#include "Shader.h"
 #include <glad/glad.h>
 #include <glm/glm.hpp>
+#include <cstddef>
+#include <cstdint>
 #include <vector>
 
+// Draw calls only queue an instance (model matrix + colour); flush() submits
+// one instanced draw per mesh, so a frame costs a handful of GL calls no
+// matter how many rects a frame is made of.
+//
+// Every mesh lives in one shared vertex and index buffer behind a single
+// VAO and is drawn by its index range and base vertex. Instances are read
+// in the vertex shader from a buffer texture at a per-draw base, so draws
+// of different meshes switch no VAO or attribute state.
+//
+// Draws issued between beginLayer()/endLayer() are retained instead: they
+// stay in a GPU buffer and are drawn every frame until the layer is rebuilt.
 class Renderer {
 public:
-    Renderer();
+    // `programCache`, if given, is used only while constructing
+    explicit Renderer(GLState& gl, ProgramCache* programCache = nullptr);
     ~Renderer();
 
+    Renderer(const Renderer&) = delete;
+    Renderer& operator=(const Renderer&) = delete;
+
+    const Shader& program() const { return shader; }
+
+    // Adds a mesh to the shared buffers (uploaded at the next flush) and
+    // returns its id for drawMesh(). `mode` is GL_TRIANGLES, GL_LINE_LOOP...
+    unsigned int addMesh(const std::vector<glm::vec3>& vertices, const std::vector<std::uint16_t>& indices,
+                         GLenum mode);
+    void drawMesh(unsigned int mesh, const glm::mat4& model, const glm::vec3& color);
+
     void drawCube(const glm::mat4& model, const glm::vec3& color);
+    // `count` axis-aligned cubes of edge `size` centred at (x[i], y[i], z):
+    // one instance each, written without building a matrix per cube
+    void drawCubes(const float* x, const float* y, std::size_t count, float z, float size, const glm::vec3& color);
     void drawQuad(const glm::mat4& model, const glm::vec3& color);
     void drawRectOutline(float minX, float minY, float maxX, float maxY, float z, const glm::vec3& color);
     void drawRectFilled(float minX, float minY, float maxX, float maxY, float z, const glm::vec3& color);
     void drawModelOutline(const glm::mat4& model, const glm::vec3& color);
-    void drawDigit(int digit, float x, float y, float size, float z, const glm::vec3& color);
-    void drawScore(int left, int right, float z, const glm::vec3& color);
     void setView(const glm::mat4& view);
     void setProjection(const glm::mat4& projection);
     void clear();
 
+    // Submits all retained layers plus everything queued since the last
+    // flush. Call once per frame.
+    void flush();
+
+    // Retained geometry. beginLayer() discards the layer's previous contents
+    // and records subsequent draws into it until endLayer().
+    unsigned int createLayer();
+    void beginLayer(unsigned int layer);
+    void endLayer();
+
+    // Submission stats of the last flush()
+    unsigned int drawCalls() const { return lastDrawCalls; }
+    unsigned int instanceCount() const { return lastInstances; }
+
 private:
-    unsigned int cubeVAO, cubeVBO;
-    unsigned int quadVAO, quadVBO;
-    unsigned int lineVAO, lineVBO;
-    unsigned int cubeOutlineVAO, cubeOutlineVBO;
-    unsigned int shaderProgram;
-
-    void setupCube();
-    void setupQuad();
-    void setupLineRect();
-    void loadShader();
+    // Built-in meshes, registered first so their ids are fixed
+    enum BuiltinMesh { Cube, Quad, LineRect, CubeOutline };
+
+    // Five RGBA32F texels in the instance buffer texture (see vertex.glsl)
+    struct Instance {
+        glm::mat4 model;
+        glm::vec4 color;
+    };
+
+    struct Mesh {
+        GLenum mode;
+        GLsizei indexCount;
+        std::size_t firstIndex;
+        GLint baseVertex;
+
+        std::vector<Instance> instances;  // queued this frame
+        GLsizei frameFirst = 0, frameCount = 0;        // in frameStream
+        GLsizei retainedFirst = 0, retainedCount = 0;  // in retainedStream
+    };
+
+    struct Layer {
+        std::vector<std::vector<Instance>> instances;  // per mesh
+    };
+
+    // An instance buffer and the buffer texture the shader reads it through
+    struct InstanceStream {
+        unsigned int buffer = 0, texture = 0;
+    };
+
+    // std140 layout of the Camera block in vertex.glsl
+    struct CameraBlock {
+        glm::mat4 view;
+        glm::mat4 projection;
+    };
+    static const unsigned int CameraBinding = 0;
+
+    GLState& gl;
+    Shader shader;
+    UniformInt instanceBaseUniform;
+    unsigned int cameraUBO = 0;
+
+    unsigned int vao = 0, vertexBuffer = 0, indexBuffer = 0;
+    std::vector<glm::vec3> vertices;
+    std::vector<std::uint16_t> indices;
+    bool geometryDirty = false;
+    std::vector<Mesh> meshes;
+
+    InstanceStream frameStream, retainedStream;
+    GLsizei maxInstances = 0;  // GL_MAX_TEXTURE_BUFFER_SIZE / 5
+    bool retainedDirty = false;
+    bool warnedOverflow = false;
+
+    std::vector<Layer> layers;
+    int recordingLayer = -1;
+    std::vector<Instance> staging;
+    unsigned int lastDrawCalls = 0;
+    unsigned int lastInstances = 0;
+
+    void setupCamera();
+    InstanceStream createStream();
+    void uploadGeometry();
+    void uploadRetained();
+    void uploadFrame();
+    GLsizei fitInstances(GLsizei first, GLsizei count);
+    void drawInstances(const Mesh& mesh, GLsizei first, GLsizei count);
+    void queue(unsigned int mesh, const glm::mat4& model, const glm::vec3& color);
 };
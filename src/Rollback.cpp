@@ -0,0 +1,75 @@
+#include "Rollback.h"
+#include "InputLog.h"
+#include <algorithm>
+#include <chrono>
+
+namespace sim {
+
+RollbackSession::RollbackSession(const MatchConfig& config, std::uint64_t seed, int localSide, float tickDt,
+                                 std::uint32_t maxPrediction)
+    : m_config(config), m_localSide(localSide), m_dt(tickDt),
+      m_maxPrediction(std::min(maxPrediction, HistorySize / 2)) {
+    resetMatch(m_state, seed, m_config);
+}
+
+// Before it arrives, the remote player is assumed to keep doing what they did last
+std::int8_t RollbackSession::remoteFor(std::uint32_t tick) const {
+    if (tick < m_remoteNext) return m_remote[tick % HistorySize];
+    return m_remoteNext > 0 ? m_remote[(m_remoteNext - 1) % HistorySize] : 0;
+}
+
+void RollbackSession::simulate(std::uint32_t tick) {
+    const std::uint32_t slot = tick % HistorySize;
+    m_snapshots[slot] = m_state;
+    m_used[slot] = remoteFor(tick);
+
+    // Both paddles are human; axes go through the same quantization as logs
+    InputFrame frame;
+    frame.dt = m_dt;
+    frame.leftAxis = m_localSide == 0 ? m_local[slot] : m_used[slot];
+    frame.rightAxis = m_localSide == 0 ? m_used[slot] : m_local[slot];
+    step(m_state, m_config, decodeInputs(frame), frame.dt);
+}
+
+bool RollbackSession::advance(std::int8_t localAxis) {
+    reconcile();
+    if (m_tick - std::min(m_remoteNext, m_tick) >= m_maxPrediction) {
+        m_stats.stalls++;
+        return false;
+    }
+    m_local[m_tick % HistorySize] = localAxis;
+    simulate(m_tick);
+    m_tick++;
+    return true;
+}
+
+void RollbackSession::addRemoteInput(std::uint32_t tick, std::int8_t axis) {
+    // In order only, and never so far ahead that it would overwrite history
+    if (tick != m_remoteNext || tick >= m_tick + HistorySize / 2) return;
+    m_remote[tick % HistorySize] = axis;
+    m_remoteNext++;
+    if (tick < m_tick && m_used[tick % HistorySize] != axis) m_rollbackFrom = std::min(m_rollbackFrom, tick);
+}
+
+void RollbackSession::reconcile() {
+    if (m_rollbackFrom >= m_tick) {
+        m_rollbackFrom = UINT32_MAX;
+        return;
+    }
+    auto start = std::chrono::steady_clock::now();
+
+    const std::uint32_t from = m_rollbackFrom;
+    m_state = m_snapshots[from % HistorySize];
+    for (std::uint32_t t = from; t < m_tick; ++t) simulate(t);
+    m_rollbackFrom = UINT32_MAX;
+
+    std::uint64_t ns = static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    m_stats.rollbacks++;
+    m_stats.ticksResimulated += m_tick - from;
+    m_stats.maxDepth = std::max(m_stats.maxDepth, m_tick - from);
+    m_stats.resimNs += ns;
+    m_stats.maxRollbackNs = std::max(m_stats.maxRollbackNs, ns);
+}
+
+}  // namespace sim
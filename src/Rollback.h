@@ -0,0 +1,74 @@
+#pragma once
+
+// Rollback for two-player matches. Each peer steps the match every tick
+// with its own input and a prediction of the remote one (the last input it
+// received). When the real remote input for a past tick arrives and differs,
+// the session restores the MatchState snapshot taken before that tick and
+// re-simulates up to the present. Snapshots are plain copies: the whole
+// match is one POD MatchState.
+
+#include "Simulation.h"
+#include <cstdint>
+
+namespace sim {
+
+class RollbackSession {
+public:
+    static const std::uint32_t HistorySize = 64;  // ticks of snapshots/inputs kept; power of two
+
+    struct Stats {
+        std::uint64_t rollbacks = 0;
+        std::uint64_t ticksResimulated = 0;
+        std::uint32_t maxDepth = 0;         // most ticks re-simulated at once
+        std::uint64_t resimNs = 0;          // total time spent re-simulating
+        std::uint64_t maxRollbackNs = 0;    // slowest single rollback
+        std::uint64_t stalls = 0;           // advance() refused: too far ahead of the remote
+    };
+
+    // `localSide` 0 plays left, 1 plays right. At most `maxPrediction` ticks
+    // may run ahead of the last remote input (< HistorySize / 2).
+    RollbackSession(const MatchConfig& config, std::uint64_t seed, int localSide, float tickDt,
+                    std::uint32_t maxPrediction = 12);
+
+    // Applies pending corrections, then steps one tick with `localAxis`
+    // (quantized like InputFrame, -127..127). Returns false and does
+    // nothing else when the prediction window is full.
+    bool advance(std::int8_t localAxis);
+
+    // Remote input for `tick`. Inputs must arrive in order; duplicates and
+    // gaps are ignored (the sender repeats unacknowledged ticks).
+    void addRemoteInput(std::uint32_t tick, std::int8_t axis);
+
+    // Re-simulates from the earliest mispredicted tick, if any
+    void reconcile();
+
+    const MatchState& state() const { return m_state; }
+    std::uint32_t tick() const { return m_tick; }             // ticks simulated
+    std::uint32_t remoteNext() const { return m_remoteNext; }  // remote inputs known for all ticks below
+    std::int8_t localInput(std::uint32_t tick) const { return m_local[tick % HistorySize]; }
+    int localSide() const { return m_localSide; }
+    const Stats& stats() const { return m_stats; }
+
+private:
+    void simulate(std::uint32_t tick);
+    std::int8_t remoteFor(std::uint32_t tick) const;
+
+    MatchConfig m_config;
+    int m_localSide;
+    float m_dt;
+    std::uint32_t m_maxPrediction;
+
+    MatchState m_state;
+    std::uint32_t m_tick = 0;
+    std::uint32_t m_remoteNext = 0;
+    std::uint32_t m_rollbackFrom = UINT32_MAX;
+
+    MatchState m_snapshots[HistorySize];    // state before each tick
+    std::int8_t m_local[HistorySize] = {};
+    std::int8_t m_remote[HistorySize] = {};  // valid below m_remoteNext
+    std::int8_t m_used[HistorySize] = {};    // remote input the tick was simulated with
+
+    Stats m_stats;
+};
+
+}  // namespace sim
@@ -1,8 +1,12 @@
 #include "Shader.h"
+#include "EmbeddedShaders.h"
+#include "GLState.h"
+#include "ProgramCache.h"
 #include <glad/glad.h>
+#include <chrono>
 #include <fstream>
-#include <sstream>
 #include <iostream>
+#include <iterator>
 
 static std::string resolveShaderPath(const char* path) {
     std::ifstream f1(path);
@@ -13,31 +17,34 @@ static std::string resolveShaderPath(const char* path) {
     return path;  // Return original, let open fail with clear error
 }
 
-Shader::Shader(const char* vertexPath, const char* fragmentPath) {
-    std::string vertexCode, fragmentCode;
-    std::ifstream vShaderFile, fShaderFile;
+// Built-in shaders never touch the filesystem; anything else is read from
+// the working directory or its parent
+static std::string loadShaderSource(const char* path) {
+    if (const char* source = embeddedShader(path)) return source;
 
-    std::string vPath = resolveShaderPath(vertexPath);
-    std::string fPath = resolveShaderPath(fragmentPath);
+    std::ifstream file(resolveShaderPath(path), std::ios::binary);
+    if (!file) {
+        std::cerr << "Shader file error: cannot open " << path << std::endl;
+        return std::string();
+    }
+    return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+}
 
-    vShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
-    fShaderFile.exceptions(std::ifstream::failbit | std::ifstream::badbit);
+Shader::Shader(GLState& gl, const char* vertexPath, const char* fragmentPath, ProgramCache* cache) : gl(gl) {
+    auto start = std::chrono::steady_clock::now();
 
-    try {
-        vShaderFile.open(vPath);
-        fShaderFile.open(fPath);
-        std::stringstream vShaderStream, fShaderStream;
-        vShaderStream << vShaderFile.rdbuf();
-        fShaderStream << fShaderFile.rdbuf();
-        vShaderFile.close();
-        fShaderFile.close();
-        vertexCode = vShaderStream.str();
-        fragmentCode = fShaderStream.str();
-    }
-    catch (std::ifstream::failure& e) {
-        std::cerr << "Shader file error: " << e.what() << std::endl;
-    }
+    std::string vertexCode = loadShaderSource(vertexPath);
+    std::string fragmentCode = loadShaderSource(fragmentPath);
+
+    ID = cache ? cache->load(vertexCode, fragmentCode) : 0;
+    cached = ID != 0;
+    if (!cached) compile(vertexCode, fragmentCode, cache);
+
+    loadUniformLocations();
+    buildMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
 
+void Shader::compile(const std::string& vertexCode, const std::string& fragmentCode, ProgramCache* cache) {
     const char* vShaderCode = vertexCode.c_str();
     const char* fShaderCode = fragmentCode.c_str();
 
@@ -54,30 +61,84 @@ Shader::Shader(const char* vertexPath, const char* fragmentPath) {
     ID = glCreateProgram();
     glAttachShader(ID, vertex);
     glAttachShader(ID, fragment);
+    if (cache) cache->prepare(ID);
     glLinkProgram(ID);
-    checkCompileErrors(ID, "PROGRAM");
+    bool linked = checkCompileErrors(ID, "PROGRAM");
 
     glDeleteShader(vertex);
     glDeleteShader(fragment);
+
+    if (cache && linked) cache->store(ID, vertexCode, fragmentCode);
 }
 
 Shader::~Shader() {
-    glDeleteProgram(ID);
+    gl.deleteProgram(ID);
 }
 
 void Shader::use() const {
-    glUseProgram(ID);
+    gl.useProgram(ID);
+}
+
+void Shader::set(UniformMat4 u, const glm::mat4& mat) const {
+    if (gl.uniformChanged(ID, u.location, &mat[0][0], sizeof(mat)))
+        glUniformMatrix4fv(u.location, 1, GL_FALSE, &mat[0][0]);
+}
+
+void Shader::set(UniformVec2 u, const glm::vec2& value) const {
+    if (gl.uniformChanged(ID, u.location, &value[0], sizeof(value))) glUniform2fv(u.location, 1, &value[0]);
+}
+
+void Shader::set(UniformVec3 u, const glm::vec3& value) const {
+    if (gl.uniformChanged(ID, u.location, &value[0], sizeof(value))) glUniform3fv(u.location, 1, &value[0]);
+}
+
+void Shader::set(UniformInt u, int value) const {
+    if (gl.uniformChanged(ID, u.location, &value, sizeof(value))) glUniform1i(u.location, value);
 }
 
 void Shader::setMat4(const std::string& name, const glm::mat4& mat) const {
-    glUniformMatrix4fv(glGetUniformLocation(ID, name.c_str()), 1, GL_FALSE, &mat[0][0]);
+    set(mat4Uniform(name), mat);
 }
 
 void Shader::setVec3(const std::string& name, const glm::vec3& value) const {
-    glUniform3fv(glGetUniformLocation(ID, name.c_str()), 1, &value[0]);
+    set(vec3Uniform(name), value);
+}
+
+bool Shader::bindUniformBlock(const char* blockName, unsigned int binding) const {
+    GLuint index = glGetUniformBlockIndex(ID, blockName);
+    if (index == GL_INVALID_INDEX) return false;
+    glUniformBlockBinding(ID, index, binding);
+    return true;
+}
+
+int Shader::location(const std::string& name) const {
+    auto it = uniformLocations.find(name);
+    return it != uniformLocations.end() ? it->second : -1;
+}
+
+// Every active default-block uniform, queried once after linking.
+// Block members report location -1 and are skipped.
+void Shader::loadUniformLocations() {
+    GLint count = 0, maxLength = 0;
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &count);
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORM_MAX_LENGTH, &maxLength);
+    std::string name(static_cast<size_t>(maxLength > 0 ? maxLength : 1), '\0');
+    for (GLint i = 0; i < count; ++i) {
+        GLsizei length = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(ID, static_cast<GLuint>(i), maxLength, &length, &size, &type, &name[0]);
+        std::string uniform(name.data(), static_cast<size_t>(length));
+        GLint loc = glGetUniformLocation(ID, uniform.c_str());
+        if (loc < 0) continue;
+        // Arrays are reported as "name[0]"; register the bare name too
+        size_t bracket = uniform.find('[');
+        if (bracket != std::string::npos) uniformLocations[uniform.substr(0, bracket)] = loc;
+        uniformLocations[uniform] = loc;
+    }
 }
 
-void Shader::checkCompileErrors(unsigned int shader, const std::string& type) {
+bool Shader::checkCompileErrors(unsigned int shader, const std::string& type) {
     int success;
     char infoLog[1024];
 
@@ -94,4 +155,5 @@ void Shader::checkCompileErrors(unsigned int shader, const std::string& type) {
             std::cerr << "Shader " << type << " compile error: " << infoLog << std::endl;
         }
     }
+    return success != 0;
 }
@@ -1,19 +1,62 @@
 #pragma once
 
 #include <string>
+#include <unordered_map>
 #include <glm/glm.hpp>
 
+class GLState;
+class ProgramCache;
+
+// Typed uniform handles, resolved once from the program's location table.
+// An invalid handle (-1) is silently ignored by GL, like a missing uniform.
+struct UniformMat4 { int location = -1; };
+struct UniformVec2 { int location = -1; };
+struct UniformVec3 { int location = -1; };
+struct UniformInt { int location = -1; };
+
 class Shader {
 public:
     unsigned int ID;
+    // How the program was obtained, for startup timings
+    double buildMs = 0.0;  // source look-up plus compile and link, or binary load
+    bool cached = false;   // linked from a ProgramCache entry
 
-    Shader(const char* vertexPath, const char* fragmentPath);
+    // Binding and uniform writes go through `gl`, which must outlive the shader.
+    // Paths name embedded sources (see EmbeddedShaders.h) and are only read
+    // from disk if not embedded. With `cache`, a stored binary replaces the
+    // compile and a fresh link is stored for next time.
+    Shader(GLState& gl, const char* vertexPath, const char* fragmentPath, ProgramCache* cache = nullptr);
     ~Shader();
 
+    Shader(const Shader&) = delete;
+    Shader& operator=(const Shader&) = delete;
+
     void use() const;
+
+    // Look-ups hit the table built at link time, never the driver
+    UniformMat4 mat4Uniform(const std::string& name) const { return {location(name)}; }
+    UniformVec2 vec2Uniform(const std::string& name) const { return {location(name)}; }
+    UniformVec3 vec3Uniform(const std::string& name) const { return {location(name)}; }
+    UniformInt intUniform(const std::string& name) const { return {location(name)}; }
+
+    // Setters act on the current program (call use() first). Writing a
+    // uniform's current value again is skipped.
+    void set(UniformMat4 u, const glm::mat4& mat) const;
+    void set(UniformVec2 u, const glm::vec2& value) const;
+    void set(UniformVec3 u, const glm::vec3& value) const;
+    void set(UniformInt u, int value) const;
     void setMat4(const std::string& name, const glm::mat4& mat) const;
     void setVec3(const std::string& name, const glm::vec3& value) const;
 
+    // Attaches the named uniform block to a binding point; false if absent
+    bool bindUniformBlock(const char* blockName, unsigned int binding) const;
+
 private:
-    void checkCompileErrors(unsigned int shader, const std::string& type);
+    GLState& gl;
+    std::unordered_map<std::string, int> uniformLocations;
+
+    int location(const std::string& name) const;
+    void compile(const std::string& vertexCode, const std::string& fragmentCode, ProgramCache* cache);
+    void loadUniformLocations();
+    bool checkCompileErrors(unsigned int shader, const std::string& type);
 };
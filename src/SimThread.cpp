@@ -0,0 +1,183 @@
+#include "SimThread.h"
+#include <chrono>
+
+namespace sim {
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Catch up at most this many ticks after a stall; older time is dropped
+const int MaxCatchUpTicks = 30;
+
+std::uint32_t packInputs(const InputFrame& frame) {
+    return static_cast<std::uint8_t>(frame.leftAxis) | static_cast<std::uint8_t>(frame.rightAxis) << 8 |
+           static_cast<std::uint32_t>(frame.flags) << 16;
+}
+
+std::int64_t toNs(Clock::time_point t) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(t.time_since_epoch()).count();
+}
+
+}  // namespace
+
+std::int64_t steadyNowNs() {
+    return toNs(Clock::now());
+}
+
+SimThread::SimThread(const MatchConfig& config, const MatchState& initial, double tickRate)
+    : m_config(config), m_staticStep(findStaticStep(config)), m_state(initial), m_dt(static_cast<float>(1.0 / tickRate)),
+      m_inputs(packInputs(encodeFrame(MatchInputs{}, 0.0f))) {
+    m_published.previous = initial;
+    m_published.current = initial;
+    m_published.tickTimeNs = toNs(Clock::now());
+    m_snapshots.back() = m_published;
+    m_snapshots.publish();
+}
+
+SimThread::~SimThread() {
+    stop();
+}
+
+void SimThread::setProfiler(Profiler* profiler, int tickPhase, int iterationsPhase) {
+    m_profiler = profiler;
+    m_tickPhase = tickPhase;
+    m_iterationsPhase = iterationsPhase;
+}
+
+void SimThread::start() {
+    if (m_running.exchange(true)) return;
+    m_thread = std::thread(&SimThread::run, this);
+}
+
+void SimThread::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_pauseMutex);
+        m_running.store(false);
+    }
+    m_pauseChanged.notify_one();
+    if (m_thread.joinable()) m_thread.join();
+}
+
+void SimThread::setPaused(bool paused) {
+    {
+        std::lock_guard<std::mutex> lock(m_pauseMutex);
+        if (paused == (m_pausedAtNs.load(std::memory_order_relaxed) != 0)) return;
+        std::int64_t now = steadyNowNs();
+        if (paused) {
+            m_pausedAtNs.store(now, std::memory_order_release);
+        } else {
+            m_resumedAtNs = now;
+            m_pausedAtNs.store(0, std::memory_order_release);
+        }
+    }
+    m_pauseChanged.notify_one();
+}
+
+void SimThread::waitWhilePaused(Clock::time_point& next, std::int64_t pausedAtNs) {
+    std::int64_t resumedAtNs;
+    {
+        std::unique_lock<std::mutex> lock(m_pauseMutex);
+        m_pauseChanged.wait(lock, [this] {
+            return m_pausedAtNs.load(std::memory_order_relaxed) == 0 || !m_running.load(std::memory_order_relaxed);
+        });
+        resumedAtNs = m_resumedAtNs;
+    }
+    if (!m_running.load(std::memory_order_relaxed)) return;
+
+    // The next tick keeps its distance from the pause, and the snapshot
+    // keeps its age, so neither the sim nor the interpolation jumps
+    std::int64_t pausedNs = resumedAtNs - pausedAtNs;
+    next += std::chrono::duration_cast<Clock::duration>(std::chrono::nanoseconds(pausedNs));
+    m_published.tickTimeNs += pausedNs;
+    m_snapshots.back() = m_published;
+    m_snapshots.publish();
+}
+
+bool SimThread::pushInputs(const MatchInputs& inputs, std::int64_t timeNs) {
+    std::uint64_t head = m_queueHead.load(std::memory_order_relaxed);
+    if (head - m_queueTail.load(std::memory_order_acquire) == QueueSize) return false;
+    m_queue[head & (QueueSize - 1)] = {timeNs, packInputs(encodeFrame(inputs, 0.0f))};
+    m_queueHead.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+void SimThread::run() {
+    const auto tick = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(m_dt));
+    auto next = Clock::now() + tick;
+    std::uint64_t ticks = 0;
+
+    while (m_running.load(std::memory_order_relaxed)) {
+        std::this_thread::sleep_until(next);
+
+        // Ticks due before a pause still run; the rest wait for the resume
+        std::int64_t pausedAtNs = m_pausedAtNs.load(std::memory_order_acquire);
+        auto now = Clock::now();
+        if (now - next > tick * MaxCatchUpTicks) {
+            auto behind = (now - next) / tick;
+            m_dropped.fetch_add(static_cast<std::uint64_t>(behind), std::memory_order_relaxed);
+            next += tick * behind;
+        }
+
+        // Every tick that is due, each with the same fixed dt
+        while (next <= now && m_running.load(std::memory_order_relaxed) &&
+               (pausedAtNs == 0 || toNs(next) <= pausedAtNs)) {
+            // Every input change up to this tick's time; later ones wait
+            std::int64_t tickNs = toNs(next);
+            std::uint64_t tail = m_queueTail.load(std::memory_order_relaxed);
+            std::uint64_t head = m_queueHead.load(std::memory_order_acquire);
+            while (tail != head && m_queue[tail & (QueueSize - 1)].timeNs <= tickNs)
+                m_inputs = m_queue[tail++ & (QueueSize - 1)].inputs;
+            m_queueTail.store(tail, std::memory_order_release);
+
+            std::uint32_t packed = m_inputs;
+            InputFrame frame;
+            frame.dt = m_dt;
+            frame.leftAxis = static_cast<std::int8_t>(packed & 0xFF);
+            frame.rightAxis = static_cast<std::int8_t>((packed >> 8) & 0xFF);
+            frame.flags = static_cast<std::uint8_t>((packed >> 16) & 0xFF);
+            if (m_recorder) m_recorder->record(frame);
+
+            MatchState previous = m_state;
+            StepStats stats;
+            unsigned events = 0;
+            auto advance = [&] {
+                if (m_staticStep)
+                    events = m_staticStep(m_state, decodeInputs(frame), frame.dt, &stats);
+                else
+                    events = step(m_state, m_config, decodeInputs(frame), frame.dt, &stats);
+            };
+            if (m_profiler) {
+                ScopedTimer t(*m_profiler, m_tickPhase);
+                advance();
+            } else {
+                advance();
+            }
+            if (m_profiler) m_profiler->count(m_iterationsPhase, static_cast<std::uint64_t>(stats.iterations));
+            if (m_telemetry) m_telemetry->record(m_state, frame.dt, events);
+
+            m_published.previous = previous;
+            m_published.current = m_state;
+            m_published.tick = ++ticks;
+            m_published.tickTimeNs = tickNs;
+            m_snapshots.back() = m_published;
+            m_snapshots.publish();
+            next += tick;
+        }
+
+        if (pausedAtNs != 0) waitWhilePaused(next, pausedAtNs);
+    }
+}
+
+MatchState interpolate(const MatchState& a, const MatchState& b, float alpha) {
+    MatchState out = b;
+    if (a.scoreLeft != b.scoreLeft || a.scoreRight != b.scoreRight) return out;
+    auto lerp = [alpha](float x, float y) { return x + (y - x) * alpha; };
+    out.ballX = lerp(a.ballX, b.ballX);
+    out.ballY = lerp(a.ballY, b.ballY);
+    out.paddleLeftY = lerp(a.paddleLeftY, b.paddleLeftY);
+    out.paddleRightY = lerp(a.paddleRightY, b.paddleRightY);
+    return out;
+}
+
+}  // namespace sim
@@ -0,0 +1,112 @@
+#pragma once
+
+#include "InputLog.h"
+#include "Profiler.h"
+#include "Simulation.h"
+#include "Telemetry.h"
+#include "TripleBuffer.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+namespace sim {
+
+// steady_clock now in nanoseconds: the time base of snapshots and input events
+std::int64_t steadyNowNs();
+
+// The two most recent ticks, so a renderer can interpolate between them.
+struct SimSnapshot {
+    MatchState previous;
+    MatchState current;
+    std::uint64_t tick = 0;       // ticks run; 0 until the first publish
+    std::int64_t tickTimeNs = 0;  // steady_clock time `current` was produced
+};
+
+// Runs step() on its own thread at a fixed tick rate. Inputs come in as
+// timestamped events through a lock-free queue and snapshots go out through
+// a triple buffer, so the render thread and the simulation never block
+// each other.
+class SimThread {
+public:
+    SimThread(const MatchConfig& config, const MatchState& initial, double tickRate);
+    ~SimThread();
+
+    SimThread(const SimThread&) = delete;
+    SimThread& operator=(const SimThread&) = delete;
+
+    // Before start(): every tick is logged to `recorder` on the sim thread,
+    // its resulting state to `telemetry`, and tick time / integrator
+    // iterations go to `profiler`
+    void setRecorder(InputRecorder* recorder) { m_recorder = recorder; }
+    void setTelemetry(TelemetryRecorder* telemetry) { m_telemetry = telemetry; }
+    void setProfiler(Profiler* profiler, int tickPhase, int iterationsPhase);
+
+    void start();
+    void stop();
+
+    // While paused the thread sleeps and no ticks run. On resume the tick
+    // clock and the latest snapshot's time move on by the paused time, so
+    // there is no catch-up burst and interpolation continues where it stopped.
+    void setPaused(bool paused);
+
+    // From one thread only. `inputs` takes effect on the first tick at or
+    // after `timeNs` (tick k covers the dt ending at its snapshot time), so
+    // an event lands on the tick it happened in even if the sim is behind.
+    // Returns false when the queue is full; push it again later.
+    bool pushInputs(const MatchInputs& inputs, std::int64_t timeNs);
+
+    // Reader side: refreshes `latest()`; true if a new tick arrived
+    bool update() { return m_snapshots.update(); }
+    const SimSnapshot& latest() const { return m_snapshots.front(); }
+
+    float tickDt() const { return m_dt; }
+    // Ticks skipped because the thread fell too far behind (e.g. a debugger stop)
+    std::uint64_t droppedTicks() const { return m_dropped.load(std::memory_order_relaxed); }
+    // Valid after stop()
+    const MatchState& finalState() const { return m_state; }
+
+private:
+    void run();
+    // Sim thread: blocks until resumed, then shifts `next` past the pause
+    void waitWhilePaused(std::chrono::steady_clock::time_point& next, std::int64_t pausedAtNs);
+
+    MatchConfig m_config;
+    StaticStep m_staticStep;  // when m_config is a predefined table
+    MatchState m_state;
+    float m_dt;
+    InputRecorder* m_recorder = nullptr;
+    TelemetryRecorder* m_telemetry = nullptr;
+    Profiler* m_profiler = nullptr;
+    int m_tickPhase = -1;
+    int m_iterationsPhase = -1;
+
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};
+    // Single-producer / single-consumer ring of input changes
+    struct InputEvent {
+        std::int64_t timeNs;
+        std::uint32_t inputs;  // InputFrame axes and flags, packed
+    };
+    static const std::uint64_t QueueSize = 256;  // power of two
+    InputEvent m_queue[QueueSize];
+    alignas(64) std::atomic<std::uint64_t> m_queueHead{0};  // producer
+    alignas(64) std::atomic<std::uint64_t> m_queueTail{0};  // consumer
+    std::uint32_t m_inputs;  // sim thread only: inputs of the current tick
+    std::atomic<std::uint64_t> m_dropped{0};
+    TripleBuffer<SimSnapshot> m_snapshots;
+    SimSnapshot m_published;  // sim thread after start(): a copy of the latest publish
+
+    std::atomic<std::int64_t> m_pausedAtNs{0};  // 0 while running
+    std::int64_t m_resumedAtNs = 0;             // guarded by m_pauseMutex
+    std::mutex m_pauseMutex;
+    std::condition_variable m_pauseChanged;
+};
+
+// Blend of two ticks for display: ball and paddles are lerped by `alpha`
+// (0 = a, 1 = b). Across a goal the ball teleports, so b is used as is.
+MatchState interpolate(const MatchState& a, const MatchState& b, float alpha);
+
+}  // namespace sim
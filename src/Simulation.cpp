@@ -0,0 +1,597 @@
+#include "Simulation.h"
+#include "AIPolicy.h"
+#include "FixedPoint.h"
+#include <algorithm>
+#include <cmath>
+
+namespace sim {
+
+std::uint32_t nextRandom(MatchState& state) {
+    std::uint64_t old = state.rng;
+    state.rng = old * 6364136223846793005ULL + 1442695040888963407ULL;
+    std::uint32_t xorshifted = static_cast<std::uint32_t>(((old >> 18u) ^ old) >> 27u);
+    std::uint32_t rot = static_cast<std::uint32_t>(old >> 59u);
+    return (xorshifted >> rot) | (xorshifted << ((32u - rot) & 31u));
+}
+
+// Uniform in [0, 1]
+static float randomUnit(MatchState& state) {
+    return (nextRandom(state) >> 8) * (1.0f / 16777215.0f);
+}
+
+// The same draws as resetBall() with an integer formula, so the serve is a
+// Q16.16 value whatever the float environment
+static void resetBallFixed(MatchState& state) {
+    state.ballX = 0.0f;
+    state.ballY = 0.0f;
+    state.ballVelX = nextRandom(state) % 2 == 0 ? 10.0f : -10.0f;
+    Fixed vy = (static_cast<Fixed>(nextRandom(state) % 100) - 50) * 5 * FixedOne / 50;
+    state.ballVelY = fromFixed(vy);
+}
+
+void resetBall(MatchState& state) {
+#ifdef CPONG_FIXED_POINT
+    resetBallFixed(state);
+#else
+    state.ballX = 0.0f;
+    state.ballY = 0.0f;
+    state.ballVelX = (nextRandom(state) % 2 == 0 ? 1.0f : -1.0f) * 10.0f;
+    state.ballVelY = ((nextRandom(state) % 100) / 50.0f - 1.0f) * 5.0f;
+#endif
+}
+
+void resetMatch(MatchState& state, std::uint64_t seed, const MatchConfig& config) {
+    state = MatchState{};
+    state.rng = seed;
+    nextRandom(state);
+    if (config.integrator == Integrator::Fixed)
+        resetBallFixed(state);
+    else
+        resetBall(state);
+}
+
+// Where the step functions below read their config. RuntimeConfig wraps any
+// MatchConfig; StaticConfig names a constexpr one, so in its instantiations
+// every dimension, derived bound and constant is folded into the code.
+struct RuntimeConfig {
+    const MatchConfig& config;
+    const MatchConfig& get() const { return config; }
+};
+
+template <const MatchConfig& Config>
+struct StaticConfig {
+    static constexpr const MatchConfig& get() { return Config; }
+};
+
+template <typename Source>
+static unsigned scoreGoalsWith(MatchState& state, Source source) {
+    const MatchConfig& config = source.get();
+    void (*serve)(MatchState&) = config.integrator == Integrator::Fixed ? resetBallFixed : resetBall;
+    unsigned events = 0;
+    float halfLen = config.tableLength / 2.0f;
+    if (state.ballX < -halfLen) {
+        state.scoreRight++;
+        events |= RightScored;
+        serve(state);
+    }
+    if (state.ballX > halfLen) {
+        state.scoreLeft++;
+        events |= LeftScored;
+        serve(state);
+    }
+    return events;
+}
+
+unsigned scoreGoals(MatchState& state, const MatchConfig& config) {
+    return scoreGoalsWith(state, RuntimeConfig{config});
+}
+
+// Integrator::Fixed: the substep loop, the AI tracker and paddle input in
+// Q16.16. Config values are converted once per call; from there on a frame
+// is integer-only.
+struct FixedConstants {
+    Fixed radius, halfLen, halfWidth, paddleHalfH, paddleDepth, pad, nudge;
+    Fixed paddleSpeed, paddleLimit, speedBoost, maxSpeed;
+    FixedTime substep;
+};
+
+static FixedConstants fixedConstants(const MatchConfig& config) {
+    FixedConstants k;
+    k.radius = toFixed(config.ballRadius);
+    k.halfLen = toFixed(config.tableLength) / 2;
+    k.halfWidth = toFixed(config.tableWidth) / 2;
+    k.paddleHalfH = toFixed(config.paddleHeight) / 2;
+    k.paddleDepth = toFixed(config.paddleDepth);
+    k.pad = fixedMul(k.radius, toFixed(1.2f));
+    k.nudge = toFixed(0.01f);
+    k.paddleSpeed = toFixed(config.paddleSpeed);
+    k.paddleLimit = (toFixed(config.tableWidth) - toFixed(config.paddleHeight)) / 2;
+    k.speedBoost = toFixed(config.speedBoost);
+    k.maxSpeed = toFixed(config.maxSpeed);
+    k.substep = toFixedTime(config.fixedDt);
+    return k;
+}
+
+// speedBoost up to maxSpeed, keeping the direction. The divisions truncate
+// toward zero, so rounding never pushes the speed past maxSpeed.
+static void bounceFixed(Fixed& vx, Fixed& vy, bool towardRight, const FixedConstants& k) {
+    Fixed speed = fixedLength(vx, vy);
+    if (speed == 0) return;
+    Fixed newSpeed = fixedMin(fixedMul(speed, k.speedBoost), k.maxSpeed);
+    Fixed absVx = static_cast<Fixed>(static_cast<std::int64_t>(fixedAbs(vx)) * newSpeed / speed);
+    vx = towardRight ? absVx : -absVx;
+    vy = static_cast<Fixed>(static_cast<std::int64_t>(vy) * newSpeed / speed);
+}
+
+static unsigned integrateFixed(MatchState& state, const MatchConfig& config, const FixedConstants& k,
+                               FixedTime frame, int& iterations) {
+    Fixed x = toFixed(state.ballX), y = toFixed(state.ballY);
+    Fixed vx = toFixed(state.ballVelX), vy = toFixed(state.ballVelY);
+    const Fixed leftY = toFixed(state.paddleLeftY), rightY = toFixed(state.paddleRightY);
+
+    const Fixed leftMinX = -k.halfLen;
+    const Fixed leftMaxX = -k.halfLen + k.paddleDepth + k.pad;
+    const Fixed rightMinX = k.halfLen - k.paddleDepth - k.pad;
+    const Fixed rightMaxX = k.halfLen;
+
+    // A frame within 1/1024 substep of a whole number of substeps counts as
+    // whole: 1/60 s is ten 1/600 s substeps although neither is exact in Q0.32
+    FixedTime whole = (frame + (k.substep >> 10)) / k.substep;
+    int steps = static_cast<int>(std::min<FixedTime>(whole, config.maxSteps));
+
+    unsigned events = 0;
+    for (int i = 0; i < steps; ++i) {
+        Fixed prevX = x, prevY = y;
+        x += fixedDistance(vx, k.substep);
+        y += fixedDistance(vy, k.substep);
+
+        if (y + k.radius > k.halfWidth) {
+            y = k.halfWidth - k.radius;
+            vy = -fixedAbs(vy);
+        }
+        if (y - k.radius < -k.halfWidth) {
+            y = -k.halfWidth + k.radius;
+            vy = fixedAbs(vy);
+        }
+
+        Fixed bMinX = fixedMin(prevX, x) - k.radius;
+        Fixed bMaxX = fixedMax(prevX, x) + k.radius;
+        Fixed bMinY = fixedMin(prevY, y) - k.radius;
+        Fixed bMaxY = fixedMax(prevY, y) + k.radius;
+
+        if (vx < 0 && bMinX < leftMaxX && bMaxX > leftMinX &&
+            bMinY < leftY + k.paddleHalfH && bMaxY > leftY - k.paddleHalfH) {
+            x = -k.halfLen + k.paddleDepth + k.radius + k.nudge;
+            bounceFixed(vx, vy, true, k);
+            events |= LeftPaddleHit;
+        }
+        if (vx > 0 && bMinX < rightMaxX && bMaxX > rightMinX &&
+            bMinY < rightY + k.paddleHalfH && bMaxY > rightY - k.paddleHalfH) {
+            x = k.halfLen - k.paddleDepth - k.radius - k.nudge;
+            bounceFixed(vx, vy, false, k);
+            events |= RightPaddleHit;
+        }
+    }
+
+    state.ballX = fromFixed(x);
+    state.ballY = fromFixed(y);
+    state.ballVelX = fromFixed(vx);
+    state.ballVelY = fromFixed(vy);
+    iterations = steps;
+    return events;
+}
+
+static void updateAIMistakeFixed(MatchState& state, const AIParams& params, bool right, AIState& ai,
+                                 FixedTime frame) {
+    Fixed vx = toFixed(state.ballVelX);
+    if (right ? vx <= 0 : vx >= 0) return;
+
+    Fixed timer = toFixed(ai.mistakeTimer) + static_cast<Fixed>((frame + (FixedTime(1) << 15)) >> 16);
+    if (timer >= toFixed(params.mistakeChangeInterval)) {
+        timer = 0;
+        // 24 random bits as in randomUnit(); offset = (unit - 1/2) * 2 * range
+        std::int64_t centred = static_cast<std::int64_t>(nextRandom(state) >> 8) - (1 << 23);
+        ai.targetOffset = fromFixed(static_cast<Fixed>((centred * toFixed(params.mistakeRange)) >> 23));
+    }
+    ai.mistakeTimer = fromFixed(timer);
+}
+
+static void moveAIPaddleFixed(const MatchState& state, const MatchConfig& config, const AIParams& params,
+                              bool right, float& paddleY, const AIState& ai, FixedTime frame) {
+    Fixed vx = toFixed(state.ballVelX);
+    if (right ? vx <= 0 : vx >= 0) return;
+
+    const Fixed limit = (toFixed(config.tableWidth) - toFixed(config.paddleHeight)) / 2;
+    Fixed paddle = toFixed(paddleY);
+    Fixed target = fixedClamp(toFixed(state.ballY) + toFixed(ai.targetOffset), -limit - FixedOne, limit + FixedOne);
+    Fixed diff = target - paddle;
+    if (fixedAbs(diff) > toFixed(0.15f)) {
+        Fixed move = fixedMin(fixedDistance(toFixed(params.speed), frame), fixedAbs(diff));
+        paddle = fixedClamp(paddle + (diff < 0 ? -move : move), -limit, limit);
+    }
+    paddleY = fromFixed(paddle);
+}
+
+static unsigned stepBeforeAIFixed(MatchState& state, const MatchConfig& config, const MatchInputs& inputs,
+                                  float deltaTime, StepStats* stats) {
+    const FixedConstants k = fixedConstants(config);
+    const FixedTime frame = toFixedTime(deltaTime);
+
+    Fixed leftY = toFixed(state.paddleLeftY), rightY = toFixed(state.paddleRightY);
+    if (!inputs.leftAI)
+        leftY += fixedDistance(fixedMul(toFixed(inputs.leftAxis), k.paddleSpeed), frame);
+    if (!inputs.rightAI)
+        rightY += fixedDistance(fixedMul(toFixed(inputs.rightAxis), k.paddleSpeed), frame);
+    state.paddleLeftY = fromFixed(fixedClamp(leftY, -k.paddleLimit, k.paddleLimit));
+    state.paddleRightY = fromFixed(fixedClamp(rightY, -k.paddleLimit, k.paddleLimit));
+
+    int iterations = 0;
+    unsigned events = integrateFixed(state, config, k, frame, iterations);
+    if (stats) stats->iterations = iterations;
+
+    events |= scoreGoals(state, config);
+
+    updateAIMistakes(state, config, inputs, deltaTime);
+    return events;
+}
+
+// Each AI side re-rolls its aim error every mistakeChangeInterval while the
+// ball approaches it. `side` is +1 for the right paddle, -1 for the left.
+static void updateAIMistake(MatchState& state, const AIParams& params, float side,
+                            AIState& ai, float deltaTime) {
+    if (state.ballVelX * side > 0) {
+        ai.mistakeTimer += deltaTime;
+        if (ai.mistakeTimer >= params.mistakeChangeInterval) {
+            ai.mistakeTimer = 0.0f;
+            ai.targetOffset = (randomUnit(state) - 0.5f) * 2.0f * params.mistakeRange;
+        }
+    }
+}
+
+template <typename Source>
+static void updateAIMistakesWith(MatchState& state, Source source, const MatchInputs& inputs, float deltaTime) {
+    const MatchConfig& config = source.get();
+    if (config.integrator == Integrator::Fixed) {
+        FixedTime frame = toFixedTime(deltaTime);
+        if (inputs.leftAI) updateAIMistakeFixed(state, config.aiLeft, false, state.aiLeft, frame);
+        if (inputs.rightAI) updateAIMistakeFixed(state, config.aiRight, true, state.aiRight, frame);
+        return;
+    }
+    if (inputs.leftAI)
+        updateAIMistake(state, config.aiLeft, -1.0f, state.aiLeft, deltaTime);
+    if (inputs.rightAI)
+        updateAIMistake(state, config.aiRight, 1.0f, state.aiRight, deltaTime);
+}
+
+void updateAIMistakes(MatchState& state, const MatchConfig& config, const MatchInputs& inputs, float deltaTime) {
+    updateAIMistakesWith(state, RuntimeConfig{config}, inputs, deltaTime);
+}
+
+// Reactive tracker: chase the ball's Y plus the current aim error.
+static void moveAIPaddle(const MatchState& state, const MatchConfig& config, const AIParams& params,
+                         float side, float& paddleY, const AIState& ai, float deltaTime) {
+    float limit = (config.tableWidth - config.paddleHeight) / 2.0f;
+
+    if (state.ballVelX * side > 0) {
+        float targetY = state.ballY + ai.targetOffset;
+        targetY = std::clamp(targetY, -limit - 1.0f, limit + 1.0f);
+
+        float diff = targetY - paddleY;
+        if (std::abs(diff) > 0.15f) {
+            float move = std::copysign(std::min(params.speed * deltaTime, std::abs(diff)), diff);
+            paddleY = std::clamp(paddleY + move, -limit, limit);
+        }
+    }
+}
+
+// Reference integrator: fixed 600 Hz substeps with swept-AABB paddle tests.
+template <typename Source>
+static unsigned integrateSubsteps(MatchState& state, Source source, float deltaTime, int& iterations) {
+    const MatchConfig& config = source.get();
+    const float ballRadius = config.ballRadius;
+    float halfLen = config.tableLength / 2.0f;
+    float halfWidth = config.tableWidth / 2.0f;
+    float paddleHalfH = config.paddleHeight / 2.0f;
+
+    // Paddle collision bounds: paddle mesh X [-10,-9.5] left, [9.5,10] right. Extend toward center to prevent tunneling.
+    const float pad = ballRadius * 1.2f;
+    const float leftPaddleMinX = -halfLen;
+    const float leftPaddleMaxX = -halfLen + config.paddleDepth + pad;
+    const float rightPaddleMinX = halfLen - config.paddleDepth - pad;
+    const float rightPaddleMaxX = halfLen;
+
+    const float fixedDt = config.fixedDt;
+    unsigned events = 0;
+    float accumulated = deltaTime;
+    int steps = 0;
+    const int maxSteps = config.maxSteps;
+
+    while (accumulated >= fixedDt && steps < maxSteps) {
+        steps++;
+        accumulated -= fixedDt;
+
+        float prevX = state.ballX;
+        float prevY = state.ballY;
+        state.ballX += state.ballVelX * fixedDt;
+        state.ballY += state.ballVelY * fixedDt;
+
+        // Walls
+        if (state.ballY + ballRadius > halfWidth) {
+            state.ballY = halfWidth - ballRadius;
+            state.ballVelY = -std::abs(state.ballVelY);
+        }
+        if (state.ballY - ballRadius < -halfWidth) {
+            state.ballY = -halfWidth + ballRadius;
+            state.ballVelY = std::abs(state.ballVelY);
+        }
+
+        float leftPaddleMinY = state.paddleLeftY - paddleHalfH;
+        float leftPaddleMaxY = state.paddleLeftY + paddleHalfH;
+        float rightPaddleMinY = state.paddleRightY - paddleHalfH;
+        float rightPaddleMaxY = state.paddleRightY + paddleHalfH;
+
+        // Swept AABB: ball's path from prev position to current
+        float bMinX = std::min(prevX, state.ballX) - ballRadius;
+        float bMaxX = std::max(prevX, state.ballX) + ballRadius;
+        float bMinY = std::min(prevY, state.ballY) - ballRadius;
+        float bMaxY = std::max(prevY, state.ballY) + ballRadius;
+
+        const float speedBoost = config.speedBoost;
+        const float maxSpeed = config.maxSpeed;
+        float& vx = state.ballVelX;
+        float& vy = state.ballVelY;
+
+        // Left paddle
+        const float leftPaddleFaceX = -halfLen + config.paddleDepth;
+        if (vx < 0 &&
+            bMinX < leftPaddleMaxX && bMaxX > leftPaddleMinX &&
+            bMinY < leftPaddleMaxY && bMaxY > leftPaddleMinY) {
+            state.ballX = leftPaddleFaceX + ballRadius + 0.01f;
+            float newSpeed = std::min(std::sqrt(vx * vx + vy * vy) * speedBoost, maxSpeed);
+            float scale = newSpeed / std::sqrt(vx * vx + vy * vy);
+            vx = std::abs(vx) * scale;
+            vy *= scale;
+            events |= LeftPaddleHit;
+        }
+
+        // Right paddle
+        const float rightPaddleFaceX = halfLen - config.paddleDepth;
+        if (vx > 0 &&
+            bMinX < rightPaddleMaxX && bMaxX > rightPaddleMinX &&
+            bMinY < rightPaddleMaxY && bMaxY > rightPaddleMinY) {
+            state.ballX = rightPaddleFaceX - ballRadius - 0.01f;
+            float newSpeed = std::min(std::sqrt(vx * vx + vy * vy) * speedBoost, maxSpeed);
+            float scale = newSpeed / std::sqrt(vx * vx + vy * vy);
+            vx = -std::abs(vx) * scale;
+            vy *= scale;
+            events |= RightPaddleHit;
+        }
+    }
+    iterations = steps;
+    return events;
+}
+
+// Entry time of a point moving from p with velocity v into the open interval
+// (lo, hi), and the time it leaves. Returns false if it never overlaps.
+static bool slab(float p, float v, float lo, float hi, float& tEnter, float& tExit) {
+    if (v == 0.0f) {
+        tEnter = -INFINITY;
+        tExit = INFINITY;
+        return p > lo && p < hi;
+    }
+    float t0 = (lo - p) / v;
+    float t1 = (hi - p) / v;
+    tEnter = std::min(t0, t1);
+    tExit = std::max(t0, t1);
+    return true;
+}
+
+// Event-driven integrator. Paddles do not move during ball physics, so each
+// segment of straight flight is solved in closed form for the earliest of:
+// a wall contact, entry into a paddle collider (the same padded box the
+// substepper tests, swept against the ball radius) or the goal line.
+template <typename Source>
+static unsigned integrateEvents(MatchState& state, Source source, float deltaTime, int& iterations) {
+    const MatchConfig& config = source.get();
+    const float ballRadius = config.ballRadius;
+    const float halfLen = config.tableLength / 2.0f;
+    const float halfWidth = config.tableWidth / 2.0f;
+    const float paddleHalfH = config.paddleHeight / 2.0f;
+    const float pad = ballRadius * 1.2f;
+
+    const float wallTopY = halfWidth - ballRadius;
+    const float wallBottomY = -halfWidth + ballRadius;
+    const float leftSnapX = -halfLen + config.paddleDepth + ballRadius + 0.01f;
+    const float rightSnapX = halfLen - config.paddleDepth - ballRadius - 0.01f;
+
+    // Paddle colliders expanded by the ball radius, in ball-centre space
+    const float leftMinX = -halfLen - ballRadius;
+    const float leftMaxX = -halfLen + config.paddleDepth + pad + ballRadius;
+    const float rightMinX = halfLen - config.paddleDepth - pad - ballRadius;
+    const float rightMaxX = halfLen + ballRadius;
+
+    float& x = state.ballX;
+    float& y = state.ballY;
+    float& vx = state.ballVelX;
+    float& vy = state.ballVelY;
+
+    unsigned flags = 0;
+    float remaining = deltaTime;
+    int events = 0;
+    for (; remaining > 0.0f && events < config.maxEvents; ++events) {
+        enum { None, TopWall, BottomWall, Paddle, Goal } kind = None;
+        float tNext = remaining;
+
+        if (vy > 0.0f) {
+            float t = std::max((wallTopY - y) / vy, 0.0f);
+            if (t <= tNext) { tNext = t; kind = TopWall; }
+        } else if (vy < 0.0f) {
+            float t = std::max((wallBottomY - y) / vy, 0.0f);
+            if (t <= tNext) { tNext = t; kind = BottomWall; }
+        }
+
+        // Only the paddle the ball is travelling towards can be hit
+        bool towardLeft = vx < 0.0f;
+        float paddleY = towardLeft ? state.paddleLeftY : state.paddleRightY;
+        float tEnterX, tExitX, tEnterY, tExitY;
+        if (vx != 0.0f &&
+            slab(x, vx, towardLeft ? leftMinX : rightMinX, towardLeft ? leftMaxX : rightMaxX, tEnterX, tExitX) &&
+            slab(y, vy, paddleY - paddleHalfH - ballRadius, paddleY + paddleHalfH + ballRadius, tEnterY, tExitY)) {
+            float tEnter = std::max({tEnterX, tEnterY, 0.0f});
+            float tExit = std::min(tExitX, tExitY);
+            if (tEnter < tExit && tEnter <= tNext) { tNext = tEnter; kind = Paddle; }
+        }
+
+        float goalX = towardLeft ? -halfLen : halfLen;
+        if (vx != 0.0f && (towardLeft ? x >= goalX : x <= goalX)) {
+            float t = (goalX - x) / vx;
+            if (t < tNext) { tNext = t; kind = Goal; }
+        }
+
+        x += vx * tNext;
+        y += vy * tNext;
+        remaining -= tNext;
+
+        if (kind == TopWall) {
+            y = wallTopY;
+            vy = -std::abs(vy);
+        } else if (kind == BottomWall) {
+            y = wallBottomY;
+            vy = std::abs(vy);
+        } else if (kind == Paddle) {
+            x = towardLeft ? leftSnapX : rightSnapX;
+            float newSpeed = std::min(std::sqrt(vx * vx + vy * vy) * config.speedBoost, config.maxSpeed);
+            float scale = newSpeed / std::sqrt(vx * vx + vy * vy);
+            vx = (towardLeft ? std::abs(vx) : -std::abs(vx)) * scale;
+            vy *= scale;
+            flags |= towardLeft ? LeftPaddleHit : RightPaddleHit;
+        } else if (kind == Goal) {
+            // Just across the line so scoreGoals() counts it; the rest of the frame is moot
+            x = std::nextafter(goalX, towardLeft ? -INFINITY : INFINITY);
+            ++events;
+            break;
+        }
+    }
+    iterations = events;
+    return flags;
+}
+
+// One paddle through its policy: a batch of one
+static void movePolicyPaddle(MatchState& state, const MatchConfig& config, const AIParams& params, float side,
+                             float& paddleY, const AIState& ai, float deltaTime) {
+    AIObservations obs;
+    obs.count = 1;
+    obs.side = side;
+    obs.ballX = &state.ballX;
+    obs.ballY = &state.ballY;
+    obs.ballVelX = &state.ballVelX;
+    obs.ballVelY = &state.ballVelY;
+    obs.paddleY = &paddleY;
+    obs.aimOffset = &ai.targetOffset;
+    float target;
+    params.policy->evaluate(obs, config, &target);
+    moveTowardTargets(&target, &paddleY, 1, params.speed * deltaTime, (config.tableWidth - config.paddleHeight) / 2.0f);
+}
+
+template <typename Source>
+static void moveAIPaddlesWith(MatchState& state, Source source, const MatchInputs& inputs, float deltaTime) {
+    const MatchConfig& config = source.get();
+    deltaTime = std::min(deltaTime, config.maxFrameDt);
+    const bool fixed = config.integrator == Integrator::Fixed;
+    if (inputs.leftAI) {
+        if (config.aiLeft.policy)
+            movePolicyPaddle(state, config, config.aiLeft, -1.0f, state.paddleLeftY, state.aiLeft, deltaTime);
+        else if (fixed)
+            moveAIPaddleFixed(state, config, config.aiLeft, false, state.paddleLeftY, state.aiLeft,
+                              toFixedTime(deltaTime));
+        else
+            moveAIPaddle(state, config, config.aiLeft, -1.0f, state.paddleLeftY, state.aiLeft, deltaTime);
+    }
+    if (inputs.rightAI) {
+        if (config.aiRight.policy)
+            movePolicyPaddle(state, config, config.aiRight, 1.0f, state.paddleRightY, state.aiRight, deltaTime);
+        else if (fixed)
+            moveAIPaddleFixed(state, config, config.aiRight, true, state.paddleRightY, state.aiRight,
+                              toFixedTime(deltaTime));
+        else
+            moveAIPaddle(state, config, config.aiRight, 1.0f, state.paddleRightY, state.aiRight, deltaTime);
+    }
+}
+
+template <typename Source>
+static unsigned stepBeforeAIWith(MatchState& state, Source source, const MatchInputs& inputs, float deltaTime,
+                                 StepStats* stats) {
+    const MatchConfig& config = source.get();
+    deltaTime = std::min(deltaTime, config.maxFrameDt);
+    if (config.integrator == Integrator::Fixed) return stepBeforeAIFixed(state, config, inputs, deltaTime, stats);
+
+    if (!inputs.leftAI)
+        state.paddleLeftY += inputs.leftAxis * config.paddleSpeed * deltaTime;
+    if (!inputs.rightAI)
+        state.paddleRightY += inputs.rightAxis * config.paddleSpeed * deltaTime;
+
+    float limit = (config.tableWidth - config.paddleHeight) / 2.0f;
+    state.paddleLeftY = std::clamp(state.paddleLeftY, -limit, limit);
+    state.paddleRightY = std::clamp(state.paddleRightY, -limit, limit);
+
+    int iterations = 0;
+    unsigned events = config.integrator == Integrator::Substep
+        ? integrateSubsteps(state, source, deltaTime, iterations)
+        : integrateEvents(state, source, deltaTime, iterations);
+    if (stats) stats->iterations = iterations;
+
+    events |= scoreGoalsWith(state, source);
+
+    updateAIMistakesWith(state, source, inputs, deltaTime);
+    return events;
+}
+
+
+unsigned stepBeforeAI(MatchState& state, const MatchConfig& config, const MatchInputs& inputs, float deltaTime,
+                      StepStats* stats) {
+    return stepBeforeAIWith(state, RuntimeConfig{config}, inputs, deltaTime, stats);
+}
+
+void moveAIPaddles(MatchState& state, const MatchConfig& config, const MatchInputs& inputs, float deltaTime) {
+    moveAIPaddlesWith(state, RuntimeConfig{config}, inputs, deltaTime);
+}
+
+unsigned step(MatchState& state, const MatchConfig& config, const MatchInputs& inputs, float deltaTime,
+              StepStats* stats) {
+    unsigned events = stepBeforeAIWith(state, RuntimeConfig{config}, inputs, deltaTime, stats);
+    moveAIPaddlesWith(state, RuntimeConfig{config}, inputs, deltaTime);
+    return events;
+}
+
+template <const MatchConfig& Config>
+unsigned step(MatchState& state, const MatchInputs& inputs, float deltaTime, StepStats* stats) {
+    unsigned events = stepBeforeAIWith(state, StaticConfig<Config>(), inputs, deltaTime, stats);
+    moveAIPaddlesWith(state, StaticConfig<Config>(), inputs, deltaTime);
+    return events;
+}
+
+template unsigned step<ClassicConfig>(MatchState&, const MatchInputs&, float, StepStats*);
+template unsigned step<WideConfig>(MatchState&, const MatchInputs&, float, StepStats*);
+template unsigned step<MiniConfig>(MatchState&, const MatchInputs&, float, StepStats*);
+
+static bool sameAI(const AIParams& a, const AIParams& b) {
+    return a.speed == b.speed && a.mistakeRange == b.mistakeRange &&
+           a.mistakeChangeInterval == b.mistakeChangeInterval && a.policy == b.policy;
+}
+
+bool sameConfig(const MatchConfig& a, const MatchConfig& b) {
+    return a.tableLength == b.tableLength && a.tableWidth == b.tableWidth && a.paddleHeight == b.paddleHeight &&
+           a.paddleDepth == b.paddleDepth && a.ballRadius == b.ballRadius && a.paddleSpeed == b.paddleSpeed &&
+           a.speedBoost == b.speedBoost && a.maxSpeed == b.maxSpeed && sameAI(a.aiLeft, b.aiLeft) &&
+           sameAI(a.aiRight, b.aiRight) && a.integrator == b.integrator && a.fixedDt == b.fixedDt &&
+           a.maxSteps == b.maxSteps && a.maxEvents == b.maxEvents && a.maxFrameDt == b.maxFrameDt;
+}
+
+StaticStep findStaticStep(const MatchConfig& config) {
+    if (sameConfig(config, ClassicConfig)) return step<ClassicConfig>;
+    if (sameConfig(config, WideConfig)) return step<WideConfig>;
+    if (sameConfig(config, MiniConfig)) return step<MiniConfig>;
+    return nullptr;
+}
+
+}  // namespace sim
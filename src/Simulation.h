@@ -0,0 +1,170 @@
+#pragma once
+
+// GL-free match simulation: plain-data state plus a step function.
+// Shared by the windowed game and the headless tools.
+
+#include <cstdint>
+
+namespace sim {
+
+class AIPolicy;
+
+// How the ball is advanced within a frame.
+//  Event   - closed-form: jump straight to the next wall, paddle or goal-line
+//            crossing. Cost scales with events, not elapsed time; no tunneling.
+//  Substep - the original 600 Hz swept-AABB loop, kept as a reference.
+//  Fixed   - the Substep loop in Q16.16 integers (FixedPoint.h), together
+//            with the built-in AI tracker and serves: bit-identical on every
+//            platform and compiler. The default when built with
+//            CPONG_FIXED_POINT. AIPolicy sides still run in float.
+enum class Integrator {
+    Event,
+    Substep,
+    Fixed
+};
+
+// AI tuning, per side so tuned AIs can play a baseline. `policy` decides
+// where the paddle aims (see AIPolicy.h; nullptr is the built-in reactive
+// tracker) and `speed` caps how fast it gets there. Input logs store the
+// policy's spec and build it again on load.
+struct AIParams {
+    float speed = 11.0f;
+    float mistakeRange = 2.5f;
+    float mistakeChangeInterval = 0.35f;
+    const AIPolicy* policy = nullptr;
+};
+
+// Table geometry and gameplay constants. Defaults match the original game.
+struct MatchConfig {
+    float tableLength = 20.0f;
+    float tableWidth = 12.0f;
+    float paddleHeight = 2.5f;
+    float paddleDepth = 0.5f;
+    float ballRadius = 0.4f;
+
+    float paddleSpeed = 14.0f;
+    float speedBoost = 1.08f;
+    float maxSpeed = 28.0f;
+
+    AIParams aiLeft;
+    AIParams aiRight;
+
+#ifdef CPONG_FIXED_POINT
+    Integrator integrator = Integrator::Fixed;
+#else
+    Integrator integrator = Integrator::Event;
+#endif
+    float fixedDt = 1.0f / 600.0f;  // Substep and Fixed
+    int maxSteps = 160;             // Substep and Fixed
+    int maxEvents = 64;             // Event only: safety cap per frame
+    float maxFrameDt = 0.05f;
+};
+
+// Predefined tables. constexpr, so step<Config>() below can be compiled with
+// every dimension and constant folded in.
+inline constexpr MatchConfig ClassicConfig{};
+
+constexpr MatchConfig makeWideConfig() {
+    MatchConfig c;
+    c.tableLength = 28.0f;
+    c.tableWidth = 16.0f;
+    c.paddleHeight = 3.0f;
+    c.paddleSpeed = 17.0f;
+    c.maxSpeed = 34.0f;
+    c.aiLeft.speed = c.aiRight.speed = 13.5f;
+    return c;
+}
+inline constexpr MatchConfig WideConfig = makeWideConfig();
+
+constexpr MatchConfig makeMiniConfig() {
+    MatchConfig c;
+    c.tableLength = 14.0f;
+    c.tableWidth = 8.0f;
+    c.paddleHeight = 2.0f;
+    c.ballRadius = 0.3f;
+    c.paddleSpeed = 11.0f;
+    c.maxSpeed = 20.0f;
+    c.aiLeft.speed = c.aiRight.speed = 8.5f;
+    return c;
+}
+inline constexpr MatchConfig MiniConfig = makeMiniConfig();
+
+struct AIState {
+    float targetOffset = 0.0f;
+    float mistakeTimer = 0.0f;
+};
+
+struct MatchState {
+    float ballX = 0.0f, ballY = 0.0f;
+    float ballVelX = 0.0f, ballVelY = 0.0f;
+    float paddleLeftY = 0.0f;
+    float paddleRightY = 0.0f;
+    int scoreLeft = 0;
+    int scoreRight = 0;
+    AIState aiLeft;
+    AIState aiRight;
+    std::uint64_t rng = 0;  // PCG32 state; all randomness in a match comes from here
+};
+
+// Paddle hits and goals that happened during a step().
+enum StepEvent : unsigned {
+    LeftPaddleHit = 1u << 0,
+    RightPaddleHit = 1u << 1,
+    LeftScored = 1u << 2,
+    RightScored = 1u << 3
+};
+
+// Integrator work done by one step(), for profiling.
+struct StepStats {
+    int iterations = 0;  // substeps (Substep) or straight flight segments (Event)
+};
+
+// Per-frame controls. Axis is -1 (down) .. 1 (up); AI sides ignore their axis.
+struct MatchInputs {
+    float leftAxis = 0.0f;
+    float rightAxis = 0.0f;
+    bool leftAI = false;
+    bool rightAI = true;
+};
+
+// Next value of the match's PCG32 stream.
+std::uint32_t nextRandom(MatchState& state);
+
+void resetBall(MatchState& state);
+// Fresh 0:0 match whose random stream is fully determined by `seed`. The
+// opening serve uses the config's integrator, like every serve after a goal.
+void resetMatch(MatchState& state, std::uint64_t seed, const MatchConfig& config);
+
+// Frame stages run by step() after ball physics; exposed so batched
+// steppers can reuse them for the matches that need scalar handling.
+unsigned scoreGoals(MatchState& state, const MatchConfig& config);
+void updateAIMistakes(MatchState& state, const MatchConfig& config, const MatchInputs& inputs, float dt);
+
+// Advance one frame: paddle input, fixed-step ball physics, scoring, then AI.
+// Returns the StepEvent flags raised during the frame.
+unsigned step(MatchState& state, const MatchConfig& config, const MatchInputs& inputs, float dt,
+              StepStats* stats = nullptr);
+
+// step() split before its last stage, the AI paddle move, so batched
+// steppers can evaluate AI policies for many matches in one call.
+unsigned stepBeforeAI(MatchState& state, const MatchConfig& config, const MatchInputs& inputs, float dt,
+                      StepStats* stats = nullptr);
+void moveAIPaddles(MatchState& state, const MatchConfig& config, const MatchInputs& inputs, float dt);
+
+// step() specialised for a constexpr config; bit-identical to
+// step(state, Config, ...). Instantiated for the predefined tables only.
+template <const MatchConfig& Config>
+unsigned step(MatchState& state, const MatchInputs& inputs, float dt, StepStats* stats = nullptr);
+
+extern template unsigned step<ClassicConfig>(MatchState&, const MatchInputs&, float, StepStats*);
+extern template unsigned step<WideConfig>(MatchState&, const MatchInputs&, float, StepStats*);
+extern template unsigned step<MiniConfig>(MatchState&, const MatchInputs&, float, StepStats*);
+
+// The specialised step for `config` if it equals a predefined table, else
+// nullptr: call step(state, config, ...) instead.
+using StaticStep = unsigned (*)(MatchState&, const MatchInputs&, float, StepStats*);
+StaticStep findStaticStep(const MatchConfig& config);
+
+bool sameConfig(const MatchConfig& a, const MatchConfig& b);
+
+}  // namespace sim
@@ -0,0 +1,148 @@
+#include "Snapshot.h"
+#include <cmath>
+
+namespace sim {
+
+namespace {
+
+const float PositionScale = 256.0f;
+
+enum FrameType : unsigned char { Key = 1, Delta = 2 };
+
+std::int32_t quantize(float value) {
+    return static_cast<std::int32_t>(std::lround(value * PositionScale));
+}
+
+unsigned char* putVarint(unsigned char* out, std::uint32_t value) {
+    while (value >= 0x80) {
+        *out++ = static_cast<unsigned char>(value | 0x80);
+        value >>= 7;
+    }
+    *out++ = static_cast<unsigned char>(value);
+    return out;
+}
+
+unsigned char* putSigned(unsigned char* out, std::int32_t value) {
+    return putVarint(out, (static_cast<std::uint32_t>(value) << 1) ^ static_cast<std::uint32_t>(value >> 31));
+}
+
+// False when the varint runs past `end` or over 32 bits
+bool getVarint(const unsigned char*& p, const unsigned char* end, std::uint32_t& value) {
+    value = 0;
+    for (int shift = 0; shift < 35; shift += 7) {
+        if (p == end) return false;
+        unsigned char b = *p++;
+        value |= static_cast<std::uint32_t>(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+bool getSigned(const unsigned char*& p, const unsigned char* end, std::int32_t& value) {
+    std::uint32_t u;
+    if (!getVarint(p, end, u)) return false;
+    value = static_cast<std::int32_t>(u >> 1) ^ -static_cast<std::int32_t>(u & 1);
+    return true;
+}
+
+}  // namespace
+
+QuantizedState quantizeState(const MatchState& state, std::uint32_t tick) {
+    QuantizedState q;
+    q.tick = tick;
+    q.fields[QuantizedState::BallX] = quantize(state.ballX);
+    q.fields[QuantizedState::BallY] = quantize(state.ballY);
+    q.fields[QuantizedState::BallVelX] = quantize(state.ballVelX);
+    q.fields[QuantizedState::BallVelY] = quantize(state.ballVelY);
+    q.fields[QuantizedState::PaddleLeftY] = quantize(state.paddleLeftY);
+    q.fields[QuantizedState::PaddleRightY] = quantize(state.paddleRightY);
+    q.fields[QuantizedState::ScoreLeft] = state.scoreLeft;
+    q.fields[QuantizedState::ScoreRight] = state.scoreRight;
+    return q;
+}
+
+void dequantizeState(const QuantizedState& q, MatchState& state) {
+    const float inv = 1.0f / PositionScale;
+    state.ballX = q.fields[QuantizedState::BallX] * inv;
+    state.ballY = q.fields[QuantizedState::BallY] * inv;
+    state.ballVelX = q.fields[QuantizedState::BallVelX] * inv;
+    state.ballVelY = q.fields[QuantizedState::BallVelY] * inv;
+    state.paddleLeftY = q.fields[QuantizedState::PaddleLeftY] * inv;
+    state.paddleRightY = q.fields[QuantizedState::PaddleRightY] * inv;
+    state.scoreLeft = q.fields[QuantizedState::ScoreLeft];
+    state.scoreRight = q.fields[QuantizedState::ScoreRight];
+}
+
+std::size_t encodeKeyframe(const QuantizedState& q, unsigned char* out) {
+    unsigned char* p = out + 1;
+    *p++ = Key;
+    p = putVarint(p, q.tick);
+    for (std::int32_t value : q.fields) p = putSigned(p, value);
+    out[0] = static_cast<unsigned char>(p - out);
+    return static_cast<std::size_t>(p - out);
+}
+
+std::size_t encodeDelta(const QuantizedState& base, const QuantizedState& q, unsigned char* out) {
+    unsigned char* p = out + 1;
+    *p++ = Delta;
+    p = putVarint(p, q.tick);
+    p = putVarint(p, q.tick - base.tick);
+    unsigned char* mask = p++;
+    *mask = 0;
+    for (int f = 0; f < QuantizedState::FieldCount; ++f) {
+        if (q.fields[f] == base.fields[f]) continue;
+        *mask |= static_cast<unsigned char>(1u << f);
+        p = putSigned(p, q.fields[f] - base.fields[f]);
+    }
+    out[0] = static_cast<unsigned char>(p - out);
+    return static_cast<std::size_t>(p - out);
+}
+
+int SnapshotDecoder::decode(const unsigned char* data, std::size_t size) {
+    m_updated = false;
+    if (size == 0 || size < data[0]) return Incomplete;
+    const std::size_t frameSize = data[0];
+    if (frameSize < 3 || frameSize > MaxSnapshotFrame) return Error;
+
+    const unsigned char* p = data + 2;
+    const unsigned char* end = data + frameSize;
+    QuantizedState q;
+    if (!getVarint(p, end, q.tick)) return Error;
+
+    if (data[1] == Key) {
+        for (std::int32_t& value : q.fields)
+            if (!getSigned(p, end, value)) return Error;
+        m_key = q;
+        m_hasKey = true;
+        m_wasKeyframe = true;
+    } else if (data[1] == Delta) {
+        std::uint32_t back;
+        if (!getVarint(p, end, back) || p == end) return Error;
+        unsigned mask = *p++;
+        const std::uint32_t baseTick = q.tick - back;
+        const QuantizedState* base = nullptr;
+        if (m_hasState && m_latest.tick == baseTick)
+            base = &m_latest;
+        else if (m_hasKey && m_key.tick == baseTick)
+            base = &m_key;
+        for (int f = 0; f < QuantizedState::FieldCount; ++f) {
+            std::int32_t diff = 0;
+            if ((mask & (1u << f)) && !getSigned(p, end, diff)) return Error;
+            if (base) q.fields[f] = base->fields[f] + diff;
+        }
+        if (!base) return static_cast<int>(frameSize);
+        m_wasKeyframe = false;
+    } else {
+        return Error;
+    }
+    if (p != end) return Error;
+
+    // Datagrams can arrive out of order: never step back in time
+    if (m_hasState && static_cast<std::int32_t>(q.tick - m_latest.tick) <= 0) return static_cast<int>(frameSize);
+    m_latest = q;
+    m_hasState = true;
+    m_updated = true;
+    return static_cast<int>(frameSize);
+}
+
+}  // namespace sim
@@ -0,0 +1,66 @@
+#pragma once
+
+// Spectator snapshots: the visible part of a MatchState, quantized and
+// delta-encoded for broadcast.
+//
+//   frame    u8 size (whole frame), u8 type, varint tick, then
+//   key      all fields
+//   delta    varint (tick - base tick), u8 changed-field mask, changed fields
+//            as differences from the base
+//
+// Fields are zigzag varints: ball and paddle positions and ball velocity in
+// 1/256 units, then both scores. Ticks count 60 Hz simulation ticks. A delta
+// decodes against the previous frame (ordered streams) or the last keyframe
+// (datagrams, which may be lost).
+
+#include "Simulation.h"
+#include <cstddef>
+#include <cstdint>
+
+namespace sim {
+
+const int SnapshotTickHz = 60;
+const std::size_t MaxSnapshotFrame = 48;
+
+struct QuantizedState {
+    enum Field { BallX, BallY, BallVelX, BallVelY, PaddleLeftY, PaddleRightY, ScoreLeft, ScoreRight, FieldCount };
+
+    std::uint32_t tick = 0;
+    std::int32_t fields[FieldCount] = {};
+};
+
+QuantizedState quantizeState(const MatchState& state, std::uint32_t tick);
+// Fills the visible fields of `state`; AI and random state are left alone
+void dequantizeState(const QuantizedState& q, MatchState& state);
+
+// Both return the frame size, at most MaxSnapshotFrame
+std::size_t encodeKeyframe(const QuantizedState& q, unsigned char* out);
+std::size_t encodeDelta(const QuantizedState& base, const QuantizedState& q, unsigned char* out);
+
+// Rebuilds states from frames of one stream.
+class SnapshotDecoder {
+public:
+    enum Result { Incomplete = 0, Error = -1 };
+
+    // Decodes the frame at the start of `data`: returns the bytes it took, 0
+    // if it is not all there yet, or -1 if it is malformed. Deltas whose base
+    // is neither the last frame nor the last keyframe are skipped (consumed
+    // without changing the state).
+    int decode(const unsigned char* data, std::size_t size);
+
+    bool hasState() const { return m_hasState; }
+    const QuantizedState& latest() const { return m_latest; }
+    // True when the last decode() produced a new state, and whether it was a keyframe
+    bool updated() const { return m_updated; }
+    bool wasKeyframe() const { return m_wasKeyframe; }
+
+private:
+    QuantizedState m_latest;
+    QuantizedState m_key;
+    bool m_hasState = false;
+    bool m_hasKey = false;
+    bool m_updated = false;
+    bool m_wasKeyframe = false;
+};
+
+}  // namespace sim
@@ -0,0 +1,82 @@
+#include "SpectatorClient.h"
+#include "SimThread.h"
+
+namespace sim {
+
+namespace {
+
+double localTicks(std::int64_t nowNs) {
+    return static_cast<double>(nowNs) * (SnapshotTickHz * 1e-9);
+}
+
+}  // namespace
+
+bool SpectatorClient::connect(const std::string& host, std::uint16_t port, std::string& error) {
+    return UdpSocket::resolve(host, port, m_server, error) && m_socket.open(0, error);
+}
+
+void SpectatorClient::poll(std::int64_t nowNs) {
+    if (!m_socket.isOpen()) return;
+    if (m_lastSubscribeNs == 0 || nowNs - m_lastSubscribeNs >= 1000000000LL) {
+        m_socket.send(m_server, "CPSP", 4);
+        m_lastSubscribeNs = nowNs;
+    }
+
+    unsigned char packet[512];
+    UdpSocket::Address from;
+    for (int size; (size = m_socket.receive(packet, sizeof(packet), from)) > 0;) {
+        if (from != m_server) continue;
+        for (int offset = 0; offset < size;) {
+            int used = m_decoder.decode(packet + offset, static_cast<std::size_t>(size - offset));
+            if (used <= 0) break;
+            offset += used;
+            if (!m_decoder.updated()) continue;
+
+            const QuantizedState& q = m_decoder.latest();
+            if (m_count > 0) {
+                const Received& newest = m_history[(m_first + m_count - 1) % History];
+                double gap = static_cast<double>(q.tick - newest.tick);
+                if (gap < 30.0) m_interval += (gap - m_interval) * 0.1;
+            }
+            if (m_count == History) {
+                m_first = (m_first + 1) % History;
+                m_count--;
+            }
+            Received& slot = m_history[(m_first + m_count) % History];
+            slot.tick = q.tick;
+            slot.state = MatchState();
+            dequantizeState(q, slot.state);
+            m_count++;
+
+            // Track the earliest-arriving snapshots; drift slowly towards late ones
+            double offsetNow = q.tick - localTicks(nowNs);
+            if (m_count == 1 || offsetNow > m_tickOffset || offsetNow < m_tickOffset - 120.0)
+                m_tickOffset = offsetNow;
+            else
+                m_tickOffset += (offsetNow - m_tickOffset) * 0.02;
+        }
+    }
+}
+
+MatchState SpectatorClient::sample(std::int64_t nowNs) const {
+    // Two snapshot intervals behind the newest: absorbs jitter and one loss
+    const double playTick = localTicks(nowNs) + m_tickOffset - 2.0 * m_interval;
+
+    const Received* before = nullptr;
+    const Received* after = nullptr;
+    for (int i = 0; i < m_count; ++i) {
+        const Received& r = m_history[(m_first + i) % History];
+        if (r.tick <= playTick) {
+            before = &r;
+        } else {
+            after = &r;
+            break;
+        }
+    }
+    if (!before) return m_history[m_first].state;
+    if (!after) return before->state;
+    float alpha = static_cast<float>((playTick - before->tick) / (after->tick - before->tick));
+    return interpolate(before->state, after->state, alpha);
+}
+
+}  // namespace sim
@@ -0,0 +1,49 @@
+#pragma once
+
+// Watches a match broadcast by SpectatorServer over UDP. Received snapshots
+// are played back a little behind the newest one, interpolated between the
+// two around the playback time, so a 20 Hz feed with jitter and the odd
+// lost datagram still moves smoothly.
+
+#include "Simulation.h"
+#include "Snapshot.h"
+#include "UdpSocket.h"
+#include <cstdint>
+#include <string>
+
+namespace sim {
+
+class SpectatorClient {
+public:
+    bool connect(const std::string& host, std::uint16_t port, std::string& error);
+
+    // Renews the subscription once a second and decodes what arrived
+    void poll(std::int64_t nowNs);
+
+    bool hasState() const { return m_count > 0; }
+    // The match as it should be drawn at `nowNs`
+    MatchState sample(std::int64_t nowNs) const;
+
+private:
+    static const int History = 8;
+
+    struct Received {
+        std::uint32_t tick;
+        MatchState state;
+    };
+
+    UdpSocket m_socket;
+    UdpSocket::Address m_server;
+    std::int64_t m_lastSubscribeNs = 0;
+    SnapshotDecoder m_decoder;
+
+    Received m_history[History];  // ring, oldest first from m_first
+    int m_first = 0;
+    int m_count = 0;
+
+    // Server tick at local time t: t * SnapshotTickHz / 1e9 + m_tickOffset
+    double m_tickOffset = 0.0;
+    double m_interval = 3.0;  // ticks between snapshots, smoothed
+};
+
+}  // namespace sim
@@ -0,0 +1,322 @@
+#include "SpectatorServer.h"
+#include <algorithm>
+#include <arpa/inet.h>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+namespace sim {
+
+namespace {
+
+const std::uint64_t ListenId = 0;
+const std::uint64_t UdpId = 1;
+const std::size_t SlotBase = 2;
+const int EventBatch = 1024;
+const std::size_t SendBatch = 512;
+
+std::uint64_t udpKey(std::uint32_t ip, std::uint16_t port) {
+    return (static_cast<std::uint64_t>(ip) << 16) | port;
+}
+
+}  // namespace
+
+SpectatorServer::SpectatorServer(std::size_t maxClients, std::uint32_t keyframeInterval)
+    : m_maxClients(maxClients), m_keyframeInterval(keyframeInterval ? keyframeInterval : 1) {}
+
+SpectatorServer::~SpectatorServer() {
+    for (std::size_t slot = 0; slot < m_tcp.size(); ++slot)
+        if (m_tcp[slot] && m_tcp[slot]->fd >= 0) ::close(m_tcp[slot]->fd);
+    if (m_listen >= 0) ::close(m_listen);
+    if (m_udpSocket >= 0) ::close(m_udpSocket);
+    if (m_epoll >= 0) ::close(m_epoll);
+}
+
+bool SpectatorServer::open(std::uint16_t port, std::string& error) {
+    m_epoll = epoll_create1(EPOLL_CLOEXEC);
+    m_listen = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    m_udpSocket = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    if (m_epoll < 0 || m_listen < 0 || m_udpSocket < 0) {
+        error = std::string("cannot create sockets: ") + std::strerror(errno);
+        return false;
+    }
+    int one = 1;
+    setsockopt(m_listen, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+    // Subscription renewals arrive in bursts of thousands; the default
+    // buffer holds a few hundred tiny datagrams. Capped by net.core.rmem_max.
+    int receiveBuffer = 8 << 20;
+    setsockopt(m_udpSocket, SOL_SOCKET, SO_RCVBUF, &receiveBuffer, sizeof(receiveBuffer));
+
+    sockaddr_in sa;
+    std::memset(&sa, 0, sizeof(sa));
+    sa.sin_family = AF_INET;
+    sa.sin_addr.s_addr = htonl(INADDR_ANY);
+    sa.sin_port = htons(port);
+    if (bind(m_listen, reinterpret_cast<sockaddr*>(&sa), sizeof(sa)) != 0 || listen(m_listen, 4096) != 0) {
+        error = "cannot listen on TCP port " + std::to_string(port) + ": " + std::strerror(errno);
+        return false;
+    }
+    // UDP on the same number, which is only known now when port is 0
+    socklen_t len = sizeof(sa);
+    getsockname(m_listen, reinterpret_cast<sockaddr*>(&sa), &len);
+    m_port = ntohs(sa.sin_port);
+    if (bind(m_udpSocket, reinterpret_cast<sockaddr*>(&sa), sizeof(sa)) != 0) {
+        error = "cannot bind UDP port " + std::to_string(m_port) + ": " + std::strerror(errno);
+        return false;
+    }
+
+    epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.u64 = ListenId;
+    epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_listen, &ev);
+    ev.data.u64 = UdpId;
+    epoll_ctl(m_epoll, EPOLL_CTL_ADD, m_udpSocket, &ev);
+    return true;
+}
+
+void SpectatorServer::publish(const MatchState& state, std::uint32_t tick, std::int64_t nowNs) {
+    const QuantizedState q = quantizeState(state, tick);
+
+    unsigned char key[MaxSnapshotFrame];
+    unsigned char delta[MaxSnapshotFrame];
+    const std::size_t keySize = encodeKeyframe(q, key);
+    const std::size_t deltaSize = m_hasLast ? encodeDelta(m_last, q, delta) : 0;
+    m_stats.keyBytes += keySize;
+    m_stats.keyFrames++;
+    if (deltaSize) {
+        m_stats.deltaBytes += deltaSize;
+        m_stats.deltaFrames++;
+    }
+
+    const bool sendNow = ++m_publishes % m_tcpBatch == 0;
+    for (std::size_t slot = 0; slot < m_tcp.size(); ++slot) {
+        TcpClient* client = m_tcp[slot].get();
+        if (!client || client->fd < 0) continue;
+        queue(*client, key, keySize, delta, deltaSize);
+        if (sendNow && !client->waitingOut) flush(slot);
+    }
+
+    // UDP: keyframes on schedule, otherwise a delta from the last one
+    const bool newKey = !m_hasLast || q.tick - m_lastKey.tick >= m_keyframeInterval;
+    if (newKey) {
+        m_lastKey = q;
+        std::memcpy(m_lastKeyFrame, key, keySize);
+        m_lastKeySize = keySize;
+    }
+    for (std::size_t i = 0; i < m_udp.size();) {
+        if (m_udp[i].expiresNs > nowNs) {
+            ++i;
+            continue;
+        }
+        m_udpIndex.erase(udpKey(m_udp[i].ip, m_udp[i].port));
+        m_udp[i] = m_udp.back();
+        m_udp.pop_back();
+        if (i < m_udp.size()) m_udpIndex[udpKey(m_udp[i].ip, m_udp[i].port)] = i;
+        m_stats.udpExpired++;
+    }
+    if (!m_udp.empty()) {
+        unsigned char udpDelta[MaxSnapshotFrame];
+        const std::size_t udpSize = newKey ? keySize : encodeDelta(m_lastKey, q, udpDelta);
+        sendUdp(newKey ? key : udpDelta, udpSize, 0, m_udp.size());
+    }
+
+    m_last = q;
+    m_hasLast = true;
+}
+
+void SpectatorServer::queue(TcpClient& client, const unsigned char* key, std::size_t keySize,
+                            const unsigned char* delta, std::size_t deltaSize) {
+    const bool useKey = client.needKey || deltaSize == 0;
+    const unsigned char* frame = useKey ? key : delta;
+    const std::size_t size = useKey ? keySize : deltaSize;
+
+    if (client.end + size > TcpBufferSize && client.begin > 0) {
+        std::memmove(client.buffer, client.buffer + client.begin, client.end - client.begin);
+        client.end = static_cast<std::uint16_t>(client.end - client.begin);
+        client.begin = 0;
+    }
+    if (client.end + size > TcpBufferSize) {
+        // Too far behind: drop this frame, resync with a keyframe later
+        client.needKey = true;
+        m_stats.framesSkipped++;
+        return;
+    }
+    std::memcpy(client.buffer + client.end, frame, size);
+    client.end = static_cast<std::uint16_t>(client.end + size);
+    client.needKey = false;
+    m_stats.framesQueued++;
+}
+
+void SpectatorServer::flush(std::size_t slot) {
+    TcpClient& client = *m_tcp[slot];
+    if (client.begin < client.end) {
+        ssize_t n = ::send(client.fd, client.buffer + client.begin, client.end - client.begin, MSG_NOSIGNAL);
+        m_stats.sendCalls++;
+        if (n > 0) {
+            m_stats.bytesSent += static_cast<std::uint64_t>(n);
+            client.begin = static_cast<std::uint16_t>(client.begin + n);
+        } else if (n < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR) {
+            drop(slot);
+            return;
+        }
+        if (client.begin == client.end) client.begin = client.end = 0;
+    }
+
+    // Only watch for writability while there is a backlog
+    const bool pending = client.begin < client.end;
+    if (pending != client.waitingOut) {
+        epoll_event ev;
+        ev.events = EPOLLIN | EPOLLRDHUP | (pending ? static_cast<std::uint32_t>(EPOLLOUT) : 0u);
+        ev.data.u64 = slot + SlotBase;
+        epoll_ctl(m_epoll, EPOLL_CTL_MOD, client.fd, &ev);
+        client.waitingOut = pending;
+    }
+}
+
+void SpectatorServer::drop(std::size_t slot) {
+    TcpClient& client = *m_tcp[slot];
+    ::close(client.fd);  // also removes it from the epoll set
+    client.fd = -1;
+    m_freeSlots.push_back(slot);
+    m_tcpCount--;
+    m_stats.disconnected++;
+}
+
+void SpectatorServer::accept() {
+    for (;;) {
+        int fd = accept4(m_listen, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd < 0) return;  // EAGAIN, or out of descriptors: retried on the next event
+        if (m_tcpCount >= m_maxClients) {
+            ::close(fd);
+            m_stats.rejected++;
+            continue;
+        }
+        int one = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+
+        std::size_t slot;
+        if (!m_freeSlots.empty()) {
+            slot = m_freeSlots.back();
+            m_freeSlots.pop_back();
+        } else {
+            slot = m_tcp.size();
+            m_tcp.emplace_back(new TcpClient());
+        }
+        TcpClient& client = *m_tcp[slot];
+        client.fd = fd;
+        client.needKey = true;
+        client.waitingOut = false;
+        client.begin = client.end = 0;
+
+        epoll_event ev;
+        ev.events = EPOLLIN | EPOLLRDHUP;
+        ev.data.u64 = slot + SlotBase;
+        epoll_ctl(m_epoll, EPOLL_CTL_ADD, fd, &ev);
+        m_tcpCount++;
+        m_stats.accepted++;
+    }
+}
+
+void SpectatorServer::readUdp(std::int64_t nowNs) {
+    unsigned char packet[64];
+    for (;;) {
+        sockaddr_in from;
+        socklen_t len = sizeof(from);
+        ssize_t n = recvfrom(m_udpSocket, packet, sizeof(packet), 0, reinterpret_cast<sockaddr*>(&from), &len);
+        if (n < 0) return;
+        if (n != 4 || std::memcmp(packet, "CPSP", 4) != 0) continue;
+
+        std::uint64_t id = udpKey(from.sin_addr.s_addr, from.sin_port);
+        auto it = m_udpIndex.find(id);
+        if (it != m_udpIndex.end()) {
+            m_udp[it->second].expiresNs = nowNs + UdpLeaseNs;
+            continue;
+        }
+        if (m_udp.size() >= m_maxClients) {
+            m_stats.rejected++;
+            continue;
+        }
+        m_udpIndex[id] = m_udp.size();
+        m_udp.push_back({from.sin_addr.s_addr, from.sin_port, nowNs + UdpLeaseNs});
+        m_stats.udpSubscribed++;
+        // Start it off with the keyframe current deltas refer to
+        if (m_lastKeySize) sendUdp(m_lastKeyFrame, m_lastKeySize, m_udp.size() - 1, 1);
+    }
+}
+
+void SpectatorServer::sendUdp(const unsigned char* frame, std::size_t size, std::size_t first, std::size_t count) {
+    mmsghdr messages[SendBatch];
+    sockaddr_in addresses[SendBatch];
+    iovec iov;
+    iov.iov_base = const_cast<unsigned char*>(frame);
+    iov.iov_len = size;
+
+    for (std::size_t done = 0; done < count;) {
+        const std::size_t n = std::min(SendBatch, count - done);
+        for (std::size_t i = 0; i < n; ++i) {
+            const UdpClient& client = m_udp[first + done + i];
+            std::memset(&addresses[i], 0, sizeof(sockaddr_in));
+            addresses[i].sin_family = AF_INET;
+            addresses[i].sin_addr.s_addr = client.ip;
+            addresses[i].sin_port = client.port;
+            std::memset(&messages[i], 0, sizeof(mmsghdr));
+            messages[i].msg_hdr.msg_name = &addresses[i];
+            messages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+            messages[i].msg_hdr.msg_iov = &iov;
+            messages[i].msg_hdr.msg_iovlen = 1;
+        }
+        int sent = sendmmsg(m_udpSocket, messages, static_cast<unsigned>(n), 0);
+        m_stats.sendCalls++;
+        // A full socket buffer drops the rest of this frame for this batch;
+        // datagram subscribers tolerate loss
+        const std::size_t accepted = sent > 0 ? static_cast<std::size_t>(sent) : 0;
+        m_stats.framesQueued += accepted;
+        m_stats.bytesSent += accepted * size;
+        done += accepted == 0 ? n : accepted;
+    }
+}
+
+void SpectatorServer::poll(int timeoutMs, std::int64_t nowNs) {
+    epoll_event events[EventBatch];
+    int n = epoll_wait(m_epoll, events, EventBatch, timeoutMs);
+    bool incoming = false;
+    for (int i = 0; i < n; ++i) {
+        const std::uint64_t id = events[i].data.u64;
+        if (id == ListenId) {
+            incoming = true;
+            continue;
+        }
+        if (id == UdpId) {
+            readUdp(nowNs);
+            continue;
+        }
+
+        const std::size_t slot = static_cast<std::size_t>(id - SlotBase);
+        TcpClient& client = *m_tcp[slot];
+        if (client.fd < 0) continue;  // dropped earlier in this batch
+        if (events[i].events & (EPOLLERR | EPOLLHUP | EPOLLRDHUP)) {
+            drop(slot);
+            continue;
+        }
+        if (events[i].events & EPOLLIN) {
+            // Spectators have nothing to say; anything but EOF is ignored
+            unsigned char discard[256];
+            ssize_t r = ::recv(client.fd, discard, sizeof(discard), 0);
+            if (r == 0 || (r < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != EINTR)) {
+                drop(slot);
+                continue;
+            }
+        }
+        if (events[i].events & EPOLLOUT) flush(slot);
+    }
+    // After the batch, so a slot freed above is not reused while later
+    // events in it still name the old connection
+    if (incoming) accept();
+}
+
+}  // namespace sim
@@ -0,0 +1,122 @@
+#pragma once
+
+// Broadcasts a live match to many spectators from one epoll loop (Linux).
+//
+// Each published state is quantized and encoded once - a keyframe and a
+// delta - and the same bytes go to every subscriber:
+//
+//   TCP  deltas against the previous frame. Every client has a fixed-size
+//        send buffer; one that falls that far behind skips frames and gets
+//        a keyframe once it has room again, so memory per client is bounded
+//        and a slow reader never stalls the rest. Frames can be coalesced,
+//        several per send: the syscall, not the bytes, is the cost.
+//   UDP  "CPSP" datagrams subscribe for a few seconds (resend to renew).
+//        Deltas are against the last keyframe, so a lost datagram costs
+//        only that frame. Sent with sendmmsg in batches.
+
+#include "Simulation.h"
+#include "Snapshot.h"
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace sim {
+
+class SpectatorServer {
+public:
+    static const std::size_t TcpBufferSize = 512;  // ~20 delta frames
+    static const std::int64_t UdpLeaseNs = 5000000000LL;
+
+    struct Stats {
+        std::uint64_t framesQueued = 0;   // per subscriber
+        std::uint64_t framesSkipped = 0;  // TCP client buffer full
+        std::uint64_t bytesSent = 0;
+        std::uint64_t sendCalls = 0;      // send + sendmmsg syscalls
+        std::uint64_t accepted = 0;
+        std::uint64_t disconnected = 0;
+        std::uint64_t rejected = 0;       // over maxClients
+        std::uint64_t udpSubscribed = 0;
+        std::uint64_t udpExpired = 0;
+        std::uint64_t keyBytes = 0, keyFrames = 0;      // encoded sizes, once per publish
+        std::uint64_t deltaBytes = 0, deltaFrames = 0;
+    };
+
+    // At most `maxClients` TCP and as many UDP subscribers. UDP deltas
+    // restart from a fresh keyframe every `keyframeInterval` ticks.
+    explicit SpectatorServer(std::size_t maxClients = 16384, std::uint32_t keyframeInterval = 60);
+    ~SpectatorServer();
+
+    SpectatorServer(const SpectatorServer&) = delete;
+    SpectatorServer& operator=(const SpectatorServer&) = delete;
+
+    // Listens on TCP and UDP `port` (0 picks one for both)
+    bool open(std::uint16_t port, std::string& error);
+    std::uint16_t port() const { return m_port; }
+
+    // Sends to TCP clients on every `publishes`-th publish only
+    void setTcpBatch(std::uint32_t publishes) { m_tcpBatch = publishes ? publishes : 1; }
+
+    // Queues `state` at `tick` (60 Hz ticks) to every subscriber
+    void publish(const MatchState& state, std::uint32_t tick, std::int64_t nowNs);
+
+    // Accepts, handles subscriptions and disconnects, and flushes clients
+    // whose socket was full. Waits up to `timeoutMs` for something to do.
+    void poll(int timeoutMs, std::int64_t nowNs);
+
+    std::size_t tcpClients() const { return m_tcpCount; }
+    std::size_t udpClients() const { return m_udp.size(); }
+    const Stats& stats() const { return m_stats; }
+
+private:
+    struct TcpClient {
+        int fd = -1;
+        bool needKey = true;     // next frame must be a keyframe
+        bool waitingOut = false; // registered for EPOLLOUT
+        std::uint16_t begin = 0, end = 0;
+        unsigned char buffer[TcpBufferSize];
+    };
+
+    struct UdpClient {
+        std::uint32_t ip;    // network byte order, as received
+        std::uint16_t port;
+        std::int64_t expiresNs;
+    };
+
+    void accept();
+    void readUdp(std::int64_t nowNs);
+    void queue(TcpClient& client, const unsigned char* key, std::size_t keySize, const unsigned char* delta,
+               std::size_t deltaSize);
+    void flush(std::size_t slot);
+    void drop(std::size_t slot);
+    void sendUdp(const unsigned char* frame, std::size_t size, std::size_t first, std::size_t count);
+
+    std::size_t m_maxClients;
+    std::uint32_t m_keyframeInterval;
+    std::uint32_t m_tcpBatch = 1;
+    std::uint64_t m_publishes = 0;
+    int m_epoll = -1;
+    int m_listen = -1;
+    int m_udpSocket = -1;
+    std::uint16_t m_port = 0;
+
+    // Slots are allocated on first use and reused; epoll data is slot + 2
+    std::vector<std::unique_ptr<TcpClient>> m_tcp;
+    std::vector<std::size_t> m_freeSlots;
+    std::size_t m_tcpCount = 0;
+
+    std::vector<UdpClient> m_udp;
+    std::unordered_map<std::uint64_t, std::size_t> m_udpIndex;  // ip:port -> m_udp index
+
+    bool m_hasLast = false;
+    QuantizedState m_last;     // previous frame, base for TCP deltas
+    QuantizedState m_lastKey;  // base for UDP deltas
+    unsigned char m_lastKeyFrame[MaxSnapshotFrame];
+    std::size_t m_lastKeySize = 0;
+
+    Stats m_stats;
+};
+
+}  // namespace sim
@@ -0,0 +1,329 @@
+#include "Telemetry.h"
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <limits>
+
+namespace sim {
+
+const TelemetryColumn TelemetryColumns[TelemetryFieldCount] = {
+    {"tick", TelemetryType::U64, 8},
+    {"dt", TelemetryType::F32, 4},
+    {"ballX", TelemetryType::F32, 4},
+    {"ballY", TelemetryType::F32, 4},
+    {"ballVelX", TelemetryType::F32, 4},
+    {"ballVelY", TelemetryType::F32, 4},
+    {"paddleLeftY", TelemetryType::F32, 4},
+    {"paddleRightY", TelemetryType::F32, 4},
+    {"events", TelemetryType::U32, 4},
+    {"scoreLeft", TelemetryType::I32, 4},
+    {"scoreRight", TelemetryType::I32, 4},
+};
+
+namespace {
+
+const char Magic[4] = {'C', 'P', 'T', 'L'};
+const std::uint32_t FormatVersion = 1;
+const std::uint64_t PageSize = 4096;
+const std::uint64_t InitialBlocks = 16;  // the file then doubles as it fills
+
+struct FileHeader {
+    char magic[4];
+    std::uint32_t version;
+    std::uint32_t columnCount;
+    std::uint32_t blockRows;
+    std::uint64_t blockCount;
+    std::uint64_t rowCount;
+    std::uint64_t blockBytes;
+    std::uint64_t firstBlockOffset;
+};
+
+struct BlockHeader {
+    std::uint64_t firstRow;
+    std::uint32_t rows;
+    std::uint32_t reserved;
+    // TelemetryRange per column follows
+};
+
+static_assert(sizeof(FileHeader) == 48, "FileHeader is part of the file format");
+static_assert(sizeof(BlockHeader) == 16, "BlockHeader is part of the file format");
+static_assert(sizeof(TelemetryColumn) == 24, "TelemetryColumn is part of the file format");
+
+std::uint64_t roundUp(std::uint64_t value, std::uint64_t multiple) {
+    return (value + multiple - 1) / multiple * multiple;
+}
+
+// Where everything lives, derived from the column list alone; the writer
+// and the reader both use it
+struct Layout {
+    std::uint64_t firstBlockOffset = 0;
+    std::uint64_t blockBytes = 0;
+    std::vector<std::uint64_t> columnOffsets;  // within a block
+};
+
+Layout layoutFor(const TelemetryColumn* columns, std::uint32_t columnCount, std::uint32_t blockRows) {
+    Layout layout;
+    layout.firstBlockOffset = roundUp(sizeof(FileHeader) + columnCount * sizeof(TelemetryColumn), PageSize);
+    // Columns start 64-byte aligned, widest (8-byte) values first
+    std::uint64_t offset = roundUp(sizeof(BlockHeader) + columnCount * sizeof(TelemetryRange), 64);
+    for (std::uint32_t c = 0; c < columnCount; ++c) {
+        layout.columnOffsets.push_back(offset);
+        offset = roundUp(offset + std::uint64_t(columns[c].width) * blockRows, 64);
+    }
+    layout.blockBytes = roundUp(offset, PageSize);
+    return layout;
+}
+
+const Layout& recorderLayout() {
+    static const Layout layout = layoutFor(TelemetryColumns, TelemetryFieldCount, TelemetryRecorder::BlockRows);
+    return layout;
+}
+
+}  // namespace
+
+bool TelemetryRecorder::open(const std::string& path, std::string& error) {
+    close();
+    const Layout& layout = recorderLayout();
+    if (!m_file.create(path, layout.firstBlockOffset + InitialBlocks * layout.blockBytes, error)) return false;
+
+    FileHeader header;
+    std::memcpy(header.magic, Magic, sizeof(Magic));
+    header.version = FormatVersion;
+    header.columnCount = TelemetryFieldCount;
+    header.blockRows = BlockRows;
+    header.blockCount = 0;
+    header.rowCount = 0;
+    header.blockBytes = layout.blockBytes;
+    header.firstBlockOffset = layout.firstBlockOffset;
+    std::memcpy(m_file.data(), &header, sizeof(header));
+    std::memcpy(m_file.data() + sizeof(header), TelemetryColumns, sizeof(TelemetryColumns));
+
+    if (!m_ring) m_ring.reset(new TelemetrySample[RingSize]);
+    m_nextTick = 0;
+    m_head.store(0, std::memory_order_relaxed);
+    m_tail.store(0, std::memory_order_relaxed);
+    m_dropped.store(0, std::memory_order_relaxed);
+    m_blocks = 0;
+    m_rows = 0;
+    m_blockRows = 0;
+    m_writeError.clear();
+
+    m_running.store(true);
+    m_thread = std::thread(&TelemetryRecorder::run, this);
+    return true;
+}
+
+void TelemetryRecorder::record(const MatchState& state, float dt, unsigned events) {
+    std::uint64_t tick = m_nextTick++;
+    std::uint64_t head = m_head.load(std::memory_order_relaxed);
+    if (head - m_tail.load(std::memory_order_acquire) == RingSize) {
+        m_dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    TelemetrySample& s = m_ring[head & (RingSize - 1)];
+    s.tick = tick;
+    s.dt = dt;
+    s.ballX = state.ballX;
+    s.ballY = state.ballY;
+    s.ballVelX = state.ballVelX;
+    s.ballVelY = state.ballVelY;
+    s.paddleLeftY = state.paddleLeftY;
+    s.paddleRightY = state.paddleRightY;
+    s.events = events;
+    s.scoreLeft = state.scoreLeft;
+    s.scoreRight = state.scoreRight;
+    m_head.store(head + 1, std::memory_order_release);
+}
+
+void TelemetryRecorder::close() {
+    if (!m_running.exchange(false)) return;
+    if (m_thread.joinable()) m_thread.join();
+
+    // The last block keeps its full size so every block has the same layout
+    const Layout& layout = recorderLayout();
+    std::string error;
+    if (!m_file.resize(layout.firstBlockOffset + m_blocks * layout.blockBytes, error) && m_writeError.empty())
+        m_writeError = error;
+    m_file.close();
+}
+
+// Drains the ring every couple of milliseconds, or continuously while the
+// producer keeps it busy (headless runs record far faster than real time).
+// Slots are handed back in chunks so a fast producer sees space early. The
+// stop flag is read before draining, so everything recorded before close()
+// is written.
+void TelemetryRecorder::run() {
+    const std::uint64_t Chunk = 1024;
+    bool busy = false;
+    for (;;) {
+        bool stopping = !m_running.load(std::memory_order_acquire);
+        std::uint64_t tail = m_tail.load(std::memory_order_relaxed);
+        std::uint64_t head = m_head.load(std::memory_order_acquire);
+        for (std::uint64_t t = tail; t != head;) {
+            std::uint64_t end = std::min(head, t + Chunk);
+            for (; t != end; ++t)
+                if (m_writeError.empty()) append(m_ring[t & (RingSize - 1)]);
+            m_tail.store(t, std::memory_order_release);
+        }
+        if (head != tail) publishCounts();
+        if (stopping) return;
+        if (head == tail) {
+            if (busy)
+                std::this_thread::yield();
+            else
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+        }
+        if (head != tail) busy = head - tail >= Chunk;
+    }
+}
+
+bool TelemetryRecorder::startBlock() {
+    const Layout& layout = recorderLayout();
+    if (m_blocks > 0) publishCounts();
+
+    std::uint64_t needed = layout.firstBlockOffset + (m_blocks + 1) * layout.blockBytes;
+    if (needed > m_file.size()) {
+        std::uint64_t grown = layout.firstBlockOffset + 2 * (m_file.size() - layout.firstBlockOffset);
+        if (!m_file.resize(static_cast<std::size_t>(std::max(needed, grown)), m_writeError)) return false;
+    }
+
+    BlockHeader header = {m_rows, 0, 0};
+    std::memcpy(m_file.data() + layout.firstBlockOffset + m_blocks * layout.blockBytes, &header, sizeof(header));
+    m_blocks++;
+    m_blockRows = 0;
+    for (TelemetryRange& range : m_ranges) {
+        range.min = std::numeric_limits<double>::infinity();
+        range.max = -std::numeric_limits<double>::infinity();
+    }
+    return true;
+}
+
+bool TelemetryRecorder::append(const TelemetrySample& s) {
+    if ((m_blocks == 0 || m_blockRows == BlockRows) && !startBlock()) return false;
+
+    const Layout& layout = recorderLayout();
+    unsigned char* block = m_file.data() + layout.firstBlockOffset + (m_blocks - 1) * layout.blockBytes;
+    const std::uint32_t row = m_blockRows;
+    auto put = [&](int field, auto value) {
+        std::memcpy(block + layout.columnOffsets[field] + row * sizeof(value), &value, sizeof(value));
+        TelemetryRange& range = m_ranges[field];
+        double v = static_cast<double>(value);
+        range.min = std::min(range.min, v);
+        range.max = std::max(range.max, v);
+    };
+    put(TelemetryTick, s.tick);
+    put(TelemetryDt, s.dt);
+    put(TelemetryBallX, s.ballX);
+    put(TelemetryBallY, s.ballY);
+    put(TelemetryBallVelX, s.ballVelX);
+    put(TelemetryBallVelY, s.ballVelY);
+    put(TelemetryPaddleLeftY, s.paddleLeftY);
+    put(TelemetryPaddleRightY, s.paddleRightY);
+    put(TelemetryEvents, s.events);
+    put(TelemetryScoreLeft, s.scoreLeft);
+    put(TelemetryScoreRight, s.scoreRight);
+    m_blockRows++;
+    m_rows++;
+    return true;
+}
+
+// Makes the rows written so far visible to readers of the file: the
+// current block's row count and ranges, then the totals in the header
+void TelemetryRecorder::publishCounts() {
+    if (m_blocks == 0) return;
+    const Layout& layout = recorderLayout();
+    unsigned char* block = m_file.data() + layout.firstBlockOffset + (m_blocks - 1) * layout.blockBytes;
+    std::memcpy(block + offsetof(BlockHeader, rows), &m_blockRows, sizeof(m_blockRows));
+    std::memcpy(block + sizeof(BlockHeader), m_ranges, sizeof(m_ranges));
+    std::memcpy(m_file.data() + offsetof(FileHeader, blockCount), &m_blocks, sizeof(m_blocks));
+    std::memcpy(m_file.data() + offsetof(FileHeader, rowCount), &m_rows, sizeof(m_rows));
+}
+
+bool TelemetryReader::open(const std::string& path, std::string& error) {
+    if (!m_file.openReadOnly(path, error)) return false;
+    const unsigned char* data = m_file.data();
+
+    FileHeader header;
+    if (m_file.size() < sizeof(header)) {
+        error = path + ": not a telemetry file";
+        return false;
+    }
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, Magic, sizeof(Magic)) != 0) {
+        error = path + ": not a telemetry file";
+        return false;
+    }
+    if (header.version != FormatVersion) {
+        error = path + ": unsupported telemetry version " + std::to_string(header.version);
+        return false;
+    }
+    if (header.columnCount == 0 || header.columnCount > 256 || header.blockRows == 0 ||
+        sizeof(header) + header.columnCount * sizeof(TelemetryColumn) > m_file.size()) {
+        error = path + ": corrupt header";
+        return false;
+    }
+    m_columns = reinterpret_cast<const TelemetryColumn*>(data + sizeof(header));
+    for (std::uint32_t c = 0; c < header.columnCount; ++c) {
+        std::uint32_t width = m_columns[c].width;
+        bool known = m_columns[c].type <= TelemetryType::U64;
+        if (!known || (width != 4 && width != 8)) {
+            error = path + ": corrupt column table";
+            return false;
+        }
+    }
+
+    // The layout is recomputed, not trusted, and must match what was written
+    Layout layout = layoutFor(m_columns, header.columnCount, header.blockRows);
+    if (layout.blockBytes != header.blockBytes || layout.firstBlockOffset != header.firstBlockOffset) {
+        error = path + ": block layout does not match its columns";
+        return false;
+    }
+    if (header.firstBlockOffset + header.blockCount * header.blockBytes > m_file.size()) {
+        error = path + ": truncated (" + std::to_string(header.blockCount) + " blocks in the header)";
+        return false;
+    }
+
+    m_columnCount = header.columnCount;
+    m_blockRows = header.blockRows;
+    m_blockCount = header.blockCount;
+    m_rowCount = header.rowCount;
+    m_blockBytes = header.blockBytes;
+    m_firstBlock = header.firstBlockOffset;
+    m_columnOffsets = std::move(layout.columnOffsets);
+    return true;
+}
+
+int TelemetryReader::findColumn(const std::string& name) const {
+    for (std::uint32_t c = 0; c < m_columnCount; ++c)
+        if (name == std::string(m_columns[c].name, strnlen(m_columns[c].name, sizeof(m_columns[c].name))))
+            return static_cast<int>(c);
+    return -1;
+}
+
+TelemetryReader::Block TelemetryReader::block(std::uint64_t index) const {
+    const unsigned char* data = m_file.data() + m_firstBlock + index * m_blockBytes;
+    BlockHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    Block block;
+    block.firstRow = header.firstRow;
+    block.rows = std::min(header.rows, m_blockRows);
+    block.ranges = reinterpret_cast<const TelemetryRange*>(data + sizeof(BlockHeader));
+    return block;
+}
+
+const void* TelemetryReader::columnData(std::uint64_t index, std::uint32_t column) const {
+    return m_file.data() + m_firstBlock + index * m_blockBytes + m_columnOffsets[column];
+}
+
+double TelemetryReader::value(std::uint64_t index, std::uint32_t column, std::uint32_t row) const {
+    const unsigned char* p = static_cast<const unsigned char*>(columnData(index, column)) + row * m_columns[column].width;
+    switch (m_columns[column].type) {
+    case TelemetryType::F32: { float v; std::memcpy(&v, p, 4); return v; }
+    case TelemetryType::I32: { std::int32_t v; std::memcpy(&v, p, 4); return v; }
+    case TelemetryType::U32: { std::uint32_t v; std::memcpy(&v, p, 4); return v; }
+    case TelemetryType::U64: { std::uint64_t v; std::memcpy(&v, p, 8); return static_cast<double>(v); }
+    }
+    return 0.0;
+}
+
+}  // namespace sim
@@ -0,0 +1,166 @@
+#pragma once
+
+// Per-tick match telemetry in a memory-mapped columnar file.
+//
+//   header   "CPTL", u32 version, u32 column count, u32 rows per block,
+//            u64 blocks, u64 rows, u64 block bytes, u64 first block offset,
+//            then per column: char name[16], u32 type, u32 width
+//   blocks   fixed size, back to back: u64 first row, u32 rows, u32 reserved,
+//            f64 min/max per column, then each column's values for all
+//            rows of the block (a full block's worth of space, even in the
+//            last one)
+//
+// Values are stored in host byte order (little-endian on every supported
+// platform), so a reader maps the file and reads columns in place. The
+// block min/max let a scan skip blocks that cannot match a filter.
+//
+// The game thread only copies a sample into a lock-free single-producer /
+// single-consumer ring; a background thread transposes samples into the
+// mapped blocks, so recording never waits on the disk.
+
+#include "MappedFile.h"
+#include "Simulation.h"
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace sim {
+
+enum class TelemetryType : std::uint32_t { F32, I32, U32, U64 };
+
+struct TelemetryColumn {
+    char name[16];
+    TelemetryType type;
+    std::uint32_t width;  // bytes per value
+};
+
+// Column order in the file and in TelemetrySample
+enum TelemetryField {
+    TelemetryTick,  // recorder's tick count; gaps are samples dropped on a full ring
+    TelemetryDt,
+    TelemetryBallX,
+    TelemetryBallY,
+    TelemetryBallVelX,
+    TelemetryBallVelY,
+    TelemetryPaddleLeftY,
+    TelemetryPaddleRightY,
+    TelemetryEvents,  // StepEvent bits: paddle hits and goals during the tick
+    TelemetryScoreLeft,
+    TelemetryScoreRight,
+    TelemetryFieldCount
+};
+
+extern const TelemetryColumn TelemetryColumns[TelemetryFieldCount];
+
+struct TelemetrySample {
+    std::uint64_t tick;
+    float dt;
+    float ballX, ballY, ballVelX, ballVelY;
+    float paddleLeftY, paddleRightY;
+    std::uint32_t events;
+    std::int32_t scoreLeft, scoreRight;
+};
+
+struct TelemetryRange {
+    double min, max;
+};
+
+class TelemetryRecorder {
+public:
+    static const std::uint32_t BlockRows = 4096;
+    static const std::size_t RingSize = 16384;  // power of two; ~27 s at 600 Hz
+
+    TelemetryRecorder() = default;
+    ~TelemetryRecorder() { close(); }
+
+    TelemetryRecorder(const TelemetryRecorder&) = delete;
+    TelemetryRecorder& operator=(const TelemetryRecorder&) = delete;
+
+    // Creates `path` and starts the writer thread
+    bool open(const std::string& path, std::string& error);
+    bool isOpen() const { return m_running.load(std::memory_order_relaxed); }
+
+    // From one thread only: the state after a step() and the events it
+    // returned. Never blocks; with the ring full the sample is dropped.
+    void record(const MatchState& state, float dt, unsigned events);
+    // True while record() would drop. Offline recorders (cpong_headless) can
+    // yield until it clears; the game never waits.
+    bool full() const {
+        return m_head.load(std::memory_order_relaxed) - m_tail.load(std::memory_order_acquire) == RingSize;
+    }
+
+    // Writes out everything recorded and trims the file to its contents
+    void close();
+
+    std::uint64_t recorded() const { return m_nextTick; }
+    std::uint64_t dropped() const { return m_dropped.load(std::memory_order_relaxed); }
+    // After close(): set if the writer failed (e.g. disk full), after which
+    // later samples were discarded
+    const std::string& writeError() const { return m_writeError; }
+
+private:
+    void run();
+    // Writer thread: appends one sample to the current block
+    bool append(const TelemetrySample& sample);
+    bool startBlock();
+    void publishCounts();
+
+    // Producer side
+    std::uint64_t m_nextTick = 0;
+    std::unique_ptr<TelemetrySample[]> m_ring;  // allocated by open()
+    alignas(64) std::atomic<std::uint64_t> m_head{0};  // producer
+    alignas(64) std::atomic<std::uint64_t> m_tail{0};  // consumer
+    alignas(64) std::atomic<std::uint64_t> m_dropped{0};
+
+    // Writer side
+    std::thread m_thread;
+    std::atomic<bool> m_running{false};
+    MappedFile m_file;
+    std::uint64_t m_blocks = 0;   // started, including the one being filled
+    std::uint64_t m_rows = 0;
+    std::uint32_t m_blockRows = 0;  // rows in the current block
+    TelemetryRange m_ranges[TelemetryFieldCount];
+    std::string m_writeError;
+};
+
+// Read-only view of a telemetry file, mapped in place
+class TelemetryReader {
+public:
+    struct Block {
+        std::uint64_t firstRow;
+        std::uint32_t rows;
+        const TelemetryRange* ranges;  // per column
+    };
+
+    bool open(const std::string& path, std::string& error);
+
+    std::uint32_t columnCount() const { return m_columnCount; }
+    const TelemetryColumn& column(std::uint32_t index) const { return m_columns[index]; }
+    // -1 if there is no such column
+    int findColumn(const std::string& name) const;
+
+    std::uint64_t blockCount() const { return m_blockCount; }
+    std::uint64_t rowCount() const { return m_rowCount; }
+    Block block(std::uint64_t index) const;
+    // The column's values in a block: block(index).rows of column(c).width bytes
+    const void* columnData(std::uint64_t index, std::uint32_t column) const;
+    // One value widened to double, for printing
+    double value(std::uint64_t index, std::uint32_t column, std::uint32_t row) const;
+
+private:
+    MappedFile m_file;
+    const TelemetryColumn* m_columns = nullptr;
+    std::uint32_t m_columnCount = 0;
+    std::uint32_t m_blockRows = 0;
+    std::uint64_t m_blockCount = 0;
+    std::uint64_t m_rowCount = 0;
+    std::uint64_t m_blockBytes = 0;
+    std::uint64_t m_firstBlock = 0;
+    std::vector<std::uint64_t> m_columnOffsets;  // within a block
+};
+
+}  // namespace sim
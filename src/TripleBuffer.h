@@ -0,0 +1,40 @@
+#pragma once
+
+#include <atomic>
+
+// Single-producer / single-consumer handoff of the latest value. The writer
+// fills back() and publish()es it; the reader calls update() and reads
+// front(). Neither side ever waits: the three slots rotate through one
+// atomic index, so a slow reader just skips values.
+template <typename T>
+class TripleBuffer {
+public:
+    // Writer side
+    T& back() { return m_slots[m_back].value; }
+    void publish() {
+        unsigned previous = m_middle.exchange(m_back | FreshBit, std::memory_order_acq_rel);
+        m_back = previous & IndexMask;
+    }
+
+    // Reader side. Returns true if a newer value became front().
+    bool update() {
+        if (!(m_middle.load(std::memory_order_relaxed) & FreshBit)) return false;
+        unsigned previous = m_middle.exchange(m_front, std::memory_order_acq_rel);
+        m_front = previous & IndexMask;
+        return true;
+    }
+    const T& front() const { return m_slots[m_front].value; }
+
+private:
+    static const unsigned IndexMask = 3u;
+    static const unsigned FreshBit = 4u;
+
+    struct alignas(64) Slot {
+        T value{};
+    };
+
+    Slot m_slots[3];
+    unsigned m_back = 0;                        // writer only
+    alignas(64) std::atomic<unsigned> m_middle{1};
+    alignas(64) unsigned m_front = 2;           // reader only
+};
@@ -0,0 +1,155 @@
+#include "UdpSocket.h"
+#include <cstring>
+
+#ifdef _WIN32
+#include <winsock2.h>
+#include <ws2tcpip.h>
+using socklen_t = int;
+#else
+#include <arpa/inet.h>
+#include <cerrno>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+#ifdef _WIN32
+const std::uintptr_t InvalidSocket = ~std::uintptr_t(0);
+
+// WSAStartup once per process; WSACleanup is left to process exit
+bool startNetworking() {
+    static bool started = [] {
+        WSADATA data;
+        return WSAStartup(MAKEWORD(2, 2), &data) == 0;
+    }();
+    return started;
+}
+#else
+const int InvalidSocket = -1;
+#endif
+
+sockaddr_in toSockaddr(const UdpSocket::Address& address) {
+    sockaddr_in sa;
+    std::memset(&sa, 0, sizeof(sa));
+    sa.sin_family = AF_INET;
+    sa.sin_addr.s_addr = htonl(address.ip);
+    sa.sin_port = htons(address.port);
+    return sa;
+}
+
+}  // namespace
+
+UdpSocket::~UdpSocket() {
+    close();
+}
+
+bool UdpSocket::open(std::uint16_t port, std::string& error) {
+    close();
+#ifdef _WIN32
+    if (!startNetworking()) {
+        error = "WSAStartup failed";
+        return false;
+    }
+#endif
+    auto s = socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP);
+    if (s == InvalidSocket) {
+        error = "cannot create UDP socket";
+        return false;
+    }
+    m_socket = s;
+
+    UdpSocket::Address any;
+    any.port = port;
+    sockaddr_in sa = toSockaddr(any);
+    if (bind(m_socket, reinterpret_cast<const sockaddr*>(&sa), sizeof(sa)) != 0) {
+        error = "cannot bind UDP port " + std::to_string(port);
+        close();
+        return false;
+    }
+
+#ifdef _WIN32
+    u_long nonBlocking = 1;
+    bool ok = ioctlsocket(m_socket, FIONBIO, &nonBlocking) == 0;
+#else
+    bool ok = fcntl(m_socket, F_SETFL, fcntl(m_socket, F_GETFL, 0) | O_NONBLOCK) == 0;
+#endif
+    if (!ok) {
+        error = "cannot make UDP socket non-blocking";
+        close();
+        return false;
+    }
+    return true;
+}
+
+void UdpSocket::close() {
+    if (m_socket == InvalidSocket) return;
+#ifdef _WIN32
+    closesocket(m_socket);
+#else
+    ::close(m_socket);
+#endif
+    m_socket = InvalidSocket;
+}
+
+bool UdpSocket::isOpen() const {
+    return m_socket != InvalidSocket;
+}
+
+std::uint16_t UdpSocket::localPort() const {
+    sockaddr_in sa;
+    socklen_t length = sizeof(sa);
+    if (getsockname(m_socket, reinterpret_cast<sockaddr*>(&sa), &length) != 0) return 0;
+    return ntohs(sa.sin_port);
+}
+
+bool UdpSocket::send(const Address& to, const void* data, std::size_t size) {
+    sockaddr_in sa = toSockaddr(to);
+    auto sent = sendto(m_socket, static_cast<const char*>(data), static_cast<int>(size), 0,
+                       reinterpret_cast<const sockaddr*>(&sa), sizeof(sa));
+    return sent == static_cast<decltype(sent)>(size);
+}
+
+int UdpSocket::receive(void* buffer, std::size_t size, Address& from) {
+    sockaddr_in sa;
+    socklen_t length = sizeof(sa);
+    auto received = recvfrom(m_socket, static_cast<char*>(buffer), static_cast<int>(size), 0,
+                             reinterpret_cast<sockaddr*>(&sa), &length);
+    if (received < 0) {
+#ifdef _WIN32
+        int e = WSAGetLastError();
+        // A previous send to a closed port surfaces here on Windows; not fatal
+        return e == WSAEWOULDBLOCK || e == WSAECONNRESET ? 0 : -1;
+#else
+        return errno == EAGAIN || errno == EWOULDBLOCK || errno == ECONNREFUSED ? 0 : -1;
+#endif
+    }
+    from.ip = ntohl(sa.sin_addr.s_addr);
+    from.port = ntohs(sa.sin_port);
+    return static_cast<int>(received);
+}
+
+bool UdpSocket::resolve(const std::string& host, std::uint16_t port, Address& out, std::string& error) {
+#ifdef _WIN32
+    if (!startNetworking()) {
+        error = "WSAStartup failed";
+        return false;
+    }
+#endif
+    addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_DGRAM;
+    addrinfo* result = nullptr;
+    if (getaddrinfo(host.c_str(), nullptr, &hints, &result) != 0 || !result) {
+        error = "cannot resolve " + host;
+        return false;
+    }
+    out.ip = ntohl(reinterpret_cast<const sockaddr_in*>(result->ai_addr)->sin_addr.s_addr);
+    out.port = port;
+    freeaddrinfo(result);
+    return true;
+}
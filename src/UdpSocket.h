@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// Minimal non-blocking IPv4 UDP socket (BSD sockets / Winsock).
+class UdpSocket {
+public:
+    struct Address {
+        std::uint32_t ip = 0;    // host byte order
+        std::uint16_t port = 0;  // host byte order
+        bool operator==(const Address& o) const { return ip == o.ip && port == o.port; }
+        bool operator!=(const Address& o) const { return !(*this == o); }
+    };
+
+    UdpSocket() = default;
+    ~UdpSocket();
+
+    UdpSocket(const UdpSocket&) = delete;
+    UdpSocket& operator=(const UdpSocket&) = delete;
+
+    // Binds to `port` on all interfaces; 0 picks a free port
+    bool open(std::uint16_t port, std::string& error);
+    void close();
+    bool isOpen() const;
+    std::uint16_t localPort() const;
+
+    bool send(const Address& to, const void* data, std::size_t size);
+    // Bytes received, 0 when nothing is waiting, -1 on error
+    int receive(void* buffer, std::size_t size, Address& from);
+
+    // "host" or dotted quad; IPv4 only
+    static bool resolve(const std::string& host, std::uint16_t port, Address& out, std::string& error);
+
+private:
+#ifdef _WIN32
+    std::uintptr_t m_socket = ~std::uintptr_t(0);
+#else
+    int m_socket = -1;
+#endif
+};
@@ -0,0 +1,128 @@
+#include "WorkStealingPool.h"
+#include <algorithm>
+
+WorkStealingPool::WorkStealingPool(unsigned threads) {
+    if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+    for (unsigned i = 0; i < threads; ++i) {
+        m_workers.push_back(std::make_unique<Worker>());
+        m_workers.back()->victimSeed = 0x9E3779B9u * (i + 1);
+    }
+    for (unsigned i = 1; i < threads; ++i)
+        m_threads.emplace_back(&WorkStealingPool::threadMain, this, i);
+}
+
+WorkStealingPool::~WorkStealingPool() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_stop = true;
+    }
+    m_wake.notify_all();
+    for (std::thread& t : m_threads) t.join();
+}
+
+void WorkStealingPool::parallelFor(std::size_t count, std::size_t grain, const RangeFn& body) {
+    if (count == 0) return;
+    m_body = &body;
+    m_grain = std::max<std::size_t>(1, grain);
+    m_pending.store(count, std::memory_order_relaxed);
+
+    // Seed each worker with one contiguous slice; splitting happens lazily
+    const std::size_t n = m_workers.size();
+    for (std::size_t w = 0; w < n; ++w) {
+        std::size_t begin = count * w / n;
+        std::size_t end = count * (w + 1) / n;
+        if (begin == end) continue;
+        std::lock_guard<std::mutex> lock(m_workers[w]->mutex);
+        m_workers[w]->ranges.push_back({begin, end});
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_busy = static_cast<unsigned>(m_threads.size());
+        ++m_generation;
+    }
+    m_wake.notify_all();
+
+    runUntilDone(0);
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_idle.wait(lock, [this] { return m_busy == 0; });
+    m_body = nullptr;
+}
+
+void WorkStealingPool::threadMain(unsigned index) {
+    std::uint64_t seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_wake.wait(lock, [&] { return m_stop || m_generation != seen; });
+            if (m_stop) return;
+            seen = m_generation;
+        }
+
+        runUntilDone(index);
+
+        std::lock_guard<std::mutex> lock(m_mutex);
+        if (--m_busy == 0) m_idle.notify_all();
+    }
+}
+
+void WorkStealingPool::runUntilDone(unsigned index) {
+    Range range;
+    while (m_pending.load(std::memory_order_acquire) > 0) {
+        if (!popOwn(index, range) && !steal(index, range)) {
+            std::this_thread::yield();
+            continue;
+        }
+        (*m_body)(range.begin, range.end, index);
+        m_pending.fetch_sub(range.end - range.begin, std::memory_order_acq_rel);
+    }
+}
+
+bool WorkStealingPool::popOwn(unsigned index, Range& out) {
+    Worker& self = *m_workers[index];
+    std::lock_guard<std::mutex> lock(self.mutex);
+    if (self.ranges.empty()) return false;
+    out = self.ranges.back();
+    self.ranges.pop_back();
+    // Leave the upper halves behind for thieves; keep a grain-sized piece
+    while (out.end - out.begin > m_grain) {
+        std::size_t mid = out.begin + (out.end - out.begin) / 2;
+        self.ranges.push_back({mid, out.end});
+        out.end = mid;
+    }
+    return true;
+}
+
+bool WorkStealingPool::steal(unsigned index, Range& out) {
+    const unsigned n = threadCount();
+    if (n < 2) return false;
+    Worker& self = *m_workers[index];
+    self.victimSeed ^= self.victimSeed << 13;
+    self.victimSeed ^= self.victimSeed >> 17;
+    self.victimSeed ^= self.victimSeed << 5;
+    const unsigned start = self.victimSeed % n;
+
+    for (unsigned k = 0; k < n; ++k) {
+        unsigned victim = (start + k) % n;
+        if (victim == index) continue;
+        {
+            Worker& other = *m_workers[victim];
+            std::lock_guard<std::mutex> lock(other.mutex);
+            if (other.ranges.empty()) continue;
+            out = other.ranges.front();
+            other.ranges.pop_front();
+        }
+        m_steals.fetch_add(1, std::memory_order_relaxed);
+        // Too big to run in one go: keep the front half, queue the rest locally.
+        // Never hold two worker locks at once.
+        if (out.end - out.begin > m_grain) {
+            std::size_t mid = out.begin + (out.end - out.begin) / 2;
+            std::lock_guard<std::mutex> lock(self.mutex);
+            self.ranges.push_back({mid, out.end});
+            out.end = mid;
+        }
+        return true;
+    }
+    return false;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// Fixed set of worker threads running index ranges. Every worker owns a deque
+// of ranges: it splits and pops from the back of its own, and when that runs
+// dry it steals from the front (the largest ranges) of another worker's.
+class WorkStealingPool {
+public:
+    // body(begin, end, worker): process indices [begin, end) on `worker`
+    using RangeFn = std::function<void(std::size_t, std::size_t, unsigned)>;
+
+    explicit WorkStealingPool(unsigned threads = 0);  // 0 = hardware concurrency
+    ~WorkStealingPool();
+
+    WorkStealingPool(const WorkStealingPool&) = delete;
+    WorkStealingPool& operator=(const WorkStealingPool&) = delete;
+
+    unsigned threadCount() const { return static_cast<unsigned>(m_workers.size()); }
+
+    // Runs body over [0, count) in chunks of at most `grain` indices and blocks
+    // until all are done. The calling thread takes part as worker 0.
+    void parallelFor(std::size_t count, std::size_t grain, const RangeFn& body);
+
+    std::uint64_t steals() const { return m_steals.load(std::memory_order_relaxed); }
+
+private:
+    struct Range {
+        std::size_t begin, end;
+    };
+    struct alignas(64) Worker {
+        std::mutex mutex;
+        std::deque<Range> ranges;
+        std::uint32_t victimSeed = 0;
+    };
+
+    void threadMain(unsigned index);
+    void runUntilDone(unsigned index);
+    bool popOwn(unsigned index, Range& out);
+    bool steal(unsigned index, Range& out);
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_idle;
+    std::uint64_t m_generation = 0;
+    unsigned m_busy = 0;
+    bool m_stop = false;
+
+    const RangeFn* m_body = nullptr;
+    std::size_t m_grain = 1;
+    std::atomic<std::size_t> m_pending{0};
+    std::atomic<std::uint64_t> m_steals{0};
+};
@@ -0,0 +1,177 @@
+// cpong_batch_bench - compares the SoA/SIMD MatchBatch stepper with stepping
+// one sim::MatchState at a time, and checks both produce identical states.
+// Also times each AI policy evaluated per match vs once per batch.
+
+#include "AIPolicy.h"
+#include "MatchBatch.h"
+#include "Simulation.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+static std::vector<sim::MatchState> makeMatches(int count, unsigned seed, const sim::MatchConfig& config) {
+    std::vector<sim::MatchState> states(count);
+    for (int i = 0; i < count; ++i) sim::resetMatch(states[i], seed + static_cast<std::uint64_t>(i), config);
+    return states;
+}
+
+static bool sameBits(const sim::MatchState& a, const sim::MatchState& b) {
+    return std::memcmp(&a, &b, sizeof(sim::MatchState)) == 0;
+}
+
+// Steps the reference (per-object) and batched paths from the same seeded
+// start; returns the number of matches whose final state differs.
+// `batchConfig` lets the batch run another, equivalent setup (e.g. the
+// tracker as an AIPolicy) against the built-in reference.
+static int crossCheck(int matches, int ticks, float dt, const sim::MatchInputs& inputs, unsigned seed,
+                      const sim::MatchConfig& batchConfig) {
+    sim::MatchConfig config;
+    config.integrator = sim::Integrator::Substep;
+    std::vector<sim::MatchState> reference = makeMatches(matches, seed, config);
+    sim::MatchBatch batch(matches);
+    for (int i = 0; i < matches; ++i) batch.set(i, reference[i]);
+
+    for (int t = 0; t < ticks; ++t)
+        for (sim::MatchState& s : reference) sim::step(s, config, inputs, dt);
+
+    for (int t = 0; t < ticks; ++t)
+        batch.step(batchConfig, inputs, dt);
+
+    int mismatches = 0;
+    for (int i = 0; i < matches; ++i) {
+        sim::MatchState b = batch.get(i);
+        if (!sameBits(reference[i], b)) {
+            if (mismatches == 0) {
+                std::cerr << "match " << i << " differs: ref ball (" << reference[i].ballX << ", " << reference[i].ballY
+                          << ") batch ball (" << b.ballX << ", " << b.ballY << ")\n";
+            }
+            mismatches++;
+        }
+    }
+    return mismatches;
+}
+
+// Seconds per observation for one policy: one evaluate() per match, as
+// sim::step does, against one evaluate() over the whole batch
+static void benchPolicy(const sim::AIPolicy& policy, const sim::MatchBatch& batch, int rounds) {
+    sim::MatchConfig config;
+    sim::AIObservations obs;
+    obs.count = batch.size();
+    obs.ballX = batch.ballX.data();
+    obs.ballY = batch.ballY.data();
+    obs.ballVelX = batch.ballVelX.data();
+    obs.ballVelY = batch.ballVelY.data();
+    obs.paddleY = batch.paddleRightY.data();
+    obs.aimOffset = batch.aiRightOffset.data();
+    std::vector<float> targets(batch.size());
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) {
+        for (std::size_t i = 0; i < batch.size(); ++i) {
+            sim::AIObservations one = obs;
+            one.count = 1;
+            one.ballX += i; one.ballY += i; one.ballVelX += i; one.ballVelY += i;
+            one.paddleY += i; one.aimOffset += i;
+            policy.evaluate(one, config, &targets[i]);
+        }
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    for (int r = 0; r < rounds; ++r) policy.evaluate(obs, config, targets.data());
+    auto t2 = std::chrono::steady_clock::now();
+
+    double evaluations = static_cast<double>(batch.size()) * rounds;
+    double single = std::chrono::duration<double>(t1 - t0).count() / evaluations * 1e9;
+    double batched = std::chrono::duration<double>(t2 - t1).count() / evaluations * 1e9;
+    std::printf("%-10s %10.1f ns %10.1f ns %8.1fx\n", policy.name(), single, batched, single / batched);
+}
+
+int main(int argc, char** argv) {
+    int matches = 4096;
+    int ticks = 600;
+    float dt = 1.0f / 60.0f;
+    const char* mlpPath = nullptr;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--matches") == 0 && i + 1 < argc) {
+            matches = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) {
+            ticks = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--dt") == 0 && i + 1 < argc) {
+            dt = static_cast<float>(std::atof(argv[++i]));
+        } else if (std::strcmp(argv[i], "--mlp") == 0 && i + 1 < argc) {
+            mlpPath = argv[++i];
+        } else {
+            std::cout << "Usage: cpong_batch_bench [--matches N] [--ticks N] [--dt SECONDS] [--mlp FILE]\n";
+            return std::strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+    }
+    if (matches <= 0 || ticks <= 0 || dt <= 0.0f) return 1;
+
+    sim::MatchInputs aiVsAi;
+    aiVsAi.leftAI = true;
+    aiVsAi.rightAI = true;
+    sim::MatchInputs playerVsAi;
+    playerVsAi.leftAxis = 0.5f;
+
+    sim::MatchConfig builtIn;
+    builtIn.integrator = sim::Integrator::Substep;
+    sim::TrackerPolicy tracker;
+    sim::MatchConfig trackerPolicy = builtIn;
+    trackerPolicy.aiLeft.policy = &tracker;
+    trackerPolicy.aiRight.policy = &tracker;
+
+    int bad = crossCheck(matches, ticks, dt, aiVsAi, 1234u, builtIn) +
+              crossCheck(matches + 3, ticks, dt, playerVsAi, 99u, builtIn);
+    int badPolicy = crossCheck(matches, ticks, dt, aiVsAi, 1234u, trackerPolicy);
+    std::cout << "kernel:       " << sim::batchKernelName() << "\n"
+              << "cross-check:  " << (bad == 0 ? "identical" : "MISMATCH") << "\n"
+              << "tracker AI:   " << (badPolicy == 0 ? "identical" : "MISMATCH") << " (as batched AIPolicy)\n";
+    bad += badPolicy;
+
+    sim::MatchConfig config;
+    config.integrator = sim::Integrator::Substep;
+    std::vector<sim::MatchState> reference = makeMatches(matches, 42u, config);
+    sim::MatchBatch batch(matches);
+    for (int i = 0; i < matches; ++i) batch.set(i, reference[i]);
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (int t = 0; t < ticks; ++t)
+        for (sim::MatchState& s : reference) sim::step(s, config, aiVsAi, dt);
+    auto t1 = std::chrono::steady_clock::now();
+    for (int t = 0; t < ticks; ++t)
+        batch.step(config, aiVsAi, dt);
+    auto t2 = std::chrono::steady_clock::now();
+
+    double scalarSec = std::chrono::duration<double>(t1 - t0).count();
+    double batchSec = std::chrono::duration<double>(t2 - t1).count();
+    double stepped = static_cast<double>(matches) * ticks;
+    std::cout << "matches:      " << matches << " x " << ticks << " ticks\n"
+              << "per-object:   " << stepped / scalarSec << " match-steps/s\n"
+              << "batched:      " << stepped / batchSec << " match-steps/s\n"
+              << "speedup:      " << scalarSec / batchSec << "x\n";
+
+    // Policy cost per observation, on the states the batch run ended in
+    std::vector<std::unique_ptr<sim::AIPolicy>> policies;
+    policies.emplace_back(new sim::TrackerPolicy());
+    policies.emplace_back(new sim::InterceptPolicy());
+    if (mlpPath) {
+        std::string error;
+        std::unique_ptr<sim::AIPolicy> mlp = sim::makeAIPolicy(std::string("mlp:") + mlpPath, error);
+        if (!mlp) {
+            std::cerr << error << "\n";
+            return 1;
+        }
+        policies.push_back(std::move(mlp));
+    }
+    std::printf("\npolicy       per-match    batched  speedup\n");
+    int rounds = std::max(1, 2000000 / matches);
+    for (const auto& policy : policies) benchPolicy(*policy, batch, rounds);
+    return bad == 0 ? 0 : 1;
+}
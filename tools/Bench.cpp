@@ -0,0 +1,484 @@
+// cpong_bench - microbenchmarks for the simulation step, AI and render
+// submission, with a baseline comparison for regression checks.
+//
+//   cpong_bench --json base.json                    record a baseline
+//   cpong_bench --baseline base.json --threshold 10 fail on >10% slowdowns
+//
+// Render benchmarks (built with the game) run against MockGL, a counting
+// stand-in for the driver, so they need no GPU or display and also report
+// GL calls per frame. Call counts are deterministic: any increase over the
+// baseline is a regression regardless of the threshold.
+
+#include "AIPolicy.h"
+#include "MultiBall.h"
+#include "Simulation.h"
+#include "Telemetry.h"
+#ifdef CPONG_BENCH_RENDER
+#include "Game.h"
+#include "MockGL.h"
+#include "Renderer.h"
+#endif
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+struct Result {
+    std::string name;
+    double nsPerOp = 0.0;
+    // Per op, render benchmarks only
+    double glCalls = 0.0;
+    double draws = 0.0;
+    double uploadBytes = 0.0;
+};
+
+struct Options {
+    std::string filter;
+    double minSampleMs = 20.0;
+    int samples = 5;
+    bool glBreakdown = false;
+};
+
+// Median of `samples` timed runs, each repeating `op` until it has taken
+// at least minSampleMs. GL counters cover every timed call.
+template <typename Op>
+static Result measure(const std::string& name, const Options& options, Op&& op) {
+    using Clock = std::chrono::steady_clock;
+    Result result;
+    result.name = name;
+
+    // Calibrate: double the batch until one takes a tenth of a sample
+    std::uint64_t batch = 1;
+    for (;;) {
+        auto t0 = Clock::now();
+        for (std::uint64_t i = 0; i < batch; ++i) op();
+        double ms = std::chrono::duration<double, std::milli>(Clock::now() - t0).count();
+        if (ms >= options.minSampleMs / 10.0 || batch >= (1ull << 30)) {
+            batch = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(batch * options.minSampleMs / std::max(ms, 1e-3)));
+            break;
+        }
+        batch *= 2;
+    }
+
+#ifdef CPONG_BENCH_RENDER
+    MockGL::reset();
+#endif
+    std::vector<double> perOp;
+    for (int s = 0; s < options.samples; ++s) {
+        auto t0 = Clock::now();
+        for (std::uint64_t i = 0; i < batch; ++i) op();
+        perOp.push_back(std::chrono::duration<double, std::nano>(Clock::now() - t0).count() / batch);
+    }
+    std::sort(perOp.begin(), perOp.end());
+    result.nsPerOp = perOp[perOp.size() / 2];
+
+#ifdef CPONG_BENCH_RENDER
+    const double ops = static_cast<double>(batch) * options.samples;
+    MockGL::Totals gl = MockGL::totals();
+    result.glCalls = gl.calls / ops;
+    result.draws = gl.draws / ops;
+    result.uploadBytes = gl.uploadBytes / ops;
+#endif
+    return result;
+}
+
+// Keeps the ball at `speed` through goals and serves, so every step
+// measures the same regime
+static void holdSpeed(sim::MatchState& state, float speed) {
+    float current = std::hypot(state.ballVelX, state.ballVelY);
+    if (current > 0.0f && std::abs(current - speed) > 1e-3f) {
+        state.ballVelX *= speed / current;
+        state.ballVelY *= speed / current;
+    }
+}
+
+static void benchStep(std::vector<Result>& results, const Options& options, sim::Integrator integrator, const char* prefix) {
+    for (float speed : {6.0f, 12.0f, 24.0f, 48.0f}) {
+        sim::MatchConfig config;
+        config.integrator = integrator;
+        config.speedBoost = 1.0f;
+        config.maxSpeed = std::max(config.maxSpeed, speed);
+        sim::MatchInputs inputs;
+        inputs.leftAI = true;
+        sim::MatchState state;
+        sim::resetMatch(state, 1, config);
+        holdSpeed(state, speed);
+
+        char name[64];
+        std::snprintf(name, sizeof(name), "%s/speed=%g", prefix, speed);
+        if (std::string(name).find(options.filter) == std::string::npos) continue;
+        results.push_back(measure(name, options, [&] {
+            sim::step(state, config, inputs, 1.0f / 60.0f);
+            holdSpeed(state, speed);
+        }));
+    }
+}
+
+// The predefined tables through the runtime step and through their constexpr
+// instantiations: the gap is what folding the config into the code buys.
+// (cpong_headless --table checks both produce the same states.)
+static void benchTables(std::vector<Result>& results, const Options& options) {
+    struct Table {
+        const char* name;
+        const sim::MatchConfig& config;
+    };
+    for (const Table& table : {Table{"classic", sim::ClassicConfig}, Table{"wide", sim::WideConfig},
+                               Table{"mini", sim::MiniConfig}}) {
+        sim::StaticStep staticStep = sim::findStaticStep(table.config);
+        sim::MatchInputs inputs;
+        inputs.leftAI = true;
+        sim::MatchState runtimeState, staticState;
+        sim::resetMatch(runtimeState, 1, table.config);
+        sim::resetMatch(staticState, 1, table.config);
+
+        std::string prefix = std::string("table/") + table.name;
+        if ((prefix + "/runtime").find(options.filter) != std::string::npos)
+            results.push_back(measure(prefix + "/runtime", options, [&] {
+                sim::step(runtimeState, table.config, inputs, 1.0f / 60.0f);
+            }));
+        if ((prefix + "/static").find(options.filter) != std::string::npos)
+            results.push_back(measure(prefix + "/static", options, [&] {
+                staticStep(staticState, inputs, 1.0f / 60.0f, nullptr);
+            }));
+    }
+}
+
+static void benchAI(std::vector<Result>& results, const Options& options) {
+    sim::MatchConfig config;
+    sim::MatchInputs inputs;
+    inputs.leftAI = true;
+    const float dt = 1.0f / 60.0f;
+
+    if (std::string("ai/builtin").find(options.filter) != std::string::npos) {
+        sim::MatchState state;
+        sim::resetMatch(state, 1, config);
+        results.push_back(measure("ai/builtin", options, [&] {
+            sim::updateAIMistakes(state, config, inputs, dt);
+            sim::moveAIPaddles(state, config, inputs, dt);
+        }));
+    }
+
+    // Policies over a batch of 256 varied positions; reported per match
+    const std::size_t Count = 256;
+    std::vector<float> ballX(Count), ballY(Count), velX(Count), velY(Count), paddleY(Count), aim(Count), target(Count);
+    for (std::size_t i = 0; i < Count; ++i) {
+        float t = static_cast<float>(i) / Count;
+        ballX[i] = (t - 0.5f) * config.tableLength;
+        ballY[i] = std::sin(t * 17.0f) * config.tableWidth * 0.4f;
+        velX[i] = (i % 2 ? 1.0f : -1.0f) * (8.0f + 10.0f * t);
+        velY[i] = std::cos(t * 11.0f) * 6.0f;
+        paddleY[i] = std::sin(t * 5.0f) * 3.0f;
+        aim[i] = std::cos(t * 23.0f) * config.aiRight.mistakeRange;
+    }
+    sim::AIObservations obs;
+    obs.count = Count;
+    obs.side = 1.0f;
+    obs.ballX = ballX.data();
+    obs.ballY = ballY.data();
+    obs.ballVelX = velX.data();
+    obs.ballVelY = velY.data();
+    obs.paddleY = paddleY.data();
+    obs.aimOffset = aim.data();
+
+    std::vector<std::string> specs = {"tracker", "intercept"};
+    for (const char* path : {"ai/intercept.mlp", "../ai/intercept.mlp"}) {
+        if (std::ifstream(path)) {
+            specs.push_back(std::string("mlp:") + path);
+            break;
+        }
+    }
+    for (const std::string& spec : specs) {
+        std::string error;
+        std::unique_ptr<sim::AIPolicy> policy = sim::makeAIPolicy(spec, error);
+        std::string name = std::string("ai/") + (policy ? policy->name() : spec) + "_batch256";
+        if (!policy || name.find(options.filter) == std::string::npos) continue;
+        Result r = measure(name, options, [&] { policy->evaluate(obs, config, target.data()); });
+        r.nsPerOp /= Count;
+        results.push_back(r);
+    }
+}
+
+// One multi-ball tick on the calling thread (cpong_multiball times threads)
+static void benchMultiBall(std::vector<Result>& results, const Options& options) {
+    const char* name = "multiball/tick_balls=10000";
+    if (std::string(name).find(options.filter) == std::string::npos) return;
+    sim::MatchInputs inputs;
+    inputs.leftAI = true;
+    sim::MultiBallConfig balls;
+    balls.balls = 10000;
+    sim::MultiBall game(sim::MatchConfig(), balls, 1);
+    results.push_back(measure(name, options, [&] { game.step(inputs, 1.0f / 60.0f); }));
+}
+
+// One telemetry record, waiting for the writer when the ring is full so the
+// drop path is never what gets timed. With a spare core the writer drains in
+// parallel and this is the game thread's cost; on one core it includes the
+// writer's share. Writes a scratch file in the working directory.
+static void benchTelemetry(std::vector<Result>& results, const Options& options) {
+    const char* name = "telemetry/record";
+    if (std::string(name).find(options.filter) == std::string::npos) return;
+    const char* path = "cpong_bench_telemetry.tmp";
+    sim::TelemetryRecorder telemetry;
+    std::string error;
+    if (!telemetry.open(path, error)) {
+        std::cerr << "telemetry: " << error << "\n";
+        return;
+    }
+    sim::MatchState state;
+    sim::resetMatch(state, 1, sim::MatchConfig());
+    results.push_back(measure(name, options, [&] {
+        state.ballX += 1e-3f;
+        while (telemetry.full()) std::this_thread::yield();
+        telemetry.record(state, 1.0f / 600.0f, 0);
+    }));
+    telemetry.close();
+    std::remove(path);
+}
+
+#ifdef CPONG_BENCH_RENDER
+static void benchRender(std::vector<Result>& results, const Options& options) {
+    const std::string filter = options.filter;
+    auto wanted = [&](const char* name) { return std::string(name).find(filter) != std::string::npos; };
+
+    {
+        // Lockstep game: what one frame of the main loop submits
+        Game game(1280, 720, 1);
+        if (wanted("frame/update+render"))
+            results.push_back(measure("frame/update+render", options, [&] {
+                game.update(1.0f / 60.0f);
+                game.render();
+            }));
+        if (wanted("frame/render")) results.push_back(measure("frame/render", options, [&] { game.render(); }));
+        if (options.glBreakdown) {
+            MockGL::reset();
+            game.render();
+            std::printf("GL calls in one frame (state cache: %llu issued, %llu elided):\n",
+                        static_cast<unsigned long long>(game.glStats().issued),
+                        static_cast<unsigned long long>(game.glStats().elided));
+            for (const auto& call : MockGL::calls())
+                std::printf("  %-28s %llu\n", call.first.c_str(), static_cast<unsigned long long>(call.second));
+        }
+    }
+
+    // Immediate-mode rects through the instanced batcher
+    for (int rects : {16, 1024}) {
+        char name[64];
+        std::snprintf(name, sizeof(name), "renderer/flush_rects=%d", rects);
+        if (!wanted(name)) continue;
+        GLState gl;
+        Renderer renderer(gl);
+        results.push_back(measure(name, options, [&] {
+            for (int i = 0; i < rects; ++i) {
+                float x = static_cast<float>(i % 32) - 16.0f, y = static_cast<float>(i / 32) - 16.0f;
+                renderer.drawRectFilled(x, y, x + 0.8f, y + 0.8f, 0.0f, glm::vec3(1.0f, 0.5f, 0.2f));
+            }
+            renderer.flush();
+        }));
+    }
+
+    // Multi-ball mode: every ball in one instanced draw
+    if (wanted("renderer/flush_balls=10000")) {
+        const std::size_t Count = 10000;
+        std::vector<float> x(Count), y(Count);
+        for (std::size_t i = 0; i < Count; ++i) {
+            x[i] = static_cast<float>(i % 100) * 0.2f - 10.0f;
+            y[i] = static_cast<float>(i / 100) * 0.12f - 6.0f;
+        }
+        GLState gl;
+        Renderer renderer(gl);
+        results.push_back(measure("renderer/flush_balls=10000", options, [&] {
+            renderer.drawCubes(x.data(), y.data(), Count, 0.15f, 0.06f, glm::vec3(1.0f, 1.0f, 0.0f));
+            renderer.flush();
+        }));
+    }
+}
+#endif
+
+// CSV: name,ns_per_op,gl_calls,draws,upload_bytes
+static bool writeCsv(const std::string& path, const std::vector<Result>& results) {
+    std::ofstream out(path);
+    out << "name,ns_per_op,gl_calls,draws,upload_bytes\n";
+    for (const Result& r : results)
+        out << r.name << ',' << r.nsPerOp << ',' << r.glCalls << ',' << r.draws << ',' << r.uploadBytes << '\n';
+    return static_cast<bool>(out);
+}
+
+static bool writeJson(const std::string& path, const std::vector<Result>& results) {
+    std::ofstream out(path);
+    out << "{\n  \"benchmarks\": [\n";
+    for (std::size_t i = 0; i < results.size(); ++i) {
+        const Result& r = results[i];
+        out << "    {\"name\": \"" << r.name << "\", \"ns_per_op\": " << r.nsPerOp << ", \"gl_calls\": " << r.glCalls
+            << ", \"draws\": " << r.draws << ", \"upload_bytes\": " << r.uploadBytes << "}"
+            << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+    out << "  ]\n}\n";
+    return static_cast<bool>(out);
+}
+
+// Reads what writeCsv/writeJson produce (one JSON object per benchmark)
+static bool readBaseline(const std::string& path, std::vector<Result>& results, std::string& error) {
+    std::ifstream in(path);
+    if (!in) {
+        error = "cannot open " + path;
+        return false;
+    }
+    std::stringstream text;
+    text << in.rdbuf();
+    const std::string s = text.str();
+
+    if (path.size() >= 5 && path.compare(path.size() - 5, 5, ".json") == 0) {
+        auto field = [](const std::string& object, const char* key) {
+            std::size_t at = object.find(std::string("\"") + key + "\"");
+            if (at == std::string::npos) return std::string();
+            at = object.find(':', at) + 1;
+            while (at < object.size() && (object[at] == ' ' || object[at] == '"')) ++at;
+            std::size_t end = object.find_first_of(",}\"", at);
+            return object.substr(at, end - at);
+        };
+        for (std::size_t open = s.find('{', 1); open != std::string::npos; open = s.find('{', open + 1)) {
+            std::size_t close = s.find('}', open);
+            std::string object = s.substr(open, close - open + 1);
+            Result r;
+            r.name = field(object, "name");
+            if (r.name.empty()) continue;
+            r.nsPerOp = std::atof(field(object, "ns_per_op").c_str());
+            r.glCalls = std::atof(field(object, "gl_calls").c_str());
+            r.draws = std::atof(field(object, "draws").c_str());
+            r.uploadBytes = std::atof(field(object, "upload_bytes").c_str());
+            results.push_back(r);
+        }
+    } else {
+        std::istringstream lines(s);
+        std::string line;
+        std::getline(lines, line);  // header
+        while (std::getline(lines, line)) {
+            std::istringstream cells(line);
+            Result r;
+            std::string cell;
+            std::getline(cells, r.name, ',');
+            double* values[] = {&r.nsPerOp, &r.glCalls, &r.draws, &r.uploadBytes};
+            for (double* v : values)
+                if (std::getline(cells, cell, ',')) *v = std::atof(cell.c_str());
+            if (!r.name.empty()) results.push_back(r);
+        }
+    }
+    if (results.empty()) {
+        error = path + ": no benchmarks";
+        return false;
+    }
+    return true;
+}
+
+static void printUsage() {
+    std::cout << "Usage: cpong_bench [--filter TEXT] [--min-time MS] [--samples N] [--csv FILE] [--json FILE]\n"
+                 "                   [--baseline FILE] [--threshold PERCENT] [--gl-calls]\n"
+                 "  --filter     only benchmarks whose name contains TEXT\n"
+                 "  --min-time   per sample (default 20)\n"
+                 "  --samples    timed samples, the median is reported (default 5)\n"
+                 "  --csv/--json write results\n"
+                 "  --baseline   compare with a previous --csv/--json; exit 1 on regressions\n"
+                 "  --threshold  allowed slowdown before failing (default 10)\n"
+                 "  --gl-calls   list the GL calls of one rendered frame (game builds)\n";
+}
+
+int main(int argc, char** argv) {
+    Options options;
+    std::string csvPath, jsonPath, baselinePath;
+    double threshold = 10.0;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--filter") == 0 && i + 1 < argc) {
+            options.filter = argv[++i];
+        } else if (std::strcmp(argv[i], "--min-time") == 0 && i + 1 < argc) {
+            options.minSampleMs = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--samples") == 0 && i + 1 < argc) {
+            options.samples = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--csv") == 0 && i + 1 < argc) {
+            csvPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--json") == 0 && i + 1 < argc) {
+            jsonPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--baseline") == 0 && i + 1 < argc) {
+            baselinePath = argv[++i];
+        } else if (std::strcmp(argv[i], "--threshold") == 0 && i + 1 < argc) {
+            threshold = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--gl-calls") == 0) {
+            options.glBreakdown = true;
+        } else {
+            printUsage();
+            return std::strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+    }
+    if (options.minSampleMs <= 0.0) {
+        printUsage();
+        return 1;
+    }
+
+    std::vector<Result> baseline;
+    std::string error;
+    if (!baselinePath.empty() && !readBaseline(baselinePath, baseline, error)) {
+        std::cerr << error << "\n";
+        return 1;
+    }
+
+    std::vector<Result> results;
+    benchStep(results, options, sim::Integrator::Event, "step/event");
+    benchStep(results, options, sim::Integrator::Substep, "step/substep");
+    benchStep(results, options, sim::Integrator::Fixed, "step/fixed");
+    benchTables(results, options);
+    benchAI(results, options);
+    benchMultiBall(results, options);
+    benchTelemetry(results, options);
+#ifdef CPONG_BENCH_RENDER
+    if (!MockGL::load()) {
+        std::cerr << "glad rejected the mock GL entry points\n";
+        return 1;
+    }
+    benchRender(results, options);
+#endif
+
+    std::printf("%-28s %12s %10s %8s %12s\n", "benchmark", "ns/op", "gl calls", "draws", "upload B");
+    for (const Result& r : results)
+        std::printf("%-28s %12.1f %10.1f %8.1f %12.1f\n", r.name.c_str(), r.nsPerOp, r.glCalls, r.draws,
+                    r.uploadBytes);
+
+    if (!csvPath.empty() && !writeCsv(csvPath, results)) std::cerr << "cannot write " << csvPath << "\n";
+    if (!jsonPath.empty() && !writeJson(jsonPath, results)) std::cerr << "cannot write " << jsonPath << "\n";
+    if (baseline.empty()) return 0;
+
+    // Time beyond the threshold, or any extra GL work, fails
+    int regressions = 0;
+    std::printf("\n%-28s %12s %12s %8s  %s\n", "vs baseline", "base ns/op", "ns/op", "change", "");
+    for (const Result& r : results) {
+        auto base = std::find_if(baseline.begin(), baseline.end(), [&](const Result& b) { return b.name == r.name; });
+        if (base == baseline.end()) {
+            std::printf("%-28s %12s %12.1f %8s  new\n", r.name.c_str(), "-", r.nsPerOp, "");
+            continue;
+        }
+        double change = base->nsPerOp > 0.0 ? (r.nsPerOp / base->nsPerOp - 1.0) * 100.0 : 0.0;
+        bool slower = change > threshold;
+        bool moreGL = r.glCalls > base->glCalls + 1e-6 || r.draws > base->draws + 1e-6;
+        std::string verdict = slower ? "REGRESSED" : "ok";
+        if (moreGL) {
+            char calls[96];
+            std::snprintf(calls, sizeof(calls), "%sGL calls %.1f -> %.1f", slower ? "REGRESSED, " : "REGRESSED: ",
+                          base->glCalls, r.glCalls);
+            verdict = calls;
+        }
+        if (slower || moreGL) regressions++;
+        std::printf("%-28s %12.1f %12.1f %+7.1f%%  %s\n", r.name.c_str(), base->nsPerOp, r.nsPerOp, change,
+                    verdict.c_str());
+    }
+    std::printf("%d regression%s (threshold %.0f%%)\n", regressions, regressions == 1 ? "" : "s", threshold);
+    return regressions ? 1 : 0;
+}
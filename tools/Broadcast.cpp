@@ -0,0 +1,161 @@
+// cpong_broadcast - plays an AI-vs-AI match in real time at 60 Hz and
+// broadcasts it to spectators (CPong --spectate, cpong_spectator_load) over
+// TCP and UDP from a single-threaded epoll loop. Linux only.
+//
+// The match depends only on --seed, so a load generator with the same seed
+// can check every frame it decodes against its own replay.
+
+#include "SimThread.h"
+#include "Simulation.h"
+#include "SpectatorServer.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <string>
+#include <sys/resource.h>
+#include <unistd.h>
+
+static void printUsage() {
+    std::cout << "Usage: cpong_broadcast [--port N] [--seed N] [--snapshot-rate HZ] [--tcp-batch N]\n"
+                 "                       [--max-clients N] [--seconds N] [--stats-every N]\n"
+                 "  --port           TCP and UDP port (default 7780)\n"
+                 "  --seed           match seed (default 1)\n"
+                 "  --snapshot-rate  snapshots per second, at most 60 (default 20)\n"
+                 "  --tcp-batch      snapshots per TCP send (default 2)\n"
+                 "  --max-clients    per transport (default 16384)\n"
+                 "  --seconds        stop after N seconds (default 0 = run until killed)\n"
+                 "  --stats-every    seconds between stats lines (default 5)\n";
+}
+
+static double cpuSeconds() {
+    timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+static double residentMb() {
+    long pages = 0, resident = 0;
+    if (FILE* f = std::fopen("/proc/self/statm", "r")) {
+        if (std::fscanf(f, "%ld %ld", &pages, &resident) != 2) resident = 0;
+        std::fclose(f);
+    }
+    return resident * static_cast<double>(sysconf(_SC_PAGESIZE)) / (1024.0 * 1024.0);
+}
+
+int main(int argc, char** argv) {
+    int port = 7780;
+    std::uint64_t seed = 1;
+    double snapshotRate = 20.0;
+    std::uint32_t tcpBatch = 2;
+    std::size_t maxClients = 16384;
+    double seconds = 0.0;
+    double statsEvery = 5.0;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--port") == 0 && i + 1 < argc) {
+            port = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--snapshot-rate") == 0 && i + 1 < argc) {
+            snapshotRate = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--tcp-batch") == 0 && i + 1 < argc) {
+            tcpBatch = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--max-clients") == 0 && i + 1 < argc) {
+            maxClients = static_cast<std::size_t>(std::strtoull(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            seconds = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--stats-every") == 0 && i + 1 < argc) {
+            statsEvery = std::atof(argv[++i]);
+        } else {
+            printUsage();
+            return std::strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+    }
+    if (snapshotRate <= 0.0 || snapshotRate > 60.0 || statsEvery <= 0.0) {
+        printUsage();
+        return 1;
+    }
+
+    // One descriptor per TCP spectator
+    rlimit files;
+    if (getrlimit(RLIMIT_NOFILE, &files) == 0 && files.rlim_cur < files.rlim_max) {
+        files.rlim_cur = files.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &files);
+    }
+
+    sim::SpectatorServer server(maxClients);
+    server.setTcpBatch(tcpBatch);
+    std::string error;
+    if (!server.open(static_cast<std::uint16_t>(port), error)) {
+        std::cerr << error << "\n";
+        return 1;
+    }
+    const std::uint32_t publishEvery = std::max(1u, static_cast<std::uint32_t>(sim::SnapshotTickHz / snapshotRate + 0.5));
+    std::printf("broadcasting seed %llu on port %u (tcp+udp), %.1f snapshots/s\n",
+                static_cast<unsigned long long>(seed), server.port(),
+                static_cast<double>(sim::SnapshotTickHz) / publishEvery);
+    std::fflush(stdout);
+
+    sim::MatchConfig config;
+    sim::MatchState state;
+    sim::resetMatch(state, seed, config);
+    sim::MatchInputs inputs;
+    inputs.leftAI = true;
+    inputs.rightAI = true;
+    const float dt = 1.0f / sim::SnapshotTickHz;
+    const std::int64_t tickNs = 1000000000LL / sim::SnapshotTickHz;
+
+    const std::int64_t start = sim::steadyNowNs();
+    const std::int64_t end = seconds > 0.0 ? start + static_cast<std::int64_t>(seconds * 1e9) : INT64_MAX;
+    std::uint32_t tick = 0;
+    std::int64_t statsAt = start;
+    double statsCpu = cpuSeconds();
+    sim::SpectatorServer::Stats last = server.stats();
+    server.publish(state, tick, start);
+
+    for (std::int64_t now = start; now < end; now = sim::steadyNowNs()) {
+        // Catch up on every due tick (the match must stay a pure function of
+        // the seed), but publish only the newest state when behind
+        const std::int64_t due = (now - start) / tickNs;
+        const std::uint32_t published = tick / publishEvery;
+        while (static_cast<std::int64_t>(tick) < due) {
+            sim::step(state, config, inputs, dt);
+            tick++;
+        }
+        if (tick / publishEvery != published) server.publish(state, tick, now);
+
+        if (now - statsAt >= static_cast<std::int64_t>(statsEvery * 1e9)) {
+            const sim::SpectatorServer::Stats& s = server.stats();
+            double wall = (now - statsAt) * 1e-9;
+            double cpu = cpuSeconds();
+            std::uint64_t frames = s.framesQueued - last.framesQueued;
+            std::printf("t=%5.0fs  tcp %zu  udp %zu  |  %.0f frames/s  %.2f MB/s  %.0f sends/s  skipped %llu"
+                        "  |  key %.1f B  delta %.1f B  |  cpu %.0f%%  rss %.1f MB\n",
+                        (now - start) * 1e-9, server.tcpClients(), server.udpClients(), frames / wall,
+                        (s.bytesSent - last.bytesSent) / wall / (1024.0 * 1024.0),
+                        (s.sendCalls - last.sendCalls) / wall,
+                        static_cast<unsigned long long>(s.framesSkipped - last.framesSkipped),
+                        s.keyFrames ? static_cast<double>(s.keyBytes) / s.keyFrames : 0.0,
+                        s.deltaFrames ? static_cast<double>(s.deltaBytes) / s.deltaFrames : 0.0,
+                        (cpu - statsCpu) / wall * 100.0, residentMb());
+            std::fflush(stdout);
+            last = s;
+            statsAt = now;
+            statsCpu = cpu;
+        }
+
+        std::int64_t next = start + (static_cast<std::int64_t>(tick) + 1) * tickNs;
+        int timeoutMs = static_cast<int>(std::max<std::int64_t>(0, (next - sim::steadyNowNs() + 999999) / 1000000));
+        server.poll(timeoutMs, sim::steadyNowNs());
+    }
+
+    const sim::SpectatorServer::Stats& s = server.stats();
+    std::printf("done: %u ticks, %llu accepted, %llu disconnected, %llu rejected, %llu udp subscriptions\n", tick,
+                static_cast<unsigned long long>(s.accepted), static_cast<unsigned long long>(s.disconnected),
+                static_cast<unsigned long long>(s.rejected), static_cast<unsigned long long>(s.udpSubscribed));
+    return 0;
+}
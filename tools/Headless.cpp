@@ -0,0 +1,406 @@
+// cpong_headless - runs AI-vs-AI matches without a window or GL context
+// and reports simulation throughput.
+
+#include "AIPolicy.h"
+#include "InputLog.h"
+#include "MatchBatch.h"
+#include "Simulation.h"
+#include "Telemetry.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+static void printUsage() {
+    std::cout << "Usage: cpong_headless [--matches N] [--ticks N] [--dt SECONDS] [--integrator event|substep|fixed] [--seed N]\n"
+                 "                      [--record FILE] [--telemetry FILE] [--replay FILE] [--crosscheck]\n"
+                 "                      [--left-ai POLICY] [--right-ai POLICY] [--batched]\n"
+                 "                      [--table classic|wide|mini] [--runtime-config]\n"
+                 "  --matches     number of independent matches (default 64)\n"
+                 "  --ticks       frames stepped per match (default 36000)\n"
+                 "  --dt          frame time fed to each step (default 1/60)\n"
+                 "  --integrator  ball integrator (default event; fixed in CPONG_FIXED_POINT builds)\n"
+                 "  --seed        seed of match 0; match i uses seed + i (default: time)\n"
+                 "  --record      write match 0's input log to FILE\n"
+                 "  --telemetry   write match 0's per-tick telemetry to FILE and report its cost\n"
+                 "  --replay      re-run an input log (with its AI policies) at full speed and verify its final state\n"
+                 "  --crosscheck  fire --matches serves through the substep reference and --integrator\n"
+                 "  --left-ai     AI policy: tracker (default), intercept or mlp:FILE\n"
+                 "  --right-ai    likewise for the right paddle\n"
+                 "  --batched     step all matches together (MatchBatch; one policy call per tick)\n"
+                 "  --table       predefined table; stepped by its compile-time specialised step\n"
+                 "  --runtime-config  step a --table through the runtime-config step instead\n";
+}
+
+static const char* integratorName(sim::Integrator integrator) {
+    switch (integrator) {
+    case sim::Integrator::Event: return "event";
+    case sim::Integrator::Substep: return "substep";
+    case sim::Integrator::Fixed: return "fixed";
+    }
+    return "?";
+}
+
+// The predefined table `config` equals (what findStaticStep matches), else "custom"
+static const char* tableLabel(const sim::MatchConfig& config) {
+    if (sim::sameConfig(config, sim::ClassicConfig)) return "classic";
+    if (sim::sameConfig(config, sim::WideConfig)) return "wide";
+    if (sim::sameConfig(config, sim::MiniConfig)) return "mini";
+    return "custom";
+}
+
+// FNV-1a over every field; equal digests on two machines mean the runs were
+// bit-identical
+static std::uint64_t stateDigest(const std::vector<sim::MatchState>& states) {
+    std::uint64_t hash = 1469598103934665603ULL;
+    auto add = [&](const void* data, std::size_t bytes) {
+        const unsigned char* p = static_cast<const unsigned char*>(data);
+        for (std::size_t i = 0; i < bytes; ++i) hash = (hash ^ p[i]) * 1099511628211ULL;
+    };
+    for (const sim::MatchState& s : states) {
+        for (float v : {s.ballX, s.ballY, s.ballVelX, s.ballVelY, s.paddleLeftY, s.paddleRightY, s.aiLeft.targetOffset,
+                        s.aiLeft.mistakeTimer, s.aiRight.targetOffset, s.aiRight.mistakeTimer})
+            add(&v, sizeof(v));
+        add(&s.scoreLeft, sizeof(s.scoreLeft));
+        add(&s.scoreRight, sizeof(s.scoreRight));
+        add(&s.rng, sizeof(s.rng));
+    }
+    return hash;
+}
+
+struct ShotResult {
+    int winner = 0;       // -1 left scored on, 1 right scored on, 0 still in play
+    long long ticks = 0;  // ticks until the goal
+    int paddleHits = 0;
+};
+
+// Plays one serve against static paddles, one substep (fixedDt) per frame so
+// both integrators cover exactly the same time. Records the trajectory.
+static ShotResult playShot(const sim::MatchConfig& config, sim::MatchState state, long long maxTicks,
+                           std::vector<sim::MatchState>* trace) {
+    sim::MatchInputs inputs;
+    inputs.leftAI = false;
+    inputs.rightAI = false;
+    ShotResult result;
+    for (long long t = 0; t < maxTicks; ++t) {
+        float prevVx = state.ballVelX;
+        sim::MatchState before = state;
+        sim::step(state, config, inputs, config.fixedDt);
+        if (state.scoreLeft != before.scoreLeft || state.scoreRight != before.scoreRight) {
+            result.winner = state.scoreLeft != before.scoreLeft ? 1 : -1;
+            result.ticks = t + 1;
+            return result;
+        }
+        if ((prevVx < 0) != (state.ballVelX < 0)) result.paddleHits++;
+        if (trace) trace->push_back(state);
+    }
+    result.ticks = maxTicks;
+    return result;
+}
+
+// Fires random serves (speeds up to 1.5x maxSpeed) at randomly placed static
+// paddles through the substep reference and `integrator`, and compares
+// outcomes and trajectories.
+static int crossCheck(int shots, long long maxTicks, sim::Integrator integrator) {
+    sim::MatchConfig reference;
+    reference.integrator = sim::Integrator::Substep;
+    sim::MatchConfig event = reference;
+    event.integrator = integrator;
+
+    std::srand(12345u);
+    auto uniform = [](float lo, float hi) { return lo + (hi - lo) * (std::rand() / (float)RAND_MAX); };
+    const float limit = (reference.tableWidth - reference.paddleHeight) / 2.0f;
+
+    int sameOutcome = 0, sameHits = 0;
+    long long maxTickDelta = 0;
+    float maxDeviation = 0.0f;
+    double refSeconds = 0.0, eventSeconds = 0.0;
+
+    for (int i = 0; i < shots; ++i) {
+        sim::MatchState start;
+        float speed = uniform(5.0f, reference.maxSpeed * 1.5f);
+        float angle = uniform(-1.2f, 1.2f) + (std::rand() % 2 ? 3.14159265f : 0.0f);
+        start.ballY = uniform(-4.0f, 4.0f);
+        start.ballVelX = speed * std::cos(angle);
+        start.ballVelY = speed * std::sin(angle);
+        start.paddleLeftY = uniform(-limit, limit);
+        start.paddleRightY = uniform(-limit, limit);
+
+        std::vector<sim::MatchState> refTrace, eventTrace;
+        auto t0 = std::chrono::steady_clock::now();
+        ShotResult a = playShot(reference, start, maxTicks, &refTrace);
+        auto t1 = std::chrono::steady_clock::now();
+        ShotResult b = playShot(event, start, maxTicks, &eventTrace);
+        auto t2 = std::chrono::steady_clock::now();
+        refSeconds += std::chrono::duration<double>(t1 - t0).count();
+        eventSeconds += std::chrono::duration<double>(t2 - t1).count();
+
+        if (a.winner == b.winner) sameOutcome++;
+        if (a.paddleHits == b.paddleHits) sameHits++;
+        if (a.winner == b.winner && a.paddleHits == b.paddleHits) {
+            maxTickDelta = std::max(maxTickDelta, std::abs(a.ticks - b.ticks));
+            size_t n = std::min(refTrace.size(), eventTrace.size());
+            for (size_t t = 0; t < n; ++t) {
+                maxDeviation = std::max({maxDeviation, std::abs(refTrace[t].ballX - eventTrace[t].ballX),
+                                         std::abs(refTrace[t].ballY - eventTrace[t].ballY)});
+            }
+        }
+    }
+
+    const char* name = integratorName(integrator);
+    std::cout << "cross-check:  " << shots << " serves, substep vs " << name << ", dt = fixedDt\n"
+              << "same winner:  " << sameOutcome << " / " << shots << "\n"
+              << "same hits:    " << sameHits << " / " << shots << "\n"
+              << "goal tick dt: " << maxTickDelta << " ticks max (agreeing serves)\n"
+              << "max ball dev: " << maxDeviation << " units (agreeing serves)\n"
+              << "substep:      " << refSeconds << " s\n"
+              << name << ":" << std::string(13 - std::strlen(name), ' ') << eventSeconds << " s\n";
+    return sameOutcome * 100 >= shots * 99 ? 0 : 1;
+}
+
+// Steps match 0 twice, without and with telemetry, and reports what
+// recording added per tick. Stepping runs far ahead of real time, so it waits
+// for the writer instead of dropping ticks; with a spare core that costs
+// nothing. Leaves `state` reset.
+static int recordTelemetry(const char* path, sim::MatchState& state, std::uint64_t seed,
+                           const sim::MatchConfig& config, const sim::MatchInputs& inputs, float dt, long long ticks) {
+    sim::TelemetryRecorder telemetry;
+    std::string error;
+    if (!telemetry.open(path, error)) {
+        std::cerr << "telemetry: " << error << "\n";
+        return 1;
+    }
+    auto start = std::chrono::steady_clock::now();
+    for (long long t = 0; t < ticks; ++t) sim::step(state, config, inputs, dt);
+    auto plainEnd = std::chrono::steady_clock::now();
+    sim::resetMatch(state, seed, config);
+    for (long long t = 0; t < ticks; ++t) {
+        unsigned events = sim::step(state, config, inputs, dt);
+        while (telemetry.full()) std::this_thread::yield();
+        telemetry.record(state, dt, events);
+    }
+    telemetry.close();  // the time to drain what is left counts too
+    auto recordEnd = std::chrono::steady_clock::now();
+    sim::resetMatch(state, seed, config);
+
+    double plainNs = std::chrono::duration<double, std::nano>(plainEnd - start).count() / ticks;
+    double recordNs = std::chrono::duration<double, std::nano>(recordEnd - plainEnd).count() / ticks;
+    std::cout << "telemetry:    " << telemetry.recorded() << " ticks to " << path << "\n"
+              << "record cost:  " << std::max(recordNs - plainNs, 0.0) << " ns/tick (step " << plainNs
+              << " ns/tick)\n";
+    if (!telemetry.writeError().empty()) {
+        std::cerr << "telemetry: " << telemetry.writeError() << "\n";
+        return 1;
+    }
+    return 0;
+}
+
+// Re-runs a recorded session as fast as possible. Exit code 0 only if the
+// final state is bit-identical to the one stored in the log.
+static int replay(const char* path) {
+    sim::InputLog log;
+    std::string error;
+    if (!sim::loadInputLog(path, log, error)) {
+        std::cerr << "replay: " << error << "\n";
+        return 1;
+    }
+
+    sim::MatchState state;
+    double simSeconds = 0.0;
+    auto start = std::chrono::steady_clock::now();
+    sim::resetMatch(state, log.seed, log.config);
+    for (const sim::InputFrame& frame : log.frames) {
+        sim::step(state, log.config, sim::decodeInputs(frame), frame.dt);
+        simSeconds += frame.dt;
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::cout << "replayed:     " << log.frames.size() << " ticks (" << simSeconds << " s of play)\n"
+              << "elapsed:      " << seconds << " s\n"
+              << "realtime x:   " << (seconds > 0 ? simSeconds / seconds : 0.0) << "\n"
+              << "AI L:R        " << (log.leftPolicy ? log.leftPolicy->name() : "tracker") << " : "
+              << (log.rightPolicy ? log.rightPolicy->name() : "tracker") << "\n"
+              << "score:        " << state.scoreLeft << " : " << state.scoreRight << "\n";
+    if (!log.hasFinalState) {
+        std::cout << "final state:  not recorded (log has no trailer)\n";
+        return 0;
+    }
+    bool match = sim::sameState(state, log.finalState);
+    std::cout << "final state:  " << (match ? "bit-identical" : "MISMATCH") << "\n";
+    return match ? 0 : 1;
+}
+
+int main(int argc, char** argv) {
+    int matches = 64;
+    long long ticks = 36000;
+    float dt = 1.0f / 60.0f;
+    sim::MatchConfig config;
+    std::uint64_t seed = static_cast<std::uint64_t>(std::time(nullptr));
+    bool crossCheckMode = false;
+    const char* recordPath = nullptr;
+    const char* telemetryPath = nullptr;
+    const char* replayPath = nullptr;
+    const char* leftPolicySpec = nullptr;
+    const char* rightPolicySpec = nullptr;
+    bool batched = false;
+    const sim::MatchConfig* table = nullptr;
+    bool integratorGiven = false;
+    bool runtimeConfig = false;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--matches") == 0 && i + 1 < argc) {
+            matches = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) {
+            ticks = std::atoll(argv[++i]);
+        } else if (std::strcmp(argv[i], "--dt") == 0 && i + 1 < argc) {
+            dt = static_cast<float>(std::atof(argv[++i]));
+        } else if (std::strcmp(argv[i], "--integrator") == 0 && i + 1 < argc) {
+            const char* name = argv[++i];
+            integratorGiven = true;
+            if (std::strcmp(name, "substep") == 0) {
+                config.integrator = sim::Integrator::Substep;
+            } else if (std::strcmp(name, "event") == 0) {
+                config.integrator = sim::Integrator::Event;
+            } else if (std::strcmp(name, "fixed") == 0) {
+                config.integrator = sim::Integrator::Fixed;
+            } else {
+                printUsage();
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--record") == 0 && i + 1 < argc) {
+            recordPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--telemetry") == 0 && i + 1 < argc) {
+            telemetryPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replayPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--crosscheck") == 0) {
+            crossCheckMode = true;
+        } else if (std::strcmp(argv[i], "--left-ai") == 0 && i + 1 < argc) {
+            leftPolicySpec = argv[++i];
+        } else if (std::strcmp(argv[i], "--right-ai") == 0 && i + 1 < argc) {
+            rightPolicySpec = argv[++i];
+        } else if (std::strcmp(argv[i], "--batched") == 0) {
+            batched = true;
+        } else if (std::strcmp(argv[i], "--table") == 0 && i + 1 < argc) {
+            const char* tableName = argv[++i];
+            if (std::strcmp(tableName, "classic") == 0) {
+                table = &sim::ClassicConfig;
+            } else if (std::strcmp(tableName, "wide") == 0) {
+                table = &sim::WideConfig;
+            } else if (std::strcmp(tableName, "mini") == 0) {
+                table = &sim::MiniConfig;
+            } else {
+                printUsage();
+                return 1;
+            }
+        } else if (std::strcmp(argv[i], "--runtime-config") == 0) {
+            runtimeConfig = true;
+        } else {
+            printUsage();
+            return std::strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+    }
+    if (matches <= 0 || ticks <= 0 || dt <= 0.0f) {
+        printUsage();
+        return 1;
+    }
+
+    if (table) {
+        sim::Integrator integrator = config.integrator;
+        config = *table;
+        if (integratorGiven) config.integrator = integrator;
+    }
+
+    if (replayPath) return replay(replayPath);
+    if (crossCheckMode) return crossCheck(matches, ticks, config.integrator);
+
+    std::unique_ptr<sim::AIPolicy> leftPolicy, rightPolicy;
+    std::string error;
+    if (leftPolicySpec && !(leftPolicy = sim::makeAIPolicy(leftPolicySpec, error))) {
+        std::cerr << error << "\n";
+        return 1;
+    }
+    if (rightPolicySpec && !(rightPolicy = sim::makeAIPolicy(rightPolicySpec, error))) {
+        std::cerr << error << "\n";
+        return 1;
+    }
+    config.aiLeft.policy = leftPolicy.get();
+    config.aiRight.policy = rightPolicy.get();
+
+    sim::MatchInputs inputs;
+    inputs.leftAI = true;
+    inputs.rightAI = true;
+
+    std::vector<sim::MatchState> states(matches);
+    for (int i = 0; i < matches; ++i) sim::resetMatch(states[i], seed + static_cast<std::uint64_t>(i), config);
+
+    sim::InputRecorder recorder;
+    if (recordPath) {
+        if (!recorder.open(recordPath, seed, config)) {
+            std::cerr << "Cannot open " << recordPath << "\n";
+            return 1;
+        }
+        const sim::InputFrame frame = sim::encodeFrame(inputs, dt);
+        for (long long t = 0; t < ticks; ++t) {
+            recorder.record(frame);
+            sim::step(states[0], config, sim::decodeInputs(frame), frame.dt);
+        }
+        recorder.close(states[0]);
+        sim::resetMatch(states[0], seed, config);
+    }
+    if (telemetryPath && recordTelemetry(telemetryPath, states[0], seed, config, inputs, dt, ticks) != 0) return 1;
+
+    // Predefined tables step through their constexpr instantiation
+    sim::StaticStep staticStep = runtimeConfig ? nullptr : sim::findStaticStep(config);
+
+    auto start = std::chrono::steady_clock::now();
+    if (batched) {
+        sim::MatchBatch batch(states.size());
+        for (std::size_t i = 0; i < states.size(); ++i) batch.set(i, states[i]);
+        for (long long t = 0; t < ticks; ++t) batch.step(config, inputs, dt);
+        for (std::size_t i = 0; i < states.size(); ++i) states[i] = batch.get(i);
+    } else if (staticStep) {
+        for (sim::MatchState& s : states) {
+            for (long long t = 0; t < ticks; ++t)
+                staticStep(s, inputs, dt, nullptr);
+        }
+    } else {
+        for (sim::MatchState& s : states) {
+            for (long long t = 0; t < ticks; ++t)
+                sim::step(s, config, inputs, dt);
+        }
+    }
+    auto end = std::chrono::steady_clock::now();
+
+    double seconds = std::chrono::duration<double>(end - start).count();
+    double totalTicks = static_cast<double>(ticks) * matches;
+    long long pointsLeft = 0, pointsRight = 0;
+    for (const sim::MatchState& s : states) {
+        pointsLeft += s.scoreLeft;
+        pointsRight += s.scoreRight;
+    }
+
+    std::cout << "integrator:   " << integratorName(config.integrator) << "\n"
+              << "table:        " << tableLabel(config) << (staticStep && !batched ? " (static step)" : " (runtime step)") << "\n"
+              << "AI L:R        " << (leftPolicy ? leftPolicy->name() : "tracker") << " : "
+              << (rightPolicy ? rightPolicy->name() : "tracker") << "\n"
+              << "matches:      " << matches << "\n"
+              << "ticks/match:  " << ticks << "\n"
+              << "elapsed:      " << seconds << " s\n"
+              << "ticks/sec:    " << (seconds > 0 ? totalTicks / seconds : 0.0) << "\n"
+              << "realtime x:   " << (seconds > 0 ? totalTicks * dt / seconds : 0.0) << "\n"
+              << "points L:R    " << pointsLeft << " : " << pointsRight << "\n";
+    std::printf("digest:       %016llx\n", static_cast<unsigned long long>(stateDigest(states)));
+    return 0;
+}
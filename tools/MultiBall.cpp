@@ -0,0 +1,122 @@
+// cpong_multiball - times sim::MultiBall ticks against the 60 Hz frame
+// budget at increasing thread counts, and checks every parallel run ends in
+// exactly the same state as the single-threaded one.
+
+#include "MultiBall.h"
+#include "WorkStealingPool.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+struct RunResult {
+    double msPerTick = 0.0;
+    std::uint64_t checksum = 0;
+    sim::MultiBall::Stats stats;
+    int scoreLeft = 0, scoreRight = 0;
+};
+
+static RunResult run(const sim::MultiBallConfig& balls, std::uint64_t seed, int ticks, WorkStealingPool* pool) {
+    sim::MatchConfig config;
+    sim::MatchInputs inputs;
+    inputs.leftAI = true;
+    inputs.rightAI = true;
+    const float dt = 1.0f / 60.0f;
+
+    sim::MultiBall game(config, balls, seed);
+    game.setPool(pool);
+    game.step(inputs, dt);  // warm-up: first touch of every column
+
+    auto t0 = std::chrono::steady_clock::now();
+    for (int t = 1; t < ticks; ++t) game.step(inputs, dt);
+    auto t1 = std::chrono::steady_clock::now();
+
+    RunResult result;
+    result.msPerTick = std::chrono::duration<double, std::milli>(t1 - t0).count() / std::max(1, ticks - 1);
+    result.checksum = game.checksum();
+    result.stats = game.stats();
+    result.scoreLeft = game.scoreLeft;
+    result.scoreRight = game.scoreRight;
+    return result;
+}
+
+static void printUsage() {
+    std::cout << "Usage: cpong_multiball [options]\n"
+                 "  --balls N         balls on the table (default 50000)\n"
+                 "  --radius R        ball radius (default: ~8% table coverage)\n"
+                 "  --ticks N         ticks per run (default 600)\n"
+                 "  --threads N       highest thread count to time (default: all cores)\n"
+                 "  --no-collisions   balls pass through each other\n"
+                 "  --seed N          (default 1)\n";
+}
+
+int main(int argc, char** argv) {
+    sim::MultiBallConfig balls;
+    balls.balls = 50000;
+    int ticks = 600;
+    unsigned maxThreads = std::max(1u, std::thread::hardware_concurrency());
+    std::uint64_t seed = 1;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--balls") == 0 && i + 1 < argc) {
+            balls.balls = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--radius") == 0 && i + 1 < argc) {
+            balls.radius = std::strtof(argv[++i], nullptr);
+        } else if (std::strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) {
+            ticks = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            maxThreads = std::max(1, std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--no-collisions") == 0) {
+            balls.collisions = false;
+        } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            printUsage();
+            return std::strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+    }
+    if (balls.balls == 0 || ticks < 2) {
+        printUsage();
+        return 1;
+    }
+
+    sim::MatchConfig config;
+    sim::MultiBall probe(config, balls, seed);
+    std::printf("%zu balls, radius %.4f, %d ticks, collisions %s\n\n", probe.size(), probe.radius(), ticks,
+                balls.collisions ? "on" : "off");
+    std::printf("%-8s %10s %10s %8s %12s %10s  %s\n", "threads", "ms/tick", "of 16.7ms", "speedup", "tests/ball",
+                "contacts", "state");
+
+    const double budgetMs = 1000.0 / 60.0;
+    RunResult serial;
+    bool allMatch = true;
+    std::vector<unsigned> counts;
+    for (unsigned threads = 1; threads < maxThreads; threads *= 2) counts.push_back(threads);
+    counts.push_back(maxThreads);
+    for (unsigned threads : counts) {
+        std::unique_ptr<WorkStealingPool> pool;
+        if (threads > 1) pool.reset(new WorkStealingPool(threads));
+        RunResult r = run(balls, seed, ticks, pool.get());
+        if (threads == 1) serial = r;
+        bool same = r.checksum == serial.checksum;
+        allMatch = allMatch && same;
+        std::printf("%-8u %10.3f %9.1f%% %7.2fx %12.1f %10llu  %s\n", threads, r.msPerTick,
+                    100.0 * r.msPerTick / budgetMs, serial.msPerTick / r.msPerTick,
+                    static_cast<double>(r.stats.neighbourTests) / probe.size(),
+                    static_cast<unsigned long long>(r.stats.contacts), same ? "ok" : "MISMATCH");
+    }
+    std::printf("\nscore %d - %d, checksum %016llx\n", serial.scoreLeft, serial.scoreRight,
+                static_cast<unsigned long long>(serial.checksum));
+
+    if (!allMatch) {
+        std::cerr << "parallel runs diverged from the single-threaded run\n";
+        return 1;
+    }
+    return 0;
+}
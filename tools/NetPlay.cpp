@@ -0,0 +1,162 @@
+// cpong_netplay - plays a two-player rollback match between two NetSessions
+// in one process over loopback UDP, with injected latency, jitter and loss
+// on both directions. Time is virtual (one tick per loop), so the run is
+// fast and repeatable. Passes only if both peers end bit-identical to an
+// offline run of the same inputs.
+
+#include "InputLog.h"
+#include "NetSession.h"
+#include "Simulation.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+static void printUsage() {
+    std::cout << "Usage: cpong_netplay [--ticks N] [--latency MS] [--jitter MS] [--loss P] [--prediction N]\n"
+                 "                     [--seed N] [--port N]\n"
+                 "  --ticks       match length at 60 Hz (default 3600)\n"
+                 "  --latency     one-way delay added each direction (default 50)\n"
+                 "  --jitter      +- uniform delay variation, reorders packets (default 10)\n"
+                 "  --loss        packet drop probability each direction (default 0.05)\n"
+                 "  --prediction  max ticks a peer may run ahead of the other's input (default 12)\n"
+                 "  --seed        match and loss seed (default 1)\n"
+                 "  --port        host UDP port (default: any free port)\n";
+}
+
+// Scripted player: holds up, down or nothing for 8-39 tick stretches. A
+// function of the tick, so the offline reference sees the same inputs.
+static std::int8_t scriptedAxis(int side, std::uint32_t tick) {
+    std::uint32_t segment = 0, start = 0;
+    std::uint64_t h = 0x9E3779B97F4A7C15ULL * static_cast<std::uint64_t>(side + 1);
+    for (;;) {
+        h = (h ^ (h >> 31)) * 0xBF58476D1CE4E5B9ULL + segment;
+        std::uint32_t length = 8 + static_cast<std::uint32_t>((h >> 40) % 32);
+        if (tick < start + length) break;
+        start += length;
+        segment++;
+    }
+    static const std::int8_t axes[3] = {-127, 0, 127};
+    return axes[(h >> 20) % 3];
+}
+
+static void printPeer(const char* name, const sim::NetSession& peer) {
+    const sim::RollbackSession::Stats& s = peer.rollback()->stats();
+    const sim::NetSession::Stats& n = peer.stats();
+    std::printf("%-7s packets %llu sent, %llu dropped, %llu received; %llu rollbacks (avg %.1f, max %u ticks), "
+                "%llu stalls\n",
+                name, static_cast<unsigned long long>(n.packetsSent), static_cast<unsigned long long>(n.packetsDropped),
+                static_cast<unsigned long long>(n.packetsReceived), static_cast<unsigned long long>(s.rollbacks),
+                s.rollbacks ? static_cast<double>(s.ticksResimulated) / s.rollbacks : 0.0, s.maxDepth,
+                static_cast<unsigned long long>(s.stalls));
+}
+
+int main(int argc, char** argv) {
+    std::uint32_t ticks = 3600;
+    sim::NetSession::Conditions link;
+    link.latencyMs = 50.0;
+    link.jitterMs = 10.0;
+    link.loss = 0.05;
+    std::uint32_t prediction = 12;
+    std::uint64_t seed = 1;
+    std::uint16_t port = 0;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--ticks") == 0 && i + 1 < argc) {
+            ticks = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--latency") == 0 && i + 1 < argc) {
+            link.latencyMs = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--jitter") == 0 && i + 1 < argc) {
+            link.jitterMs = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--loss") == 0 && i + 1 < argc) {
+            link.loss = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--prediction") == 0 && i + 1 < argc) {
+            prediction = static_cast<std::uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--port") == 0 && i + 1 < argc) {
+            port = static_cast<std::uint16_t>(std::atoi(argv[++i]));
+        } else {
+            printUsage();
+            return std::strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+    }
+    if (ticks == 0 || prediction == 0 || link.loss < 0.0 || link.loss >= 1.0) {
+        printUsage();
+        return 1;
+    }
+
+    const float dt = 1.0f / 60.0f;
+    sim::MatchConfig config;
+    sim::NetSession host(config, dt, prediction);
+    sim::NetSession client(config, dt, prediction);
+    std::string error;
+    if (!host.host(port, seed, error) || !client.connect("127.0.0.1", host.localPort(), error)) {
+        std::cerr << error << "\n";
+        return 1;
+    }
+    sim::NetSession::Conditions clientLink = link;
+    clientLink.seed = seed + 1;
+    link.seed = seed;
+    host.setConditions(link);
+    client.setConditions(clientLink);
+
+    // Virtual clock: one tick per iteration, until both peers have every input
+    const std::int64_t tickNs = static_cast<std::int64_t>(1e9 / 60.0);
+    std::int64_t now = 1;
+    auto finished = [&](const sim::NetSession& peer) {
+        return peer.connected() && peer.rollback()->tick() == ticks && peer.rollback()->remoteNext() >= ticks;
+    };
+    std::uint64_t frames = 0;
+    for (; !(finished(host) && finished(client)); ++frames, now += tickNs) {
+        if (frames > 100ull * ticks + 10000) {
+            std::cerr << "match did not finish (stuck at host tick "
+                      << (host.connected() ? host.rollback()->tick() : 0) << ", client tick "
+                      << (client.connected() ? client.rollback()->tick() : 0) << ")\n";
+            return 1;
+        }
+        for (sim::NetSession* peer : {&host, &client}) {
+            peer->poll(now);
+            if (peer->connected() && peer->rollback()->tick() < ticks) {
+                int side = peer->rollback()->localSide();
+                peer->advance(scriptedAxis(side, peer->rollback()->tick()), now);
+            }
+        }
+    }
+    host.rollback()->reconcile();
+    client.rollback()->reconcile();
+
+    // Offline reference with the true inputs of both players
+    sim::MatchState reference;
+    sim::resetMatch(reference, seed, config);
+    for (std::uint32_t t = 0; t < ticks; ++t) {
+        sim::InputFrame frame;
+        frame.dt = dt;
+        frame.leftAxis = scriptedAxis(0, t);
+        frame.rightAxis = scriptedAxis(1, t);
+        sim::step(reference, config, sim::decodeInputs(frame), frame.dt);
+    }
+
+    std::printf("ticks:   %u (%.0f s of play, %llu frames incl. stalls)\n", ticks, ticks * dt,
+                static_cast<unsigned long long>(frames));
+    std::printf("link:    %.0f ms +- %.0f ms one way, %.1f%% loss each direction\n", link.latencyMs, link.jitterMs,
+                link.loss * 100.0);
+    printPeer("host:", host);
+    printPeer("client:", client);
+
+    const sim::RollbackSession::Stats& hs = host.rollback()->stats();
+    const sim::RollbackSession::Stats& cs = client.rollback()->stats();
+    std::uint64_t resimTicks = hs.ticksResimulated + cs.ticksResimulated;
+    double perTickUs = resimTicks ? (hs.resimNs + cs.resimNs) / 1000.0 / resimTicks : 0.0;
+    std::printf("resim:   %.2f us per tick (10 ticks: %.1f us); worst rollback %.1f us of a %.1f ms frame\n",
+                perTickUs, perTickUs * 10.0, std::max(hs.maxRollbackNs, cs.maxRollbackNs) / 1000.0, dt * 1000.0);
+
+    bool same = sim::sameState(host.rollback()->state(), reference) &&
+                sim::sameState(client.rollback()->state(), reference);
+    std::printf("score:   %d : %d\n", reference.scoreLeft, reference.scoreRight);
+    std::printf("final:   %s\n", same ? "bit-identical on both peers and offline" : "DESYNC");
+    return same ? 0 : 1;
+}
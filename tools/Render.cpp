@@ -0,0 +1,199 @@
+// cpong_render - renders a match without a window (EGL, e.g. Mesa llvmpipe)
+// and streams the frames as raw RGBA at uncapped speed.
+//
+//   cpong_render --replay match.cplog --out - |
+//       ffmpeg -f rawvideo -pix_fmt rgba -s 1280x720 -r 60 -i - match.mp4
+//
+// --checksums writes one 64-bit hash per frame; diffing it against a stored
+// copy is a golden-image regression test.
+
+#include "FrameCapture.h"
+#include "Game.h"
+#include "InputLog.h"
+#include "OffscreenContext.h"
+#include "ProgramCache.h"
+#include <glad/glad.h>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+static void printUsage() {
+    std::cout << "Usage: cpong_render [--replay FILE | --seed N --frames N] [--width W] [--height H]\n"
+                 "                    [--out FILE|-] [--checksums FILE] [--ring N] [--shader-cache DIR]\n"
+                 "  --replay     render an input log recorded with --record\n"
+                 "  --seed       AI-vs-AI match seed when not replaying (default 1)\n"
+                 "  --frames     frames to render when not replaying (default 600)\n"
+                 "  --width      frame width (default 1280)\n"
+                 "  --height     frame height (default 720)\n"
+                 "  --out        raw RGBA8 frames, top row first; - for stdout\n"
+                 "  --checksums  per-frame 64-bit pixel hashes, one per line\n"
+                 "  --ring       pixel buffer objects in flight (default 3)\n"
+                 "  --shader-cache  load and store linked programs as driver binaries in DIR\n";
+}
+
+// FNV-1a style, but over 64-bit words: a byte loop costs more than the render
+static std::uint64_t hashBytes(const unsigned char* data, std::size_t size, std::uint64_t hash) {
+    std::size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        std::uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        hash = (hash ^ word) * 0x100000001B3ULL;
+        hash ^= hash >> 29;
+    }
+    for (; i < size; ++i) hash = (hash ^ data[i]) * 0x100000001B3ULL;
+    return hash;
+}
+
+int main(int argc, char** argv) {
+    const char* replayPath = nullptr;
+    const char* outPath = nullptr;
+    const char* checksumPath = nullptr;
+    std::uint64_t seed = 1;
+    long long frameCount = 600;
+    int width = 1280;
+    int height = 720;
+    int ring = 3;
+    const char* shaderCacheDir = nullptr;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replayPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+            frameCount = std::atoll(argv[++i]);
+        } else if (std::strcmp(argv[i], "--width") == 0 && i + 1 < argc) {
+            width = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--height") == 0 && i + 1 < argc) {
+            height = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            outPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--checksums") == 0 && i + 1 < argc) {
+            checksumPath = argv[++i];
+        } else if (std::strcmp(argv[i], "--ring") == 0 && i + 1 < argc) {
+            ring = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--shader-cache") == 0 && i + 1 < argc) {
+            shaderCacheDir = argv[++i];
+        } else {
+            printUsage();
+            return std::strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+    }
+    if (width <= 0 || height <= 0 || ring <= 0 || frameCount < 0) {
+        printUsage();
+        return 1;
+    }
+
+    // Frames: the recorded ones, or a fixed-step AI-vs-AI match
+    sim::MatchConfig config;
+    std::vector<sim::InputFrame> frames;
+    sim::InputLog log;  // owns the policies `config` points to
+    if (replayPath) {
+        std::string error;
+        if (!sim::loadInputLog(replayPath, log, error)) {
+            std::cerr << "replay: " << error << "\n";
+            return 1;
+        }
+        seed = log.seed;
+        config = log.config;
+        frames = std::move(log.frames);
+    } else {
+        sim::MatchInputs inputs;
+        inputs.leftAI = true;
+        inputs.rightAI = true;
+        frames.assign(static_cast<std::size_t>(frameCount), sim::encodeFrame(inputs, 1.0f / 60.0f));
+    }
+
+    OffscreenContext context;
+    std::string error;
+    if (!context.create(error)) {
+        std::cerr << "Offscreen context: " << error << "\n";
+        return 1;
+    }
+    if (!gladLoadGLLoader((GLADloadproc)OffscreenContext::getProcAddress)) {
+        std::cerr << "Failed to initialize GLAD\n";
+        return 1;
+    }
+    std::unique_ptr<ProgramCache> programCache;
+    if (shaderCacheDir)
+        programCache.reset(new ProgramCache((GLADloadproc)OffscreenContext::getProcAddress, shaderCacheDir));
+
+    std::cerr << "Rendering " << frames.size() << " frames at " << width << "x" << height << " on "
+              << context.rendererName() << "\n";
+
+    FILE* out = nullptr;
+    if (outPath) {
+        out = std::strcmp(outPath, "-") == 0 ? stdout : std::fopen(outPath, "wb");
+        if (!out) {
+            std::cerr << "Cannot open " << outPath << "\n";
+            return 1;
+        }
+    }
+    std::ofstream checksums;
+    if (checksumPath) {
+        checksums.open(checksumPath);
+        if (!checksums) {
+            std::cerr << "Cannot open " << checksumPath << "\n";
+            return 1;
+        }
+    }
+
+    const std::size_t rowBytes = static_cast<std::size_t>(width) * 4;
+    bool writeFailed = false;
+    auto sink = [&](const unsigned char* rgba, std::uint64_t frame) {
+        // GL rows are bottom-up; emit top row first
+        std::uint64_t hash = 0xCBF29CE484222325ULL;
+        for (int y = height - 1; y >= 0; --y) {
+            const unsigned char* row = rgba + y * rowBytes;
+            if (checksumPath) hash = hashBytes(row, rowBytes, hash);
+            if (out && std::fwrite(row, 1, rowBytes, out) != rowBytes) writeFailed = true;
+        }
+        if (checksumPath) {
+            char line[32];
+            std::snprintf(line, sizeof(line), "%016llx", static_cast<unsigned long long>(hash));
+            checksums << frame << ' ' << line << '\n';
+        }
+    };
+
+    auto start = std::chrono::steady_clock::now();
+    {
+        FrameCapture capture(width, height, ring);
+        if (!capture.complete()) return 1;
+
+        Game game(width, height, seed, programCache.get());
+        game.startMatch(seed, config);
+        const Game::StartupTimes& times = game.startupTimes();
+        std::fprintf(stderr, "Shaders %.2f ms (%d/%d from cache%s), buffers %.2f ms\n", times.shadersMs,
+                     times.cachedPrograms, times.programs,
+                     !programCache ? "" : programCache->enabled() ? "" : ", no binary formats", times.buffersMs);
+
+        for (const sim::InputFrame& frame : frames) {
+            game.applyFrame(frame);
+            capture.bind();
+            game.render();
+            capture.capture(sink);
+            if (writeFailed) break;
+        }
+        capture.finish(sink);
+    }
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    if (out && out != stdout) std::fclose(out);
+    if (out == stdout) std::fflush(stdout);
+    if (writeFailed) {
+        std::cerr << "Write failed\n";
+        return 1;
+    }
+    double simSeconds = 0.0;
+    for (const sim::InputFrame& frame : frames) simSeconds += frame.dt;
+    std::cerr << frames.size() << " frames in " << seconds << " s (" << frames.size() / seconds << " fps, "
+              << simSeconds / seconds << "x realtime)\n";
+    return 0;
+}
@@ -0,0 +1,264 @@
+// cpong_spectator_load - opens thousands of TCP and UDP spectator
+// subscriptions to cpong_broadcast from one epoll loop and checks that
+// every snapshot they decode matches a local replay of the same seed.
+// Linux only.
+
+#include "SimThread.h"
+#include "Simulation.h"
+#include "Snapshot.h"
+#include <arpa/inet.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <string>
+#include <sys/epoll.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <vector>
+
+namespace {
+
+struct Subscriber {
+    int fd = -1;
+    bool udp = false;
+    std::uint8_t partial = 0;  // bytes of an unfinished TCP frame
+    unsigned char buffer[sim::MaxSnapshotFrame];
+    sim::SnapshotDecoder decoder;
+    std::uint64_t frames = 0;
+    std::int64_t firstNs = 0;
+    std::int64_t lastSubscribeNs = 0;
+};
+
+// Quantized states of the broadcast match, replayed locally by tick
+class Reference {
+public:
+    static const std::uint32_t Window = 4096;
+
+    explicit Reference(std::uint64_t seed) : m_states(Window) {
+        sim::resetMatch(m_state, seed, m_config);
+        m_inputs.leftAI = true;
+        m_inputs.rightAI = true;
+        m_states[0] = sim::quantizeState(m_state, 0);
+    }
+
+    // False if `q` is not what the match looked like at its tick
+    bool check(const sim::QuantizedState& q) {
+        while (m_tick < q.tick) {
+            sim::step(m_state, m_config, m_inputs, 1.0f / sim::SnapshotTickHz);
+            m_tick++;
+            m_states[m_tick % Window] = sim::quantizeState(m_state, m_tick);
+        }
+        if (m_tick - q.tick >= Window) return false;
+        const sim::QuantizedState& r = m_states[q.tick % Window];
+        return std::equal(r.fields, r.fields + sim::QuantizedState::FieldCount, q.fields);
+    }
+
+    std::uint32_t tick() const { return m_tick; }
+
+private:
+    sim::MatchConfig m_config;
+    sim::MatchInputs m_inputs;
+    sim::MatchState m_state;
+    std::uint32_t m_tick = 0;
+    std::vector<sim::QuantizedState> m_states;
+};
+
+void printUsage() {
+    std::cout << "Usage: cpong_spectator_load [--host H] [--port N] [--tcp N] [--udp N] [--seconds N] [--seed N]\n"
+                 "  --host     broadcast server (default 127.0.0.1)\n"
+                 "  --port     default 7780\n"
+                 "  --tcp      TCP subscribers (default 10000)\n"
+                 "  --udp      UDP subscribers (default 0)\n"
+                 "  --seconds  run time once all are opened (default 10)\n"
+                 "  --seed     the server's match seed, for verification (default 1)\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    std::string host = "127.0.0.1";
+    int port = 7780;
+    int tcpCount = 10000;
+    int udpCount = 0;
+    double seconds = 10.0;
+    std::uint64_t seed = 1;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--host") == 0 && i + 1 < argc) {
+            host = argv[++i];
+        } else if (std::strcmp(argv[i], "--port") == 0 && i + 1 < argc) {
+            port = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--tcp") == 0 && i + 1 < argc) {
+            tcpCount = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--udp") == 0 && i + 1 < argc) {
+            udpCount = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--seconds") == 0 && i + 1 < argc) {
+            seconds = std::atof(argv[++i]);
+        } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            seed = std::strtoull(argv[++i], nullptr, 10);
+        } else {
+            printUsage();
+            return std::strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+    }
+    if (tcpCount < 0 || udpCount < 0 || tcpCount + udpCount == 0) {
+        printUsage();
+        return 1;
+    }
+
+    rlimit files;
+    if (getrlimit(RLIMIT_NOFILE, &files) == 0) {
+        files.rlim_cur = files.rlim_max;
+        setrlimit(RLIMIT_NOFILE, &files);
+        if (files.rlim_cur < static_cast<rlim_t>(tcpCount + udpCount + 16)) {
+            std::cerr << "open file limit " << files.rlim_cur << " is too low for " << tcpCount + udpCount
+                      << " subscribers\n";
+            return 1;
+        }
+    }
+
+    addrinfo hints;
+    std::memset(&hints, 0, sizeof(hints));
+    hints.ai_family = AF_INET;
+    addrinfo* found = nullptr;
+    if (getaddrinfo(host.c_str(), nullptr, &hints, &found) != 0 || !found) {
+        std::cerr << "cannot resolve " << host << "\n";
+        return 1;
+    }
+    sockaddr_in server = *reinterpret_cast<sockaddr_in*>(found->ai_addr);
+    server.sin_port = htons(static_cast<std::uint16_t>(port));
+    freeaddrinfo(found);
+
+    int epoll = epoll_create1(0);
+    std::vector<Subscriber> subscribers(static_cast<std::size_t>(tcpCount + udpCount));
+    for (int i = 0; i < udpCount; ++i) subscribers[static_cast<std::size_t>(tcpCount + i)].udp = true;
+
+    Reference reference(seed);
+    std::uint64_t mismatches = 0, decodeErrors = 0, failedOpens = 0, closed = 0, bytes = 0, keyframes = 0;
+    std::size_t opened = 0;
+    std::int64_t runStart = 0, runEnd = INT64_MAX;
+    std::vector<epoll_event> events(1024);
+
+    for (std::int64_t now = sim::steadyNowNs(); now < runEnd; now = sim::steadyNowNs()) {
+        // Open subscriptions a batch at a time so the server's accept
+        // queue keeps up
+        for (int batch = 0; batch < 200 && opened < subscribers.size(); ++batch, ++opened) {
+            Subscriber& s = subscribers[opened];
+            s.fd = socket(AF_INET, (s.udp ? SOCK_DGRAM : SOCK_STREAM) | SOCK_NONBLOCK, 0);
+            if (s.fd < 0 || (connect(s.fd, reinterpret_cast<sockaddr*>(&server), sizeof(server)) != 0 &&
+                             errno != EINPROGRESS)) {
+                failedOpens++;
+                if (s.fd >= 0) close(s.fd);
+                s.fd = -1;
+                continue;
+            }
+            epoll_event ev;
+            ev.events = EPOLLIN | (s.udp ? 0u : static_cast<unsigned>(EPOLLRDHUP));
+            ev.data.u64 = opened;
+            epoll_ctl(epoll, EPOLL_CTL_ADD, s.fd, &ev);
+            if (s.udp) {
+                // Subscribe now; spread the renewals evenly over each second
+                send(s.fd, "CPSP", 4, 0);
+                s.lastSubscribeNs = now - 1000000000LL + (opened - tcpCount) * 1000000000LL / udpCount;
+            }
+        }
+        if (opened == subscribers.size() && runStart == 0) {
+            runStart = now;
+            runEnd = now + static_cast<std::int64_t>(seconds * 1e9);
+        }
+
+        // UDP leases last 5 s; renew each once a second
+        for (std::size_t i = static_cast<std::size_t>(tcpCount); i < opened; ++i) {
+            Subscriber& s = subscribers[i];
+            if (s.fd >= 0 && now - s.lastSubscribeNs >= 1000000000LL) {
+                send(s.fd, "CPSP", 4, 0);
+                s.lastSubscribeNs = now;
+            }
+        }
+
+        int n = epoll_wait(epoll, events.data(), static_cast<int>(events.size()), 10);
+        for (int e = 0; e < n; ++e) {
+            Subscriber& s = subscribers[events[e].data.u64];
+            if (s.fd < 0) continue;
+            // One read per event: epoll is level-triggered and reports leftovers again
+            unsigned char data[2048];
+            ssize_t got = recv(s.fd, data, sizeof(data), 0);
+            if (got == 0 || (got < 0 && errno != EAGAIN && errno != EWOULDBLOCK && errno != ECONNREFUSED)) {
+                close(s.fd);
+                s.fd = -1;
+                closed++;
+                continue;
+            }
+            if (got < 0) continue;
+            bytes += static_cast<std::uint64_t>(got);
+
+            // TCP: carry a split frame over to the next read
+            std::vector<unsigned char> joined;
+            const unsigned char* p = data;
+            std::size_t size = static_cast<std::size_t>(got);
+            if (s.partial) {
+                joined.assign(s.buffer, s.buffer + s.partial);
+                joined.insert(joined.end(), data, data + got);
+                p = joined.data();
+                size = joined.size();
+                s.partial = 0;
+            }
+            while (size > 0) {
+                int used = s.decoder.decode(p, size);
+                if (used == sim::SnapshotDecoder::Error) {
+                    decodeErrors++;
+                    break;
+                }
+                if (used == sim::SnapshotDecoder::Incomplete) {
+                    if (!s.udp && size <= sizeof(s.buffer)) {
+                        std::memcpy(s.buffer, p, size);
+                        s.partial = static_cast<std::uint8_t>(size);
+                    }
+                    break;
+                }
+                p += used;
+                size -= static_cast<std::size_t>(used);
+                if (!s.decoder.updated()) continue;
+                if (s.frames++ == 0) s.firstNs = now;
+                if (s.decoder.wasKeyframe()) keyframes++;
+                if (!reference.check(s.decoder.latest())) mismatches++;
+            }
+        }
+    }
+
+    // Per-subscriber delivery over the measured run
+    std::uint64_t frames = 0, silent = 0, stale = 0;
+    double minRate = 1e9;
+    const std::uint32_t newest = reference.tick();
+    for (const Subscriber& s : subscribers) {
+        frames += s.frames;
+        if (s.frames == 0) {
+            silent++;
+            continue;
+        }
+        double span = (runEnd - s.firstNs) * 1e-9;
+        if (span > 1.0) minRate = std::min(minRate, s.frames / span);
+        if (newest - s.decoder.latest().tick > sim::SnapshotTickHz / 2) stale++;
+    }
+    const double elapsed = (runEnd - runStart) * 1e-9;
+    std::printf("subscribers: %d tcp + %d udp, %llu failed to open, %llu closed by the server\n", tcpCount, udpCount,
+                static_cast<unsigned long long>(failedOpens), static_cast<unsigned long long>(closed));
+    std::printf("received:    %llu frames (%llu keyframes), %.2f MB, %.0f frames/s total\n",
+                static_cast<unsigned long long>(frames), static_cast<unsigned long long>(keyframes),
+                bytes / (1024.0 * 1024.0), frames / std::max(elapsed, 1e-9));
+    std::printf("per client:  min %.1f frames/s; %llu got nothing, %llu ended > 0.5 s behind\n",
+                minRate == 1e9 ? 0.0 : minRate, static_cast<unsigned long long>(silent),
+                static_cast<unsigned long long>(stale));
+    std::printf("verified:    %llu mismatches against a local replay of seed %llu, %llu decode errors\n",
+                static_cast<unsigned long long>(mismatches), static_cast<unsigned long long>(seed),
+                static_cast<unsigned long long>(decodeErrors));
+    close(epoll);
+    return mismatches == 0 && decodeErrors == 0 && silent == 0 ? 0 : 1;
+}
@@ -0,0 +1,241 @@
+// cpong_sweep - plays AI-vs-AI matches over a grid of gameplay constants on
+// every core and prints per-point statistics as CSV.
+//
+// Physics constants (speedBoost, maxSpeed, paddleHeight) apply to both sides.
+// AI constants (aiSpeed, mistakeRange, mistakeInterval) apply to the right
+// paddle only; the left keeps the defaults, so win rate is the right AI's
+// share against the baseline. Results depend only on --seed, never on the
+// thread count or scheduling.
+
+#include "Simulation.h"
+#include "WorkStealingPool.h"
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Axis {
+    const char* flag;
+    std::vector<float> values;
+};
+
+// Integer totals only, so merging per-worker partials is order-independent
+struct PointStats {
+    std::uint64_t matches = 0;
+    std::uint64_t ticks = 0;
+    std::uint64_t pointsLeft = 0;
+    std::uint64_t pointsRight = 0;
+    std::uint64_t rallyHits = 0;   // paddle hits in rallies that ended in a point
+    std::uint64_t matchesWonRight = 0;
+
+    void add(const PointStats& o) {
+        matches += o.matches;
+        ticks += o.ticks;
+        pointsLeft += o.pointsLeft;
+        pointsRight += o.pointsRight;
+        rallyHits += o.rallyHits;
+        matchesWonRight += o.matchesWonRight;
+    }
+};
+
+struct alignas(64) WorkerStats {
+    std::vector<PointStats> points;
+};
+
+std::uint64_t splitmix64(std::uint64_t x) {
+    x += 0x9E3779B97F4A7C15ULL;
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+std::vector<float> parseList(const char* text) {
+    std::vector<float> values;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ','))
+        if (!item.empty()) values.push_back(std::strtof(item.c_str(), nullptr));
+    return values;
+}
+
+void playMatch(const sim::MatchConfig& config, std::uint64_t seed, int targetPoints, std::uint64_t maxTicks,
+               float dt, PointStats& out) {
+    sim::MatchInputs inputs;
+    inputs.leftAI = true;
+    inputs.rightAI = true;
+
+    sim::MatchState state;
+    sim::resetMatch(state, seed, config);
+    std::uint64_t hits = 0;
+    std::uint64_t t = 0;
+    while (t < maxTicks && state.scoreLeft < targetPoints && state.scoreRight < targetPoints) {
+        unsigned events = sim::step(state, config, inputs, dt);
+        ++t;
+        if (events & sim::LeftPaddleHit) ++hits;
+        if (events & sim::RightPaddleHit) ++hits;
+        if (events & (sim::LeftScored | sim::RightScored)) {
+            out.rallyHits += hits;
+            hits = 0;
+        }
+    }
+
+    out.matches++;
+    out.ticks += t;
+    out.pointsLeft += static_cast<std::uint64_t>(state.scoreLeft);
+    out.pointsRight += static_cast<std::uint64_t>(state.scoreRight);
+    if (state.scoreRight > state.scoreLeft) out.matchesWonRight++;
+}
+
+void printUsage() {
+    std::cout << "Usage: cpong_sweep [options]\n"
+                 "  --speedBoost LIST       e.g. 1.04,1.08,1.12 (default 1.08)\n"
+                 "  --maxSpeed LIST         (default 28)\n"
+                 "  --paddleHeight LIST     (default 2.5)\n"
+                 "  --aiSpeed LIST          right AI only (default 11)\n"
+                 "  --mistakeRange LIST     right AI only (default 2.5)\n"
+                 "  --mistakeInterval LIST  right AI only (default 0.35)\n"
+                 "  --matches N             matches per grid point (default 1000)\n"
+                 "  --points N              points to win a match (default 11)\n"
+                 "  --max-minutes M         sim-time cap per match (default 30)\n"
+                 "  --seed N                master seed (default 1)\n"
+                 "  --threads N             worker threads (default: all cores)\n"
+                 "  --grain N               matches per scheduled chunk (default 16)\n"
+                 "  --out FILE              write CSV to FILE instead of stdout\n";
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+    sim::MatchConfig base;
+    std::vector<Axis> axes = {
+        {"--speedBoost", {base.speedBoost}},
+        {"--maxSpeed", {base.maxSpeed}},
+        {"--paddleHeight", {base.paddleHeight}},
+        {"--aiSpeed", {base.aiRight.speed}},
+        {"--mistakeRange", {base.aiRight.mistakeRange}},
+        {"--mistakeInterval", {base.aiRight.mistakeChangeInterval}},
+    };
+    std::uint64_t matchesPerPoint = 1000;
+    int targetPoints = 11;
+    float maxMinutes = 30.0f;
+    std::uint64_t masterSeed = 1;
+    unsigned threads = 0;
+    std::size_t grain = 16;
+    const char* outPath = nullptr;
+    const float dt = 1.0f / 60.0f;
+
+    for (int i = 1; i < argc; ++i) {
+        bool matched = false;
+        for (Axis& axis : axes) {
+            if (std::strcmp(argv[i], axis.flag) == 0 && i + 1 < argc) {
+                axis.values = parseList(argv[++i]);
+                matched = !axis.values.empty();
+                break;
+            }
+        }
+        if (matched) continue;
+
+        if (std::strcmp(argv[i], "--matches") == 0 && i + 1 < argc) {
+            matchesPerPoint = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--points") == 0 && i + 1 < argc) {
+            targetPoints = std::atoi(argv[++i]);
+        } else if (std::strcmp(argv[i], "--max-minutes") == 0 && i + 1 < argc) {
+            maxMinutes = std::strtof(argv[++i], nullptr);
+        } else if (std::strcmp(argv[i], "--seed") == 0 && i + 1 < argc) {
+            masterSeed = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            threads = static_cast<unsigned>(std::atoi(argv[++i]));
+        } else if (std::strcmp(argv[i], "--grain") == 0 && i + 1 < argc) {
+            grain = std::strtoull(argv[++i], nullptr, 10);
+        } else if (std::strcmp(argv[i], "--out") == 0 && i + 1 < argc) {
+            outPath = argv[++i];
+        } else {
+            printUsage();
+            return std::strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+    }
+    if (matchesPerPoint == 0 || targetPoints <= 0 || maxMinutes <= 0.0f) {
+        printUsage();
+        return 1;
+    }
+
+    // Cartesian product of all axes
+    std::vector<sim::MatchConfig> grid(1, base);
+    for (std::size_t a = 0; a < axes.size(); ++a) {
+        std::vector<sim::MatchConfig> next;
+        for (const sim::MatchConfig& c : grid) {
+            for (float v : axes[a].values) {
+                sim::MatchConfig p = c;
+                switch (a) {
+                case 0: p.speedBoost = v; break;
+                case 1: p.maxSpeed = v; break;
+                case 2: p.paddleHeight = v; break;
+                case 3: p.aiRight.speed = v; break;
+                case 4: p.aiRight.mistakeRange = v; break;
+                case 5: p.aiRight.mistakeChangeInterval = v; break;
+                }
+                next.push_back(p);
+            }
+        }
+        grid.swap(next);
+    }
+
+    const std::uint64_t maxTicks = static_cast<std::uint64_t>(maxMinutes * 60.0f / dt);
+    const std::size_t totalMatches = grid.size() * matchesPerPoint;
+
+    WorkStealingPool pool(threads);
+    std::vector<WorkerStats> perWorker(pool.threadCount());
+    for (WorkerStats& w : perWorker) w.points.resize(grid.size());
+
+    auto start = std::chrono::steady_clock::now();
+    pool.parallelFor(totalMatches, grain, [&](std::size_t begin, std::size_t end, unsigned worker) {
+        for (std::size_t j = begin; j < end; ++j) {
+            std::size_t point = j / matchesPerPoint;
+            std::uint64_t seed = splitmix64(masterSeed ^ splitmix64(j));
+            playMatch(grid[point], seed, targetPoints, maxTicks, dt, perWorker[worker].points[point]);
+        }
+    });
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::ofstream file;
+    if (outPath) {
+        file.open(outPath);
+        if (!file) {
+            std::cerr << "Cannot open " << outPath << "\n";
+            return 1;
+        }
+    }
+    std::ostream& out = outPath ? static_cast<std::ostream&>(file) : std::cout;
+
+    out << "speedBoost,maxSpeed,paddleHeight,aiSpeed,mistakeRange,mistakeInterval,"
+           "matches,points,rally_length,points_per_minute,point_win_rate,match_win_rate\n";
+    std::uint64_t totalTicks = 0;
+    for (std::size_t p = 0; p < grid.size(); ++p) {
+        PointStats s;
+        for (const WorkerStats& w : perWorker) s.add(w.points[p]);
+        totalTicks += s.ticks;
+
+        const sim::MatchConfig& c = grid[p];
+        double points = static_cast<double>(s.pointsLeft + s.pointsRight);
+        double minutes = s.ticks * static_cast<double>(dt) / 60.0;
+        out << c.speedBoost << ',' << c.maxSpeed << ',' << c.paddleHeight << ','
+            << c.aiRight.speed << ',' << c.aiRight.mistakeRange << ',' << c.aiRight.mistakeChangeInterval << ','
+            << s.matches << ',' << (s.pointsLeft + s.pointsRight) << ','
+            << (points > 0 ? s.rallyHits / points : 0.0) << ','
+            << (minutes > 0 ? points / minutes : 0.0) << ','
+            << (points > 0 ? s.pointsRight / points : 0.0) << ','
+            << static_cast<double>(s.matchesWonRight) / s.matches << '\n';
+    }
+
+    std::cerr << grid.size() << " grid points, " << totalMatches << " matches on " << pool.threadCount()
+              << " threads in " << seconds << " s (" << totalMatches / seconds << " matches/s, "
+              << totalTicks / seconds << " ticks/s, " << pool.steals() << " steals)\n";
+    return 0;
+}
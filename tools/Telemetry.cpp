@@ -0,0 +1,287 @@
+// cpong_telemetry - queries a telemetry file written by CPong --telemetry or
+// cpong_headless --telemetry.
+//
+// Filters are `column OP value` with OP one of < <= > >= == != or & (any of
+// the value's bits set, integer columns only); all must hold. Blocks whose
+// min/max rule a filter out are skipped without touching their columns, and
+// the rest are scanned one column at a time in the column's own type.
+
+#include "Telemetry.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+static void printUsage() {
+    std::cout << "Usage: cpong_telemetry FILE [--where EXPR]... [--columns A,B,...] [--count] [--limit N]\n"
+                 "  --where    keep rows where EXPR holds, e.g. 'ballX>5' or 'events&3'\n"
+                 "  --columns  columns to print (default all)\n"
+                 "  --count    print the number of matching rows only\n"
+                 "  --limit    print at most N rows\n"
+                 "With no options, prints the columns and their overall ranges.\n";
+}
+
+enum class Op { Less, LessEqual, Greater, GreaterEqual, Equal, NotEqual, AnyBits };
+
+struct Filter {
+    std::uint32_t column;
+    Op op;
+    double value;
+    std::uint64_t bits;  // Op::AnyBits
+};
+
+static bool parseFilter(const sim::TelemetryReader& reader, const char* text, Filter& filter, std::string& error) {
+    const char* p = text;
+    while (std::isalnum(static_cast<unsigned char>(*p)) || *p == '_') ++p;
+    int column = reader.findColumn(std::string(text, p));
+    if (column < 0) {
+        error = "unknown column in '" + std::string(text) + "'";
+        return false;
+    }
+    filter.column = static_cast<std::uint32_t>(column);
+
+    static const struct {
+        const char* text;
+        Op op;
+    } ops[] = {{"<=", Op::LessEqual}, {">=", Op::GreaterEqual}, {"==", Op::Equal}, {"!=", Op::NotEqual},
+               {"<", Op::Less},       {">", Op::Greater},       {"&", Op::AnyBits}};
+    bool found = false;
+    for (const auto& op : ops) {
+        std::size_t length = std::strlen(op.text);
+        if (std::strncmp(p, op.text, length) == 0) {
+            filter.op = op.op;
+            p += length;
+            found = true;
+            break;
+        }
+    }
+    if (!found) {
+        error = "expected < <= > >= == != or & in '" + std::string(text) + "'";
+        return false;
+    }
+
+    char* end = nullptr;
+    if (filter.op == Op::AnyBits) {
+        if (reader.column(filter.column).type == sim::TelemetryType::F32) {
+            error = "& needs an integer column in '" + std::string(text) + "'";
+            return false;
+        }
+        filter.bits = std::strtoull(p, &end, 0);
+        filter.value = 0.0;
+    } else {
+        filter.value = std::strtod(p, &end);
+        filter.bits = 0;
+    }
+    if (end == p || *end != '\0') {
+        error = "expected a number in '" + std::string(text) + "'";
+        return false;
+    }
+    return true;
+}
+
+// False if no value in [range.min, range.max] can pass
+static bool mayMatch(const Filter& f, const sim::TelemetryRange& range) {
+    switch (f.op) {
+    case Op::Less: return range.min < f.value;
+    case Op::LessEqual: return range.min <= f.value;
+    case Op::Greater: return range.max > f.value;
+    case Op::GreaterEqual: return range.max >= f.value;
+    case Op::Equal: return range.min <= f.value && f.value <= range.max;
+    case Op::NotEqual: return !(range.min == f.value && range.max == f.value);
+    case Op::AnyBits: return range.max != 0.0 || range.min != 0.0;
+    }
+    return true;
+}
+
+// Keeps the rows of `selected` whose value passes. One loop per op and
+// column type, with the comparison in double (exact for every stored type
+// but u64 ticks past 2^53).
+template <typename T>
+static void filterColumn(const T* values, const Filter& f, std::vector<std::uint32_t>& selected) {
+    std::size_t kept = 0;
+    auto keep = [&](auto pass) {
+        for (std::uint32_t row : selected) {
+            selected[kept] = row;
+            kept += pass(values[row]) ? 1 : 0;
+        }
+    };
+    const double v = f.value;
+    switch (f.op) {
+    case Op::Less: keep([v](T x) { return x < v; }); break;
+    case Op::LessEqual: keep([v](T x) { return x <= v; }); break;
+    case Op::Greater: keep([v](T x) { return x > v; }); break;
+    case Op::GreaterEqual: keep([v](T x) { return x >= v; }); break;
+    case Op::Equal: keep([v](T x) { return x == v; }); break;
+    case Op::NotEqual: keep([v](T x) { return x != v; }); break;
+    case Op::AnyBits:
+        // Refused for float columns when parsing
+        if constexpr (std::is_integral<T>::value) {
+            const std::uint64_t bits = f.bits;
+            keep([bits](T x) { return (static_cast<std::uint64_t>(x) & bits) != 0; });
+        }
+        break;
+    }
+    selected.resize(kept);
+}
+
+static void applyFilter(const sim::TelemetryReader& reader, std::uint64_t block, const Filter& f,
+                        std::vector<std::uint32_t>& selected) {
+    const void* data = reader.columnData(block, f.column);
+    switch (reader.column(f.column).type) {
+    case sim::TelemetryType::F32: filterColumn(static_cast<const float*>(data), f, selected); break;
+    case sim::TelemetryType::I32: filterColumn(static_cast<const std::int32_t*>(data), f, selected); break;
+    case sim::TelemetryType::U32: filterColumn(static_cast<const std::uint32_t*>(data), f, selected); break;
+    case sim::TelemetryType::U64: filterColumn(static_cast<const std::uint64_t*>(data), f, selected); break;
+    }
+}
+
+static std::string columnName(const sim::TelemetryColumn& column) {
+    return std::string(column.name, strnlen(column.name, sizeof(column.name)));
+}
+
+static void printValue(const sim::TelemetryReader& reader, std::uint64_t block, std::uint32_t column,
+                       std::uint32_t row) {
+    double value = reader.value(block, column, row);
+    if (reader.column(column).type == sim::TelemetryType::F32)
+        std::printf("%.6g", value);
+    else
+        std::printf("%.0f", value);
+}
+
+static int printSummary(const char* path, const sim::TelemetryReader& reader) {
+    std::printf("file:     %s\nrows:     %llu in %llu blocks\n\n%-14s %-4s %14s %14s\n", path,
+                static_cast<unsigned long long>(reader.rowCount()),
+                static_cast<unsigned long long>(reader.blockCount()), "column", "type", "min", "max");
+    static const char* typeNames[] = {"f32", "i32", "u32", "u64"};
+    for (std::uint32_t c = 0; c < reader.columnCount(); ++c) {
+        double lo = 0.0, hi = 0.0;
+        bool any = false;
+        for (std::uint64_t b = 0; b < reader.blockCount(); ++b) {
+            sim::TelemetryReader::Block block = reader.block(b);
+            if (block.rows == 0) continue;
+            lo = any ? std::min(lo, block.ranges[c].min) : block.ranges[c].min;
+            hi = any ? std::max(hi, block.ranges[c].max) : block.ranges[c].max;
+            any = true;
+        }
+        const sim::TelemetryColumn& column = reader.column(c);
+        std::printf("%-14s %-4s %14.6g %14.6g\n", columnName(column).c_str(),
+                    typeNames[static_cast<std::uint32_t>(column.type)], lo, hi);
+    }
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    const char* path = nullptr;
+    std::vector<const char*> where;
+    const char* columnList = nullptr;
+    bool countOnly = false;
+    long long limit = -1;
+
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--where") == 0 && i + 1 < argc) {
+            where.push_back(argv[++i]);
+        } else if (std::strcmp(argv[i], "--columns") == 0 && i + 1 < argc) {
+            columnList = argv[++i];
+        } else if (std::strcmp(argv[i], "--count") == 0) {
+            countOnly = true;
+        } else if (std::strcmp(argv[i], "--limit") == 0 && i + 1 < argc) {
+            limit = std::atoll(argv[++i]);
+        } else if (argv[i][0] != '-' && !path) {
+            path = argv[i];
+        } else {
+            printUsage();
+            return std::strcmp(argv[i], "--help") == 0 ? 0 : 1;
+        }
+    }
+    if (!path) {
+        printUsage();
+        return 1;
+    }
+
+    sim::TelemetryReader reader;
+    std::string error;
+    if (!reader.open(path, error)) {
+        std::cerr << error << "\n";
+        return 1;
+    }
+    if (where.empty() && !columnList && !countOnly && limit < 0) return printSummary(path, reader);
+
+    std::vector<Filter> filters(where.size());
+    for (std::size_t i = 0; i < where.size(); ++i) {
+        if (!parseFilter(reader, where[i], filters[i], error)) {
+            std::cerr << error << "\n";
+            return 1;
+        }
+    }
+
+    std::vector<std::uint32_t> columns;
+    if (columnList) {
+        const char* p = columnList;
+        while (*p) {
+            const char* end = std::strchr(p, ',');
+            std::string name = end ? std::string(p, end) : std::string(p);
+            int column = reader.findColumn(name);
+            if (column < 0) {
+                std::cerr << "unknown column '" << name << "'\n";
+                return 1;
+            }
+            columns.push_back(static_cast<std::uint32_t>(column));
+            p = end ? end + 1 : p + name.size();
+        }
+    } else {
+        for (std::uint32_t c = 0; c < reader.columnCount(); ++c) columns.push_back(c);
+    }
+
+    if (!countOnly) {
+        for (std::size_t i = 0; i < columns.size(); ++i)
+            std::printf("%s%s", i ? "," : "", columnName(reader.column(columns[i])).c_str());
+        std::printf("\n");
+    }
+
+    std::uint64_t matched = 0, scanned = 0, skipped = 0;
+    std::vector<std::uint32_t> selected;
+    for (std::uint64_t b = 0; b < reader.blockCount(); ++b) {
+        if (limit >= 0 && !countOnly && matched >= static_cast<std::uint64_t>(limit)) break;
+        sim::TelemetryReader::Block block = reader.block(b);
+        bool possible = block.rows > 0;
+        for (const Filter& f : filters) possible = possible && mayMatch(f, block.ranges[f.column]);
+        if (!possible) {
+            skipped++;
+            continue;
+        }
+        scanned++;
+
+        selected.resize(block.rows);
+        for (std::uint32_t r = 0; r < block.rows; ++r) selected[r] = r;
+        for (const Filter& f : filters) {
+            if (selected.empty()) break;
+            applyFilter(reader, b, f, selected);
+        }
+
+        if (countOnly) {
+            matched += selected.size();
+            continue;
+        }
+        for (std::uint32_t row : selected) {
+            if (limit >= 0 && matched >= static_cast<std::uint64_t>(limit)) break;
+            for (std::size_t i = 0; i < columns.size(); ++i) {
+                if (i) std::printf(",");
+                printValue(reader, b, columns[i], row);
+            }
+            std::printf("\n");
+            matched++;
+        }
+    }
+
+    if (countOnly) std::printf("%llu\n", static_cast<unsigned long long>(matched));
+    std::fflush(stdout);
+    std::cerr << matched << " rows; " << scanned << " blocks scanned, " << skipped << " skipped by min/max of "
+              << reader.blockCount() << "\n";
+    return 0;
+}